@@ -5,33 +5,36 @@
 #include <QMap>
 #include <QVector>
 #include <QColor>
-#include <tuple>
-#include <functional>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QElapsedTimer>
 #include "mousezoom.h"
 #include "chartsetting1.h"
+#include "modelsolver01-06.h"
+#include "typecurvelibrary.h"
+#include "progressivecurverunner.h"
 
 namespace Ui {
 class ModelWidget01_06;
 }
 
 class QCPTextElement;
-
-// 类型定义: <时间, 压力, 导数>
-using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
+class QCPGraph;
+class TypeCurveAtlasDialog;
 
 class ModelWidget01_06 : public QWidget
 {
     Q_OBJECT
 
 public:
-    enum ModelType {
-        Model_1 = 0, // 无限大 + 变井储
-        Model_2,     // 无限大 + 恒定井储
-        Model_3,     // 封闭边界 + 变井储
-        Model_4,     // 封闭边界 + 恒定井储
-        Model_5,     // 定压边界 + 变井储
-        Model_6      // 定压边界 + 恒定井储
-    };
+    // 使用 ModelSolver01_06 中定义的枚举
+    using ModelType = ModelSolver01_06::ModelType;
+    static const ModelType Model_1 = ModelSolver01_06::Model_1;
+    static const ModelType Model_2 = ModelSolver01_06::Model_2;
+    static const ModelType Model_3 = ModelSolver01_06::Model_3;
+    static const ModelType Model_4 = ModelSolver01_06::Model_4;
+    static const ModelType Model_5 = ModelSolver01_06::Model_5;
+    static const ModelType Model_6 = ModelSolver01_06::Model_6;
 
     explicit ModelWidget01_06(ModelType type, QWidget *parent = nullptr);
     ~ModelWidget01_06();
@@ -45,12 +48,16 @@ public:
     // 获取当前模型名称
     QString getModelName() const;
 
+    // 获取计算内核 (只读，可复制到工作线程使用)
+    const ModelSolver01_06& solver() const { return m_solver; }
+
 signals:
     // 计算完成信号
     void calculationCompleted(const QString& modelType, const QMap<QString, double>& params);
 
 public slots:
     void onCalculateClicked();
+    void onStopClicked();
     void onResetParameters();
     void onExportData();
     void onExportImage();
@@ -59,44 +66,100 @@ public slots:
     void onChartSettings();
     void onDependentParamsChanged();
     void onShowPointsToggled(bool checked);
+    void onOpenAtlas();
+
+private slots:
+    // 曲线计算: 单个时间分块完成 / 全部完成
+    void onSweepResultReady(int index);
+    void onSweepFinished();
+    // 类型曲线图版叠加
+    void onAtlasOverlay(const QVector<ModelCurveData>& curves, const QStringList& names);
+    void onClearAtlasOverlay();
+    // 图版实时预览: 加载/停用图版，参数变化时刷新插值曲线
+    void onPreviewLibraryRequested(const QString& path);
+    void updatePreview();
+    // 实时计算: 参数变化后先粗算再精算，新的修改会取代未完成的计算
+    void onLiveCalcToggled(bool checked);
+    void onLiveParamsChanged();
+    void onLiveStageReady(int stage, bool isFinal, const ModelCurveData& curve, qint64 elapsedMs, double floatErrorBound);
 
 private:
     void initUi();
     void initChart();
     void setupConnections();
     void runCalculation();
+    // 读取界面参数: 原始输入 (敏感性参数可为多值) / 当前单值参数 (取每项第一个值，含 N 与 LfD)
+    QMap<QString, QVector<double>> collectRawParameters();
+    QMap<QString, double> currentParameters();
+    // 计算用的对数时间序列 (1e-3 h ~ t)
+    QVector<double> calculationTimeSteps(const QMap<QString, double>& baseParams) const;
+    // 更新预览状态标签 (误差超出容差时以红色提示)
+    void showPreviewStatus(bool available, double errorEstimate, const QString& reason);
+    // 移除计算曲线 (保留图版叠加与预览曲线)
+    void removeCalculatedGraphs();
 
     // 辅助函数
     QVector<double> parseInput(const QString& text);
     void setInputText(QLineEdit* edit, double value);
     void plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity);
-
-    // 数学计算核心 (Stehfest 反演循环)
-    void calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                             std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                             QVector<double>& outPD, QVector<double>& outDeriv);
-
-    // 拉普拉斯空间解 (复合模型通用入口)
-    double flaplace_composite(double z, const QMap<QString, double>& p);
-
-    // PWD 核心计算 (包含边界条件处理 Logic from MATLAB PWD_inf)
-    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type);
-
-    // 数学工具函数 (对应 MATLAB 内置函数或逻辑)
-    double scaled_besseli(int v, double x); // 缩放 Bessel I
-    double gauss15(std::function<double(double)> f, double a, double b);
-    double adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth);
-    double stefestCoefficient(int i, int N);
-    double factorial(int n);
+    // 生成 n 条曲线的颜色 (不超过预设色表时使用预设色，否则按色相均匀分布)
+    QList<QColor> generateColorRamp(int n) const;
+    // 更新结果文本框 (显示最后一条完成的曲线)
+    void updateResultText(const QString& header);
+    void setCalculatingState(bool running);
+
+    // 计算任务分块: 一条曲线上的一段连续时间点 (各时间点的 Stehfest 反演相互独立)
+    struct CalcChunk {
+        int curve;
+        int begin;
+        QVector<double> t;
+        QMap<QString, double> params;
+    };
+    struct CalcChunkResult {
+        int curve;
+        int begin;
+        QVector<double> p;  // 有因次压力
+        EngineStats stats;  // 勾选"引擎统计"时填写
+    };
+    // 单条曲线的逐点结果缓冲
+    struct CurveBuffer {
+        QVector<double> t;
+        QVector<double> p;
+        QVector<bool> done;
+        int doneCount;
+        bool previewShown;  // 已显示图版插值曲线时不逐段刷新，整条完成后再替换
+    };
 
 private:
     Ui::ModelWidget01_06 *ui;
     MouseZoom* m_plot;
     QCPTextElement* m_plotTitle;
     ModelType m_type;
-    bool m_highPrecision;
+    ModelSolver01_06 m_solver;
     QList<QColor> m_colorList;
 
+    // 曲线计算 (按时间分块提交到引擎线程池，已完成的时间点随到随画)
+    QFutureWatcher<CalcChunkResult> m_sweepWatcher;
+    QVector<CurveBuffer> m_sweepCurves;
+    QString m_sweepKey;                 // 敏感性参数名 (为空表示单条曲线)
+    QVector<double> m_sweepValues;      // 敏感性参数取值
+    QMap<QString, double> m_sweepBaseParams;
+    int m_sweepDoneCount;               // 已完整算完的曲线数
+    bool m_sweepCollectStats;           // 本次计算是否记录引擎统计
+    EngineStats m_sweepStats;           // 各分块统计之和
+    QElapsedTimer m_sweepTimer;         // 本次计算的墙钟时间
+
+    // 类型曲线图版 (非模态对话框) 与叠加到图表上的曲线
+    QPointer<TypeCurveAtlasDialog> m_atlasDialog;
+    QList<QCPGraph*> m_overlayGraphs;
+
+    // 图版插值预览 (精确曲线仍由 m_solver 计算)
+    TypeCurveLibrary m_previewLibrary;
+    QList<QCPGraph*> m_previewGraphs;
+
+    // 实时计算 (由粗到精)
+    ProgressiveCurveRunner m_liveRunner;
+
     // 缓存结果
     QVector<double> res_tD;
     QVector<double> res_pD;
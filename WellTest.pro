@@ -16,6 +16,18 @@ CONFIG += c++17
 QMAKE_CXXFLAGS += -O3
 QMAKE_CXXFLAGS_RELEASE -= -O2
 QMAKE_CXXFLAGS_RELEASE += -O3
+# 单精度内核 (modelsolver01-06.cpp) 的向量化需要以下两项，不影响双精度结果 (默认 SSE 4 路)
+QMAKE_CXXFLAGS += -fno-math-errno -fno-trapping-math
+# 可选指令集: qmake CONFIG+=avx2 (AVX2 + FMA，8 路) 或 CONFIG+=avx512 (16 路)；生成的程序只能在支持该指令集的 CPU 上运行，
+# 且编译器会融合乘加，双精度结果与默认构建可能有末位差异
+avx2|avx512 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2 -mfma
+}
+avx512 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX512
+    else: QMAKE_CXXFLAGS += -mavx512f -mavx512dq
+}
 
 # [关键配置] 设置生成的 .exe 文件图标
 # 警告：如果 Resource/PWT.ico 文件不存在，编译将报错 Error 1
@@ -29,12 +41,22 @@ win32: LIBS += -lm
 HEADERS += dataeditorwidget.h \
            chartsetting1.h \
            chartsetting2.h \
+           datareduction.h \
+           deconvolution.h \
+           dualnumber.h \
+           fitscheduler.h \
+           fittingcore.h \
+           fittingevolution.h \
+           fittingmodelcomparison.h \
+           fittingmultistart.h \
            fittingobserveddata.h \
            fittingpage.h \
            fittingparameterchart.h \
+           fittingschedule.h \
            modelmanager.h \
            modelparameter.h \
            modelselect.h \
+           modelsolver01-06.h \
            modelwidget01-06.h \
            mousezoom.h \
            newprojectdialog.h \
@@ -50,8 +72,13 @@ HEADERS += dataeditorwidget.h \
            plottingsinglewidget.h \
            plottingstackwidget.h \
            pressurederivativecalculator.h \
+           progressivecurverunner.h \
            pressurederivativecalculator1.h \
            settingswidget.h \
+           superposition.h \
+           typecurveatlas.h \
+           typecurveatlasdialog.h \
+           typecurvelibrary.h \
            qcustomplot.h \
            wt_fittingwidget.h \
            wt_plottingwidget.h \
@@ -84,12 +111,21 @@ SOURCES += \
            chartsetting1.cpp \
            chartsetting2.cpp \
            dataeditorwidget.cpp \
+           datareduction.cpp \
+           deconvolution.cpp \
+           fitscheduler.cpp \
+           fittingcore.cpp \
+           fittingevolution.cpp \
+           fittingmodelcomparison.cpp \
+           fittingmultistart.cpp \
            fittingobserveddata.cpp \
            fittingpage.cpp \
            fittingparameterchart.cpp \
+           fittingschedule.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
            modelselect.cpp \
+           modelsolver01-06.cpp \
            modelwidget01-06.cpp \
            mousezoom.cpp \
            newprojectdialog.cpp \
@@ -106,8 +142,13 @@ SOURCES += \
            plottingsinglewidget.cpp \
            plottingstackwidget.cpp \
            pressurederivativecalculator.cpp \
+           progressivecurverunner.cpp \
            pressurederivativecalculator1.cpp \
            settingswidget.cpp \
+           superposition.cpp \
+           typecurveatlas.cpp \
+           typecurveatlasdialog.cpp \
+           typecurvelibrary.cpp \
            qcustomplot.cpp \
            wt_fittingwidget.cpp \
            wt_plottingwidget.cpp \
@@ -0,0 +1,377 @@
+/*
+ * enginebenchmark.cpp
+ * 文件作用：计算引擎基准测试套件实现
+ * 功能描述：
+ * 1. 各测试组逐项计时并同步输出进度文本
+ * 2. 内核各部分通过友元直接调用 ModelSolver01_06 的私有函数，参数与 flaplace_composite 的组装方式一致
+ * 3. 计时结果写入 volatile 变量，防止被编译器优化掉
+ */
+
+#include "enginebenchmark.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSysInfo>
+#include <QThread>
+#include <QtGlobal>
+#include <boost/math/special_functions/bessel.hpp>
+#include <cmath>
+
+namespace {
+volatile double g_sink = 0.0;
+
+QString compilerString()
+{
+#if defined(__clang__)
+    return QString("clang %1").arg(__clang_version__);
+#elif defined(__GNUC__)
+    return QString("gcc %1").arg(__VERSION__);
+#elif defined(_MSC_VER)
+    return QString("msvc %1").arg(_MSC_FULL_VER);
+#else
+    return QString("unknown");
+#endif
+}
+
+QString cpuModelName()
+{
+    // Linux 读取 /proc/cpuinfo，Windows 读取环境变量，其余平台留空
+    QFile f("/proc/cpuinfo");
+    if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!f.atEnd()) {
+            QString line = QString::fromUtf8(f.readLine());
+            if (line.startsWith("model name")) return line.section(':', 1).trimmed();
+        }
+    }
+    return qEnvironmentVariable("PROCESSOR_IDENTIFIER");
+}
+} // namespace
+
+EngineBenchmark::EngineBenchmark(const Options& options)
+    : m_options(options)
+{
+}
+
+QJsonObject EngineBenchmark::environment()
+{
+    QJsonObject env;
+    env["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    env["host"] = QSysInfo::machineHostName();
+    env["os"] = QSysInfo::prettyProductName();
+    env["kernel"] = QSysInfo::kernelType() + " " + QSysInfo::kernelVersion();
+    env["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    env["cpuModel"] = cpuModelName();
+    env["idealThreadCount"] = QThread::idealThreadCount();
+    env["qtVersion"] = QString(qVersion());
+    env["compiler"] = compilerString();
+#ifdef QT_NO_DEBUG
+    env["buildType"] = "release";
+#else
+    env["buildType"] = "debug";
+#endif
+
+    ModelSolver01_06 solver(ModelSolver01_06::Model_1);
+    QJsonObject engine;
+    engine["highPrecision"] = solver.isHighPrecision();
+    engine["quadratureTolerance"] = solver.quadratureTolerance();
+    engine["quadratureMaxDepth"] = solver.quadratureMaxDepth();
+    env["engineDefaults"] = engine;
+    return env;
+}
+
+QJsonObject EngineBenchmark::run(QTextStream& log)
+{
+    QJsonObject report;
+    report["schema"] = 1;
+    report["environment"] = environment();
+
+    QJsonObject settings;
+    settings["quick"] = m_options.quick;
+    settings["minSeconds"] = m_options.minSeconds;
+    settings["filter"] = m_options.filter;
+    report["settings"] = settings;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (enabled("kernel")) report["kernel"] = benchKernel(log);
+    if (enabled("scaling")) report["fractureScaling"] = benchFractureScaling(log);
+    if (enabled("allModels")) report["allModels"] = benchAllModels(log);
+    if (enabled("curves")) report["curves"] = benchCurves(log);
+    report["totalSeconds"] = timer.elapsed() / 1000.0;
+    return report;
+}
+
+bool EngineBenchmark::enabled(const QString& group) const
+{
+    return m_options.filter.isEmpty() || group.contains(m_options.filter, Qt::CaseInsensitive);
+}
+
+double EngineBenchmark::timePerCall(const std::function<void()>& f, int* repeats) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    int n = 0;
+    do {
+        f();
+        ++n;
+    } while (timer.nsecsElapsed() < qint64(m_options.minSeconds * 1e9));
+    if (repeats) *repeats = n;
+    return timer.nsecsElapsed() / 1e9 / n;
+}
+
+QMap<QString, double> EngineBenchmark::dimensionalParams(int nf, int N)
+{
+    QMap<QString, double> p;
+    p["phi"] = 0.05; p["h"] = 20.0; p["mu"] = 0.5; p["B"] = 1.05; p["Ct"] = 5e-4; p["q"] = 5.0;
+    p["kf"] = 1e-3; p["km"] = 1e-4; p["L"] = 1000.0; p["Lf"] = 100.0; p["LfD"] = 0.1;
+    p["rmD"] = 4.0; p["reD"] = 10.0;
+    p["omega1"] = 0.4; p["omega2"] = 0.08; p["lambda1"] = 1e-3; p["gamaD"] = 0.02;
+    p["cD"] = 0.01; p["S"] = 1.0;
+    p["nf"] = nf; p["N"] = N;
+    return p;
+}
+
+QMap<QString, double> EngineBenchmark::dimensionlessParams(int nf)
+{
+    QMap<QString, double> p;
+    p["kf"] = 10.0; p["km"] = 1.0;
+    p["LfD"] = 0.1; p["rmD"] = 4.0; p["reD"] = 10.0;
+    p["omega1"] = 0.4; p["omega2"] = 0.08; p["lambda1"] = 1e-3;
+    p["gamaD"] = 0.02; p["cD"] = 0.01; p["S"] = 1.0;
+    p["N"] = 8; p["nf"] = nf;
+    return p;
+}
+
+QString EngineBenchmark::modelName(ModelSolver01_06::ModelType type)
+{
+    return QString("Model_%1").arg(int(type) + 1);
+}
+
+// 理论曲线: ModelType × nf × N × 点数
+QJsonArray EngineBenchmark::benchCurves(QTextStream& log)
+{
+    const QVector<int> nfList = m_options.quick ? QVector<int>{ 1, 4, 16 } : QVector<int>{ 1, 4, 16, 64 };
+    const QVector<int> nList = { 4, 8, 12 };
+    const QVector<int> pointList = m_options.quick ? QVector<int>{ 50, 500 } : QVector<int>{ 50, 500, 5000 };
+
+    log << "# calculateTheoreticalCurve\n";
+    log << QString("%1 %2 %3 %4 %5 %6\n").arg("model", 8).arg("nf", 4).arg("N", 3).arg("points", 7)
+               .arg("ms/curve", 12).arg("us/point", 10);
+    QJsonArray rows;
+    for (int m = ModelSolver01_06::Model_1; m <= ModelSolver01_06::Model_6; ++m) {
+        ModelSolver01_06::ModelType type = ModelSolver01_06::ModelType(m);
+        ModelSolver01_06 solver(type);
+        for (int nf : nfList) {
+            for (int N : nList) {
+                QMap<QString, double> params = dimensionalParams(nf, N);
+                for (int points : pointList) {
+                    QVector<double> t = ModelSolver01_06::generateLogTimeSteps(points, -3.0, 3.0);
+                    int repeats = 0;
+                    double sec = timePerCall([&]() {
+                        g_sink = std::get<1>(solver.calculateTheoreticalCurve(params, t)).last();
+                    }, &repeats);
+
+                    QJsonObject row;
+                    row["model"] = modelName(type);
+                    row["nf"] = nf;
+                    row["N"] = N;
+                    row["points"] = points;
+                    row["repeats"] = repeats;
+                    row["msPerCurve"] = sec * 1e3;
+                    row["usPerPoint"] = sec * 1e6 / points;
+                    row["laplaceEvaluations"] = points * N;
+                    rows.append(row);
+
+                    log << QString("%1 %2 %3 %4 %5 %6\n").arg(modelName(type), 8).arg(nf, 4).arg(N, 3).arg(points, 7)
+                               .arg(sec * 1e3, 12, 'f', 2).arg(sec * 1e6 / points, 10, 'f', 1);
+                    log.flush();
+                }
+            }
+        }
+    }
+    return rows;
+}
+
+// 裂缝条数扩展性: 单次拉普拉斯求值 (含 Stehfest 反演) 的平均耗时随 nf 的变化
+QJsonArray EngineBenchmark::benchFractureScaling(QTextStream& log)
+{
+    const QVector<int> nfList = m_options.quick ? QVector<int>{ 1, 4, 16, 64 }
+                                                : QVector<int>{ 1, 2, 4, 8, 16, 32, 48, 64, 96, 128 };
+    const QVector<double> tD = ModelSolver01_06::generateLogTimeSteps(9, -3, 5);
+    const int laplaceCalls = tD.size() * 8; // N = 8
+
+    log << "# fracture scaling (Model_4, N=8, " << tD.size() << " points)\n";
+    log << QString("%1 %2 %3 %4\n").arg("nf", 5).arg("ms/curve", 12).arg("us/eval", 12).arg("us/eval/nf", 12);
+    QJsonArray rows;
+    ModelSolver01_06 solver(ModelSolver01_06::Model_4);
+    for (int nf : nfList) {
+        QMap<QString, double> params = dimensionlessParams(nf);
+        int repeats = 0;
+        double sec = timePerCall([&]() { g_sink = solver.calculateDimensionlessPressure(params, tD).last(); }, &repeats);
+        double usPerEval = sec * 1e6 / laplaceCalls;
+
+        QJsonObject row;
+        row["nf"] = nf;
+        row["repeats"] = repeats;
+        row["msPerCurve"] = sec * 1e3;
+        row["usPerEvaluation"] = usPerEval;
+        rows.append(row);
+
+        log << QString("%1 %2 %3 %4\n").arg(nf, 5).arg(sec * 1e3, 12, 'f', 2)
+                   .arg(usPerEval, 12, 'f', 1).arg(usPerEval / nf, 12, 'f', 1);
+        log.flush();
+    }
+    return rows;
+}
+
+// 六个模型一次计算 (共享积分) 与逐个计算
+QJsonArray EngineBenchmark::benchAllModels(QTextStream& log)
+{
+    const QVector<double> tD = ModelSolver01_06::generateLogTimeSteps(40, -3, 5);
+    QVector<ModelSolver01_06::ModelType> types;
+    for (int m = ModelSolver01_06::Model_1; m <= ModelSolver01_06::Model_6; ++m) types.append(ModelSolver01_06::ModelType(m));
+
+    log << "# all six models (N=8, " << tD.size() << " points)\n";
+    log << QString("%1 %2 %3 %4\n").arg("nf", 5).arg("ms/single", 12).arg("ms/six-each", 12).arg("ms/six-once", 12);
+    QJsonArray rows;
+    for (int nf : { 4, 16, 64 }) {
+        QMap<QString, double> params = dimensionlessParams(nf);
+        ModelSolver01_06 solver(ModelSolver01_06::Model_1);
+
+        double single = timePerCall([&]() { g_sink = std::get<1>(solver.calculateDimensionlessCurve(params, tD)).last(); });
+        double each = timePerCall([&]() {
+            for (ModelSolver01_06::ModelType type : types) g_sink = std::get<1>(ModelSolver01_06(type).calculateDimensionlessCurve(params, tD)).last();
+        });
+        double once = timePerCall([&]() { g_sink = std::get<1>(solver.calculateDimensionlessCurves(params, types, tD).last()).last(); });
+
+        QJsonObject row;
+        row["nf"] = nf;
+        row["msSingleModel"] = single * 1e3;
+        row["msSixSeparate"] = each * 1e3;
+        row["msSixShared"] = once * 1e3;
+        rows.append(row);
+
+        log << QString("%1 %2 %3 %4\n").arg(nf, 5).arg(single * 1e3, 12, 'f', 1).arg(each * 1e3, 12, 'f', 1).arg(once * 1e3, 12, 'f', 1);
+        log.flush();
+    }
+    return rows;
+}
+
+// 内核各部分单独计时
+QJsonObject EngineBenchmark::benchKernel(QTextStream& log)
+{
+    QJsonObject kernel;
+
+    // 1. PWD_composite: 参数组装与 flaplace_composite 一致，只求封闭边界
+    log << "# PWD_composite (closed boundary)\n";
+    log << QString("%1 %2 %3 %4\n").arg("nf", 5).arg("tD", 8).arg("us/call", 12).arg("integrand", 10);
+    QJsonArray pwdRows;
+    ModelSolver01_06 solver(ModelSolver01_06::Model_4);
+    for (int nf : { 1, 4, 16, 64 }) {
+        QMap<QString, double> p = dimensionlessParams(nf);
+        double M12 = p["kf"] / p["km"];
+        QVector<double> xwD;
+        if (nf == 1) { xwD.append(0.0); } else {
+            for (int i = 0; i < nf; ++i) xwD.append(-0.9 + i * 1.8 / (nf - 1));
+        }
+        for (double tD : { 1e-2, 1.0, 1e2 }) {
+            double z = std::log(2.0) / tD;
+            double fs1 = p["omega1"] + p["lambda1"] * p["omega2"] / (p["lambda1"] + z * p["omega2"]);
+            double fs2 = M12 * p["omega2"];
+            bool needed[ModelSolver01_06::BoundaryCount] = { false, true, false };
+            double out[ModelSolver01_06::BoundaryCount];
+            auto call = [&](EngineStats* stats) {
+                solver.PWD_composite(z, fs1, fs2, M12, p["LfD"], p["rmD"], p["reD"], nf, xwD, needed, out, stats);
+                g_sink = out[ModelSolver01_06::Boundary_Closed];
+            };
+            double sec = timePerCall([&]() { call(nullptr); });
+            EngineStats stats;
+            call(&stats);
+
+            QJsonObject row;
+            row["nf"] = nf;
+            row["tD"] = tD;
+            row["usPerCall"] = sec * 1e6;
+            row["integrandCalls"] = double(stats.integrandCalls);
+            row["adaptiveIntegrals"] = double(stats.adaptiveIntegrals);
+            row["fixedRuleIntegrals"] = double(stats.fixedRuleIntegrals);
+            row["maxDepthHits"] = double(stats.maxDepthHits);
+            pwdRows.append(row);
+
+            log << QString("%1 %2 %3 %4\n").arg(nf, 5).arg(tD, 8, 'g', 3).arg(sec * 1e6, 12, 'f', 1).arg(stats.integrandCalls, 10);
+            log.flush();
+        }
+    }
+    kernel["pwdComposite"] = pwdRows;
+
+    // 2. 自适应积分: 自身裂缝 (对数奇点位于区间中点) 与相邻裂缝 (光滑) 两种被积函数
+    log << "# adaptiveGauss\n";
+    log << QString("%1 %2 %3 %4\n").arg("case", 10).arg("gamma", 8).arg("us/call", 12).arg("integrand", 10);
+    QJsonArray quadRows;
+    const double LfD = 0.1;
+    for (double offset : { 0.0, 0.3 }) {
+        for (double gamma : { 1.0, 10.0, 100.0 }) {
+            qint64 calls = 0;
+            ModelSolver01_06::NodeIntegrand f = [&](const double* a, int n, double* k, double* i) {
+                calls += n;
+                for (int j = 0; j < n; ++j) {
+                    double x = std::max(1e-10, gamma * std::abs(offset - a[j]));
+                    k[j] = boost::math::cyl_bessel_k(0, x);
+                    i[j] = ModelSolver01_06::scaled_besseli(0, x);
+                }
+            };
+            auto call = [&](EngineStats* stats) {
+                double sk, si;
+                ModelSolver01_06::adaptiveGauss(f, -LfD, LfD, solver.quadratureTolerance(), 1.0, 0, solver.quadratureMaxDepth(), sk, si, stats);
+                g_sink = sk + si;
+            };
+            double sec = timePerCall([&]() { call(nullptr); });
+            calls = 0;
+            EngineStats stats;
+            call(&stats);
+
+            QString name = (offset == 0.0) ? "self" : "neighbour";
+            QJsonObject row;
+            row["case"] = name;
+            row["gamma"] = gamma;
+            row["usPerCall"] = sec * 1e6;
+            row["integrandCalls"] = double(calls);
+            row["maxDepthHits"] = double(stats.maxDepthHits);
+            quadRows.append(row);
+
+            log << QString("%1 %2 %3 %4\n").arg(name, 10).arg(gamma, 8, 'g', 3).arg(sec * 1e6, 12, 'f', 2).arg(calls, 10);
+            log.flush();
+        }
+    }
+    kernel["adaptiveGauss"] = quadRows;
+
+    // 3. Bessel 函数: 在 1e-3 ~ 1e2 对数均匀的 64 个自变量上轮流调用
+    log << "# Bessel\n";
+    QVector<double> xs = ModelSolver01_06::generateLogTimeSteps(64, -3, 2);
+    struct BesselCase { const char* name; std::function<double(double)> f; };
+    const QVector<BesselCase> cases = {
+        { "K0", [](double x) { return boost::math::cyl_bessel_k(0, x); } },
+        { "K1", [](double x) { return boost::math::cyl_bessel_k(1, x); } },
+        { "scaledI0", [](double x) { return ModelSolver01_06::scaled_besseli(0, x); } },
+        { "scaledI1", [](double x) { return ModelSolver01_06::scaled_besseli(1, x); } },
+    };
+    QJsonArray besselRows;
+    for (const BesselCase& c : cases) {
+        double sec = timePerCall([&]() {
+            double s = 0.0;
+            for (double x : xs) s += c.f(x);
+            g_sink = s;
+        });
+        double ns = sec * 1e9 / xs.size();
+
+        QJsonObject row;
+        row["function"] = QString(c.name);
+        row["nsPerCall"] = ns;
+        besselRows.append(row);
+        log << QString("%1 %2 ns\n").arg(c.name, 10).arg(ns, 10, 'f', 1);
+        log.flush();
+    }
+    kernel["bessel"] = besselRows;
+    return kernel;
+}
@@ -0,0 +1,59 @@
+/*
+ * enginebenchmark.h
+ * 文件作用：计算引擎基准测试套件
+ * 功能描述：
+ * 1. 理论曲线: 全部 ModelType × 裂缝条数 nf × Stehfest N × 时间点数，计时 calculateTheoreticalCurve
+ * 2. 裂缝条数扩展性与六模型一次计算对比
+ * 3. 内核各部分单独计时: PWD_composite、自适应积分、Bessel 函数
+ * 4. 结果连同运行环境信息写为 JSON，便于比较各次引擎修改的收益与退化
+ * 所有计时均在调用线程中顺序执行，不使用引擎线程池。
+ */
+
+#ifndef ENGINEBENCHMARK_H
+#define ENGINEBENCHMARK_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QTextStream>
+#include <functional>
+#include "modelsolver01-06.h"
+
+class EngineBenchmark
+{
+public:
+    struct Options {
+        bool quick = false;        // 缩减参数网格 (点数 ≤ 500, nf ≤ 16)，用于快速检查
+        double minSeconds = 0.2;   // 单项计时的最短累计时间，不足时重复执行
+        QString filter;            // 只运行名称包含该字符串的测试组 (curves / scaling / allModels / kernel)
+    };
+
+    explicit EngineBenchmark(const Options& options);
+
+    // 运行全部测试组，进度写入 log，返回完整 JSON 报告
+    QJsonObject run(QTextStream& log);
+
+    // 运行环境: Qt 版本、编译器、操作系统、CPU 架构与线程数、构建类型、时间戳
+    static QJsonObject environment();
+
+private:
+    QJsonArray benchCurves(QTextStream& log);
+    QJsonArray benchFractureScaling(QTextStream& log);
+    QJsonArray benchAllModels(QTextStream& log);
+    QJsonObject benchKernel(QTextStream& log);
+
+    // 有因次基准参数 (与模型页默认值一致) / 无因次基准参数 (kf = M12, km = 1)
+    static QMap<QString, double> dimensionalParams(int nf, int N);
+    static QMap<QString, double> dimensionlessParams(int nf);
+    static QString modelName(ModelSolver01_06::ModelType type);
+
+    // 单次调用的平均耗时 (秒)；累计时间不足 minSeconds 时重复执行
+    double timePerCall(const std::function<void()>& f, int* repeats = nullptr) const;
+    bool enabled(const QString& group) const;
+
+private:
+    Options m_options;
+};
+
+#endif // ENGINEBENCHMARK_H
@@ -0,0 +1,54 @@
+/*
+ * main.cpp (benchmark)
+ * 文件作用：计算引擎基准测试入口
+ * 功能描述：
+ * 1. 运行 EngineBenchmark 各测试组，进度输出到标准输出
+ * 2. 完整结果 (含运行环境信息) 写入 JSON 文件
+ * 用法: benchmark [--quick] [--filter 组名] [--min-seconds 秒] [--output 文件]
+ *       组名: kernel / scaling / allModels / curves
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include "enginebenchmark.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("WellTest 计算引擎基准测试");
+    parser.addHelpOption();
+    QCommandLineOption quickOption("quick", "缩减参数网格 (点数 <= 500, nf <= 16)");
+    QCommandLineOption filterOption("filter", "只运行名称包含该字符串的测试组", "group");
+    QCommandLineOption minSecondsOption("min-seconds", "单项计时的最短累计时间 (默认 0.2 秒)", "seconds", "0.2");
+    QCommandLineOption outputOption("output", "JSON 结果文件 (默认 benchmark.json)", "file", "benchmark.json");
+    parser.addOption(quickOption);
+    parser.addOption(filterOption);
+    parser.addOption(minSecondsOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    EngineBenchmark::Options options;
+    options.quick = parser.isSet(quickOption);
+    options.filter = parser.value(filterOption);
+    options.minSeconds = qMax(0.0, parser.value(minSecondsOption).toDouble());
+
+    QTextStream out(stdout);
+    EngineBenchmark bench(options);
+    QJsonObject report = bench.run(out);
+
+    QString path = parser.value(outputOption);
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        out << "无法写入结果文件: " << path << "\n";
+        return 1;
+    }
+    f.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    out << "结果已写入 " << path << "\n";
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * datareduction.cpp
+ * 文件作用：观测数据对数分箱抽稀实现
+ * 功能描述：
+ * 1. 箱号 floor(k * log10 t)，点按时间排序后逐箱聚合 (箱号单调不减)，原始数据可以无序
+ * 2. 中位数用 nth_element (偶数个取中间两者的平均)，箱内只有一个点时直接输出原值
+ * 3. 保留的首末点只从压力有效 (p > 1e-10) 的样本中选取
+ */
+
+#include "datareduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// 中位数或均值 (values 会被重排)；geometric 为 true 时均值取几何均值
+double aggregate(std::vector<double>& values, DataReduction::Aggregation aggregation, bool geometric)
+{
+    int n = int(values.size());
+    if (n == 0) return 0.0;
+    if (n == 1) return values[0];
+    if (aggregation == DataReduction::Median) {
+        auto mid = values.begin() + n / 2;
+        std::nth_element(values.begin(), mid, values.end());
+        double upper = *mid;
+        if (n % 2 != 0) return upper;
+        double lower = *std::max_element(values.begin(), mid);
+        return 0.5 * (lower + upper);
+    }
+    if (geometric) {
+        double s = 0.0;
+        for (double v : values) s += std::log(v);
+        return std::exp(s / n);
+    }
+    return std::accumulate(values.begin(), values.end(), 0.0) / n;
+}
+
+}
+
+void DataReduction::logBinned(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, const Settings& settings,
+                              QVector<double>& outT, QVector<double>& outP, QVector<double>& outD)
+{
+    int n = qMin(t.size(), p.size());
+    if (!settings.isEnabled()) {
+        outT = t.mid(0, n);
+        outP = p.mid(0, n);
+        outD = d.mid(0, qMin(n, d.size()));
+        return;
+    }
+    outT.clear(); outP.clear(); outD.clear();
+
+    auto derivative = [&](int i) { return i < d.size() ? d[i] : 0.0; };
+    std::vector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (t[i] > 0.0 && std::isfinite(t[i])) order.push_back(i);
+    }
+    if (order.empty()) return;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return t[a] < t[b]; });
+
+    auto append = [&](double ti, double pi, double di) { outT.append(ti); outP.append(pi); outD.append(di); };
+    int first = 0, last = int(order.size());
+    int head = -1, tail = -1;
+    if (settings.keepEndpoints) {
+        // 首末点取压力有效的样本，其外侧的无效点不参与分箱；没有有效压力时不保留端点
+        for (int i = 0; i < int(order.size()); ++i) {
+            if (p[order[i]] > 1e-10) { if (head < 0) head = i; tail = i; }
+        }
+        if (head >= 0) {
+            append(t[order[head]], p[order[head]], derivative(order[head]));
+            if (head == tail) return;
+            first = head + 1; last = tail;
+        }
+    }
+
+    // 逐箱聚合 (点已按时间排序，箱号单调不减)
+    double k = settings.pointsPerCycle;
+    std::vector<double> ts, ps, ds;
+    for (int i = first; i < last;) {
+        double bin = std::floor(k * std::log10(t[order[i]]));
+        ts.clear(); ps.clear(); ds.clear();
+        for (; i < last && std::floor(k * std::log10(t[order[i]])) == bin; ++i) {
+            int j = order[i];
+            ts.push_back(t[j]);
+            if (p[j] > 1e-10) ps.push_back(p[j]);
+            if (derivative(j) > 1e-10) ds.push_back(derivative(j));
+        }
+        append(aggregate(ts, settings.aggregation, true), aggregate(ps, settings.aggregation, false), aggregate(ds, settings.aggregation, false));
+    }
+
+    if (head >= 0) append(t[order[tail]], p[order[tail]], derivative(order[tail]));
+}
@@ -0,0 +1,35 @@
+/*
+ * datareduction.h
+ * 文件作用：观测数据的对数分箱抽稀 (拟合前的数据缩减)
+ * 功能描述：
+ * 1. 按 log10(t) 等分为每个对数周期 k 个箱，每个非空箱输出一个点，各对数周期在残差中的权重相同
+ * 2. 箱内时间、压力、导数分别取中位数或均值 (时间的均值为几何均值)，无效的压力/导数 (<= 1e-10) 不参与
+ * 3. 可原样保留第一个与最后一个有效点，保证拟合区间的两端不变
+ * 4. 计算量 O(n log n)，与观测点数相比抽稀后的点数只取决于时间跨度
+ */
+
+#ifndef DATAREDUCTION_H
+#define DATAREDUCTION_H
+
+#include <QVector>
+
+class DataReduction
+{
+public:
+    enum Aggregation { Median = 0, Mean = 1 };
+
+    struct Settings {
+        int pointsPerCycle = 0;            // 每个对数周期的点数，<= 0 表示不抽稀
+        Aggregation aggregation = Median;
+        bool keepEndpoints = true;         // 原样保留压力有效的首末点
+
+        bool isEnabled() const { return pointsPerCycle > 0; }
+    };
+
+    // 抽稀 (t, p, d)，结果按时间升序；未启用时原样返回。d 可短于 t，缺少的导数视为无效
+    // t <= 0 的点不参与分箱 (对数坐标下无意义)
+    static void logBinned(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, const Settings& settings,
+                          QVector<double>& outT, QVector<double>& outP, QVector<double>& outD);
+};
+
+#endif // DATAREDUCTION_H
@@ -0,0 +1,267 @@
+/*
+ * deconvolution.cpp
+ * 文件作用：压力-产量反褶积实现
+ * 功能描述：
+ * 1. 样本: 首段之前的静压点合并为一个样本，其余各流动段按距段首的对数时间分桶平均
+ * 2. 节点网格沿用 RateSuperposition::masterGrid，每个节点区间再细分为 subdivisions 段，
+ *    p_u 与 ∂p_u/∂z 在细分网格上逐段解析累加 (段内 z 线性，∫exp(z) 有闭式)
+ * 3. 卷积矩阵 W (样本 × 细分网格) 只含产量与时间，构造一次；模型压力 p0 - W·p_u，雅可比 -W·∂p_u/∂z
+ * 4. 初值取 z 为常数 (径向流)，此时模型对 (p0, exp(z)) 线性，先做一次线性最小二乘
+ */
+
+#include "deconvolution.h"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// φ(d) = (e^d - 1) / d 及其导数，小 d 时用级数避免相消
+inline double expRatio(double d)
+{
+    if (std::abs(d) < 1e-4) return 1.0 + d * (0.5 + d / 6.0);
+    return std::expm1(d) / d;
+}
+
+inline double expRatioDerivative(double d)
+{
+    if (std::abs(d) < 1e-4) return 0.5 + d * (1.0 / 3.0 + d / 8.0);
+    return (std::exp(d) * (d - 1.0) + 1.0) / (d * d);
+}
+
+}
+
+PressureRateDeconvolution::PressureRateDeconvolution(const Options& options)
+    : m_options(options)
+{
+}
+
+void PressureRateDeconvolution::resample(const QVector<double>& t, const QVector<double>& p, const RateSchedule& rates,
+                                         QVector<double>& ts, QVector<double>& ps) const
+{
+    const QVector<double>& s = rates.startTimes;
+    int n = qMin(t.size(), p.size());
+
+    // 各流动段在 t 中的下标范围 [first, last)
+    struct Period { int first; int last; double origin; };
+    QVector<Period> periods;
+    int pre = int(std::upper_bound(t.begin(), t.begin() + n, s.first()) - t.begin());
+    for (int j = 0; j < s.size(); ++j) {
+        int first = int(std::upper_bound(t.begin(), t.begin() + n, s[j]) - t.begin());
+        int last = (j + 1 < s.size()) ? int(std::upper_bound(t.begin(), t.begin() + n, s[j + 1]) - t.begin()) : n;
+        if (last > first) periods.append({ first, last, s[j] });
+    }
+
+    // 每十倍程桶数: 按各段对数跨度分配样本上限
+    double decades = 0.0;
+    for (const Period& pd : periods) decades += std::log10((t[pd.last - 1] - pd.origin) / (t[pd.first] - pd.origin));
+    double perDecade = decades > 0.0 ? double(m_options.maxSamples - periods.size()) / decades : 20.0;
+    perDecade = qBound(1.0, perDecade, 20.0);
+
+    ts.clear();
+    ps.clear();
+    if (pre > 0) {
+        double st = 0.0, sp = 0.0;
+        for (int i = 0; i < pre; ++i) { st += t[i]; sp += p[i]; }
+        ts.append(st / pre);
+        ps.append(sp / pre);
+    }
+    for (const Period& pd : periods) {
+        double e0 = t[pd.first] - pd.origin;
+        int bucket = -1, count = 0;
+        double st = 0.0, sp = 0.0;
+        for (int i = pd.first; i < pd.last; ++i) {
+            int b = int(perDecade * std::log10((t[i] - pd.origin) / e0));
+            if (b != bucket && count > 0) {
+                ts.append(st / count);
+                ps.append(sp / count);
+                st = sp = 0.0;
+                count = 0;
+            }
+            bucket = b;
+            st += t[i];
+            sp += p[i];
+            ++count;
+        }
+        if (count > 0) {
+            ts.append(st / count);
+            ps.append(sp / count);
+        }
+    }
+}
+
+PressureRateDeconvolution::Result PressureRateDeconvolution::run(const QVector<double>& t, const QVector<double>& p, const RateSchedule& rates) const
+{
+    Result res;
+    if (!rates.isValid(&res.error)) return res;
+    if (t.size() != p.size() || t.size() < 3) { res.error = "压力数据点数不足"; return res; }
+    for (int i = 1; i < t.size(); ++i) {
+        if (!(t[i] >= t[i - 1])) { res.error = "压力数据时间需为升序"; return res; }
+    }
+
+    // ---------------- 样本与网格 ----------------
+    QVector<double> ts, ps;
+    resample(t, p, rates, ts, ps);
+    int S = ts.size();
+
+    QVector<double> nodes = RateSuperposition(rates, m_options.nodesPerDecade).masterGrid(ts);
+    int N = nodes.size();
+    if (N < 3 || S < 3) { res.error = "产量开始后的压力数据过少，无法反褶积"; return res; }
+
+    int r = qMax(1, m_options.subdivisions);
+    int M = (N - 1) * r + 1;
+    double sigma0 = std::log(nodes.first());
+    double h = (std::log(nodes.last()) - sigma0) / (N - 1);
+    double delta = h / r;
+
+    // ---------------- 卷积矩阵 W ----------------
+    const QVector<double>& st = rates.startTimes;
+    const QVector<double>& q = rates.rates;
+    Eigen::MatrixXd W = Eigen::MatrixXd::Zero(S, M);
+    for (int i = 0; i < S; ++i) {
+        for (int j = 0; j < st.size() && st[j] < ts[i]; ++j) {
+            double dq = q[j] - (j > 0 ? q[j - 1] : 0.0);
+            if (dq == 0.0) continue;
+            double u = (std::log(ts[i] - st[j]) - sigma0) / delta;
+            if (u < 0.0) {
+                // 首节点之前按单位斜率 (井储) 外推
+                W(i, 0) += dq * std::exp(u * delta);
+                continue;
+            }
+            u = qMin(u, double(M - 1));
+            int m = qMin(int(u), M - 2);
+            double f = u - m;
+            W(i, m) += dq * (1.0 - f);
+            W(i, m + 1) += dq * f;
+        }
+    }
+
+    // ---------------- 响应与导数 ----------------
+    // z 在节点间线性；首节点之前 dp_u/dln t ∝ t，积分为 exp(z0)
+    Eigen::VectorXd pu(M);
+    Eigen::MatrixXd D = Eigen::MatrixXd::Zero(M, N);
+    auto response = [&](const Eigen::VectorXd& z) {
+        pu(0) = std::exp(z(0));
+        D(0, 0) = pu(0);
+        for (int m = 0; m + 1 < M; ++m) {
+            int k = m / r;
+            double fa = double(m - k * r) / r, fb = fa + 1.0 / r;
+            double a = z(k) + fa * (z(k + 1) - z(k));
+            double b = z(k) + fb * (z(k + 1) - z(k));
+            double ea = delta * std::exp(a);
+            double E = ea * expRatio(b - a);
+            double dEdb = ea * expRatioDerivative(b - a);
+            double dEda = E - dEdb;
+            pu(m + 1) = pu(m) + E;
+            D.row(m + 1) = D.row(m);
+            D(m + 1, k) += dEda * (1.0 - fa) + dEdb * (1.0 - fb);
+            D(m + 1, k + 1) += dEda * fa + dEdb * fb;
+        }
+    };
+
+    Eigen::VectorXd obs(S);
+    double pMin = ps.first(), pMax = ps.first();
+    for (int i = 0; i < S; ++i) { obs(i) = ps[i]; pMin = qMin(pMin, ps[i]); pMax = qMax(pMax, ps[i]); }
+    double pScale = qMax(pMax - pMin, 1e-12 * qMax(1.0, std::abs(pMax)));
+
+    bool fixedP0 = std::isfinite(m_options.initialPressure);
+
+    // ---------------- 初值: z 为常数 ----------------
+    Eigen::VectorXd z = Eigen::VectorXd::Zero(N);
+    response(z);
+    Eigen::VectorXd v = W * pu;
+    double p0, amp;
+    if (fixedP0) {
+        p0 = m_options.initialPressure;
+        double vv = v.squaredNorm();
+        amp = vv > 0.0 ? v.dot(Eigen::VectorXd::Constant(S, p0) - obs) / vv : 0.0;
+    } else {
+        Eigen::MatrixXd A(S, 2);
+        A.col(0).setOnes();
+        A.col(1) = -v;
+        Eigen::Vector2d c = A.colPivHouseholderQr().solve(obs);
+        p0 = c(0);
+        amp = c(1);
+    }
+    if (!(amp > 0.0) || !std::isfinite(amp)) amp = pScale / qMax(v.cwiseAbs().maxCoeff(), 1e-300);
+    z.setConstant(std::log(amp));
+
+    // ---------------- Levenberg-Marquardt ----------------
+    int nReg = N - 2;
+    double regWeight = std::sqrt(qMax(0.0, m_options.regularization) * S / nReg);
+    int nx = N + (fixedP0 ? 0 : 1);
+
+    auto evaluate = [&](const Eigen::VectorXd& zz, double pp0, Eigen::VectorXd& rvec) {
+        response(zz);
+        rvec.resize(S + nReg);
+        rvec.head(S) = ((Eigen::VectorXd::Constant(S, pp0) - W * pu) - obs) / pScale;
+        for (int k = 0; k < nReg; ++k) rvec(S + k) = regWeight * (zz(k) - 2.0 * zz(k + 1) + zz(k + 2));
+        return rvec.squaredNorm();
+    };
+
+    Eigen::VectorXd rvec;
+    double cost = evaluate(z, p0, rvec);
+    double mu = 1e-3;
+    int iter = 0;
+    bool converged = false;
+    for (; iter < m_options.maxIterations && !converged; ++iter) {
+        // evaluate 之后 pu / D 对应当前 z
+        Eigen::MatrixXd J = Eigen::MatrixXd::Zero(S + nReg, nx);
+        J.topLeftCorner(S, N) = -(W * D) / pScale;
+        if (!fixedP0) J.block(0, N, S, 1).setConstant(1.0 / pScale);
+        for (int k = 0; k < nReg; ++k) {
+            J(S + k, k) = regWeight;
+            J(S + k, k + 1) = -2.0 * regWeight;
+            J(S + k, k + 2) = regWeight;
+        }
+        Eigen::MatrixXd H = J.transpose() * J;
+        Eigen::VectorXd g = J.transpose() * rvec;
+
+        bool accepted = false;
+        for (int tryIter = 0; tryIter < 10 && !accepted; ++tryIter) {
+            Eigen::MatrixXd Hd = H;
+            for (int i = 0; i < nx; ++i) Hd(i, i) += mu * (H(i, i) + 1e-12);
+            Eigen::VectorXd dx = Hd.ldlt().solve(-g);
+            Eigen::VectorXd zTrial = z + dx.head(N);
+            double p0Trial = fixedP0 ? p0 : p0 + dx(N);
+            Eigen::VectorXd rTrial;
+            double trialCost = evaluate(zTrial, p0Trial, rTrial);
+            if (std::isfinite(trialCost) && trialCost < cost) {
+                double decrease = (cost - trialCost) / cost;
+                z = zTrial; p0 = p0Trial; rvec = rTrial; cost = trialCost;
+                mu = qMax(mu / 10.0, 1e-12);
+                accepted = true;
+                converged = decrease < m_options.tolerance;
+            } else {
+                mu *= 10.0;
+            }
+        }
+        if (!accepted) break;
+    }
+    response(z);
+
+    // ---------------- 结果 ----------------
+    double qRef = m_options.referenceRate;
+    if (qRef == 0.0) for (double rate : q) qRef = qMax(qRef, std::abs(rate));
+
+    res.t = nodes;
+    res.dp.resize(N);
+    res.derivative.resize(N);
+    for (int k = 0; k < N; ++k) {
+        res.dp[k] = qRef * pu(k * r);
+        res.derivative[k] = qRef * std::exp(z(k));
+    }
+
+    Eigen::VectorXd fitted = Eigen::VectorXd::Constant(S, p0) - W * pu;
+    res.sampleTime = ts;
+    res.samplePressure = ps;
+    res.fittedPressure.resize(S);
+    for (int i = 0; i < S; ++i) res.fittedPressure[i] = fitted(i);
+    res.rmsMisfit = std::sqrt((fitted - obs).squaredNorm() / S);
+    res.referenceRate = qRef;
+    res.initialPressure = p0;
+    res.iterations = iter;
+    res.ok = true;
+    return res;
+}
@@ -0,0 +1,69 @@
+/*
+ * deconvolution.h
+ * 文件作用：压力-产量反褶积 (由变产量压力历史恢复恒定产量响应)
+ * 功能描述：
+ * 1. 采用节点对数导数形式: z(σ) = ln(dp_u/dln t)，σ = ln t，z 在对数等距节点间线性，
+ *    单位产量响应 p_u 为 exp(z) 的解析积分，恒为正且单调
+ * 2. 实测压力 p(t) = p0 - Σ (q_j - q_{j-1}) · p_u(t - t_j)，以节点曲率为正则项做 Levenberg-Marquardt 最小二乘
+ * 3. 产量阶跃的卷积只与时间有关，预先折算为 "样本 × 细分网格" 的常数矩阵，每次迭代只需一次矩阵乘法
+ * 4. 长压力历史先按各流动段对数分桶平均为不超过 maxSamples 个样本，10^5 点的历史可在数秒内完成
+ * 5. 结果 (t, Δp, dΔp/dln t) 对应恒定产量 referenceRate，可直接作为拟合的观测数据
+ */
+
+#ifndef DECONVOLUTION_H
+#define DECONVOLUTION_H
+
+#include <QString>
+#include <QVector>
+#include <limits>
+#include "superposition.h"
+
+class PressureRateDeconvolution
+{
+public:
+    struct Options {
+        int nodesPerDecade = 8;          // 响应节点密度 (每十倍程)
+        int subdivisions = 4;            // 每个节点区间的细分数 (卷积插值网格)
+        int maxSamples = 2000;           // 参与拟合的压力样本数上限 (近似)
+        double regularization = 1e-3;    // 曲率正则化权重 (无因次，越大响应越光滑)
+        double initialPressure = std::numeric_limits<double>::quiet_NaN(); // 已知原始地层压力；NaN 时一并求解
+        double referenceRate = 0.0;      // 输出对应的恒定产量，0 时取产量历史中绝对值最大的产量
+        int maxIterations = 50;
+        double tolerance = 1e-8;         // 目标函数相对下降量收敛判据
+    };
+
+    struct Result {
+        bool ok = false;
+        QString error;
+
+        // 恒定产量 referenceRate 下的响应 (节点处)
+        QVector<double> t;
+        QVector<double> dp;
+        QVector<double> derivative;
+
+        double referenceRate = 0.0;
+        double initialPressure = 0.0;    // 求得 (或给定) 的原始地层压力
+        double rmsMisfit = 0.0;          // 样本压力的均方根拟合误差 (与压力同单位)
+        int iterations = 0;
+
+        // 拟合使用的样本及其重构压力
+        QVector<double> sampleTime;
+        QVector<double> samplePressure;
+        QVector<double> fittedPressure;
+    };
+
+    explicit PressureRateDeconvolution(const Options& options);
+
+    // t 升序，与 rates 的起始时间同一时间轴；首段产量开始之前的点视为静压
+    Result run(const QVector<double>& t, const QVector<double>& p, const RateSchedule& rates) const;
+
+private:
+    // 各流动段内按对数分桶求平均
+    void resample(const QVector<double>& t, const QVector<double>& p, const RateSchedule& rates,
+                  QVector<double>& ts, QVector<double>& ps) const;
+
+private:
+    Options m_options;
+};
+
+#endif // DECONVOLUTION_H
@@ -0,0 +1,79 @@
+/*
+ * dualnumber.h
+ * 文件作用：前向自动微分用的对偶数
+ * 功能描述：
+ * 1. Dual = 函数值 + 至多 kMaxDirections 个方向导数；方向数在运行时确定，常数的方向数为 0 (各方向导数视为 0)
+ * 2. 四则运算与 sqrt / exp / log，按链式法则同时传播全部方向导数
+ * 3. 比较与分支只看函数值 (v)，调用方据此保证与 double 路径走同一分支
+ */
+
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include <algorithm>
+#include <cmath>
+
+struct Dual {
+    static const int kMaxDirections = 16;
+
+    double v = 0.0;              // 函数值
+    int n = 0;                   // 有效方向数
+    double d[kMaxDirections];    // 方向导数 (只有前 n 个有效)
+
+    Dual() {}
+    Dual(double value) : v(value) {}
+
+    // 第 index 个自变量 (共 directions 个方向)
+    static Dual variable(double value, int directions, int index)
+    {
+        Dual r(value);
+        r.n = directions;
+        std::fill(r.d, r.d + directions, 0.0);
+        r.d[index] = 1.0;
+        return r;
+    }
+
+    double dir(int i) const { return i < n ? d[i] : 0.0; }
+
+    // 以 f(v) = value、f'(v) = slope 作用于 a
+    static Dual chain(const Dual& a, double value, double slope)
+    {
+        Dual r(value);
+        r.n = a.n;
+        for (int i = 0; i < a.n; ++i) r.d[i] = slope * a.d[i];
+        return r;
+    }
+
+    // ca * a + cb * b (值另给)
+    static Dual combine(double value, double ca, const Dual& a, double cb, const Dual& b)
+    {
+        Dual r(value);
+        r.n = std::max(a.n, b.n);
+        for (int i = 0; i < r.n; ++i) r.d[i] = ca * a.dir(i) + cb * b.dir(i);
+        return r;
+    }
+
+    Dual operator-() const { return chain(*this, -v, -1.0); }
+    Dual& operator+=(const Dual& b) { return *this = combine(v + b.v, 1.0, *this, 1.0, b); }
+    Dual& operator-=(const Dual& b) { return *this = combine(v - b.v, 1.0, *this, -1.0, b); }
+    Dual& operator*=(const Dual& b) { return *this = combine(v * b.v, b.v, *this, v, b); }
+};
+
+inline Dual operator+(const Dual& a, const Dual& b) { return Dual::combine(a.v + b.v, 1.0, a, 1.0, b); }
+inline Dual operator-(const Dual& a, const Dual& b) { return Dual::combine(a.v - b.v, 1.0, a, -1.0, b); }
+inline Dual operator*(const Dual& a, const Dual& b) { return Dual::combine(a.v * b.v, b.v, a, a.v, b); }
+inline Dual operator/(const Dual& a, const Dual& b) { double q = a.v / b.v; return Dual::combine(q, 1.0 / b.v, a, -q / b.v, b); }
+inline Dual operator+(const Dual& a, double b) { return Dual::chain(a, a.v + b, 1.0); }
+inline Dual operator+(double a, const Dual& b) { return Dual::chain(b, a + b.v, 1.0); }
+inline Dual operator-(const Dual& a, double b) { return Dual::chain(a, a.v - b, 1.0); }
+inline Dual operator-(double a, const Dual& b) { return Dual::chain(b, a - b.v, -1.0); }
+inline Dual operator*(const Dual& a, double b) { return Dual::chain(a, a.v * b, b); }
+inline Dual operator*(double a, const Dual& b) { return Dual::chain(b, a * b.v, a); }
+inline Dual operator/(const Dual& a, double b) { return Dual::chain(a, a.v / b, 1.0 / b); }
+inline Dual operator/(double a, const Dual& b) { double q = a / b.v; return Dual::chain(b, q, -q / b.v); }
+
+inline Dual sqrt(const Dual& a) { double s = std::sqrt(a.v); return Dual::chain(a, s, 0.5 / s); }
+inline Dual exp(const Dual& a) { double e = std::exp(a.v); return Dual::chain(a, e, e); }
+inline Dual log(const Dual& a) { return Dual::chain(a, std::log(a.v), 1.0 / a.v); }
+
+#endif // DUALNUMBER_H
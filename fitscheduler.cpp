@@ -0,0 +1,108 @@
+/*
+ * fitscheduler.cpp
+ * 文件作用：拟合会话调度实现
+ * 功能描述：
+ * 1. 活动会话数为进程内全局计数 (原子量)，当前会话为线程局部变量
+ * 2. 任务下标由原子计数器分发，调用线程与协助线程竞争领取，领取到超出范围的下标即退出
+ * 3. 协助线程数按会话累计 (不在会话中调用时按本次调用计)，同一会话并发的多个批次共用份额
+ */
+
+#include "fitscheduler.h"
+#include "modelsolver01-06.h"
+
+#include <QSemaphore>
+#include <QThreadPool>
+
+namespace {
+
+std::atomic<int> g_activeSessions(0);
+thread_local FitScheduler::Session* t_session = nullptr;
+
+}
+
+FitScheduler::Session::Session()
+    : m_outer(t_session)
+    , m_poolHelpers(0)
+    , m_engineHelpers(0)
+{
+    g_activeSessions.fetch_add(1);
+    t_session = this;
+}
+
+FitScheduler::Session::~Session()
+{
+    t_session = m_outer;
+    g_activeSessions.fetch_sub(1);
+}
+
+int FitScheduler::activeSessions() { return g_activeSessions.load(); }
+
+int FitScheduler::share(QThreadPool* pool)
+{
+    return qMax(1, pool->maxThreadCount() / qMax(1, activeSessions()));
+}
+
+int FitScheduler::fairShare() { return share(QThreadPool::globalInstance()); }
+
+int FitScheduler::engineShare() { return share(ModelSolver01_06::enginePool()); }
+
+void FitScheduler::run(int count, const std::function<void(int index)>& task)
+{
+    runOn(QThreadPool::globalInstance(), &Session::m_poolHelpers, count, task);
+}
+
+void FitScheduler::runEngineBatch(int count, const std::function<void(int index)>& task)
+{
+    runOn(ModelSolver01_06::enginePool(), &Session::m_engineHelpers, count, task);
+}
+
+void FitScheduler::runOn(QThreadPool* pool, std::atomic<int> Session::*helperCount, int count, const std::function<void(int index)>& task)
+{
+    Session* session = t_session;
+    std::atomic<int> localHelpers(0);
+    std::atomic<int>& helpers = session ? session->*helperCount : localHelpers;
+    std::atomic<int> next(0);
+    QSemaphore finished;
+    int started = 0;
+    // 其他会话开始后份额变小: 超出份额的协助线程逐个退出 (比较交换保证只退出超出的个数)，剩余任务由其余线程领取
+    auto leaveOverShare = [&helpers, pool]() {
+        int h = helpers.load();
+        while (h > share(pool) - 1) {
+            if (helpers.compare_exchange_weak(h, h - 1)) return true;
+        }
+        return false;
+    };
+    auto helper = [&, session]() {
+        Session* outer = t_session;
+        t_session = session;
+        for (;;) {
+            int k = next.fetch_add(1);
+            if (k >= count) {
+                helpers.fetch_sub(1);
+                break;
+            }
+            task(k);
+            if (leaveOverShare()) break;
+        }
+        t_session = outer;
+        finished.release();
+    };
+
+    for (;;) {
+        // 补足协助线程 (调用线程自身占一个份额)；没有空闲线程时由调用线程独自完成
+        int h = helpers.load();
+        while (next.load() < count && h < share(pool) - 1) {
+            if (!helpers.compare_exchange_weak(h, h + 1)) continue;
+            if (!pool->tryStart(helper)) {
+                helpers.fetch_sub(1);
+                break;
+            }
+            ++started;
+            h = helpers.load();
+        }
+        int k = next.fetch_add(1);
+        if (k >= count) break;
+        task(k);
+    }
+    finished.acquire(started);
+}
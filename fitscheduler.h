@@ -0,0 +1,57 @@
+/*
+ * fitscheduler.h
+ * 文件作用：多个拟合会话 (拟合页各分析页签) 并发时的线程调度
+ * 功能描述：
+ * 1. 会话在拟合期间登记 (RAII)，外层并发任务 (多起点) 的线程数按活动会话数均分全局线程池
+ * 2. run(): 调用线程自身执行任务，另按公平份额以 tryStart 借用空闲线程协助；只借用空闲线程、不排队，
+ *    多个会话同时等待也不会互相占满线程池而死锁
+ * 3. 协助线程连续领取任务直到全部领完；份额在每个任务之后重新计算，会话开始后超出份额的协助线程退出，会话结束后其余会话补足协助线程
+ * 4. runEngineBatch(): 引擎计算批次 (雅可比列、解析灵敏度分块、差分进化种群、叠加分块) 以同样方式借用引擎线程池，
+ *    每个会话占用的引擎线程数不超过引擎线程池的公平份额，各会话的批次按份额并行而不是按提交顺序排队
+ * 5. 会话记录在登记线程中，并传递给协助线程，同一会话的各批次共用一个份额
+ */
+
+#ifndef FITSCHEDULER_H
+#define FITSCHEDULER_H
+
+#include <atomic>
+#include <functional>
+
+class QThreadPool;
+
+class FitScheduler
+{
+public:
+    // 拟合会话登记: 构造时活动会话数加一，析构时减一
+    class Session
+    {
+    public:
+        Session();
+        ~Session();
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+    private:
+        friend class FitScheduler;
+        Session* m_outer;                      // 同一线程中外层的会话 (通常为空)
+        std::atomic<int> m_poolHelpers;        // 本会话在全局线程池中的协助线程数
+        std::atomic<int> m_engineHelpers;      // 本会话在引擎线程池中的协助线程数
+    };
+
+    static int activeSessions();
+    // 每个会话可同时占用的全局线程池线程数 (含调用线程，至少 1)
+    static int fairShare();
+    // 每个会话可同时占用的引擎线程池线程数 (含调用线程，至少 1)
+    static int engineShare();
+
+    // 执行 task(0) ... task(count - 1) 各一次 (顺序与线程不定)，全部完成后返回
+    static void run(int count, const std::function<void(int index)>& task);
+    // 同 run()，协助线程借用引擎线程池 (不在会话中调用时份额为整个引擎线程池)
+    static void runEngineBatch(int count, const std::function<void(int index)>& task);
+
+private:
+    static int share(QThreadPool* pool);
+    static void runOn(QThreadPool* pool, std::atomic<int> Session::*helpers, int count, const std::function<void(int index)>& task);
+};
+
+#endif // FITSCHEDULER_H
@@ -0,0 +1,316 @@
+/*
+ * fittingcore.cpp
+ * 文件作用：Levenberg-Marquardt 拟合核心实现
+ * 功能描述：
+ * 1. 残差: 压力段 (ln p_obs - ln p_cal) * w，导数段 (ln d_obs - ln d_cal) * (1 - w)，无效点为 0
+ * 2. 对数参数以 log10 为自变量 (差分步长 0.01)，其余参数差分步长 1e-4
+ * 3. 阻尼: H_ii += λ (1 + |H_ii|)，接受则 λ/10，否则 λ*10
+ * 4. Broyden 修正: J += (Δr - J s) sᵀ / (sᵀ s)，s 为截断后的实际步长；修正后的雅可比使步被拒绝时先重新差分再判断是否停止
+ * 5. 解析雅可比: ∂r/∂x = -w ∂p/∂θ / p · ∂θ/∂x (对数参数 ∂θ/∂x = θ ln10)；Bourdet 导数对 Δp 线性，其偏导即偏导曲线的 Bourdet 导数
+ */
+
+#include "fittingcore.h"
+#include "fitscheduler.h"
+
+#include <QThreadPool>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+FittingCore::Observations FittingCore::Observations::prepare(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
+{
+    Observations obs;
+    obs.t = t;
+    int n = qMin(t.size(), p.size());
+    int nd = qMin(n, d.size());
+    obs.logP = Eigen::VectorXd::Zero(n);
+    obs.maskP = Eigen::VectorXd::Zero(n);
+    obs.logD = Eigen::VectorXd::Zero(nd);
+    obs.maskD = Eigen::VectorXd::Zero(nd);
+    for (int i = 0; i < n; ++i) {
+        if (p[i] > 1e-10) { obs.logP(i) = std::log(p[i]); obs.maskP(i) = 1.0; }
+    }
+    for (int i = 0; i < nd; ++i) {
+        if (d[i] > 1e-10) { obs.logD(i) = std::log(d[i]); obs.maskD(i) = 1.0; }
+    }
+    return obs;
+}
+
+FittingCore::FittingCore(const Observations& obs, const QVector<Bound>& bounds, double weight, const Options& options)
+    : m_obs(obs)
+    , m_bounds(bounds)
+    , m_weight(weight)
+    , m_options(options)
+    , m_nRes(obs.pressureCount() + obs.derivativeCount())
+    , m_nParams(bounds.size())
+    , m_evaluations(0)
+{
+    m_r.resize(m_nRes);
+    m_rTrial.resize(m_nRes);
+    m_J.resize(m_nRes, m_nParams);
+    m_rPlus.resize(m_nRes, m_nParams);
+    m_rMinus.resize(m_nRes, m_nParams);
+    m_H.resize(m_nParams, m_nParams);
+    m_Hlm.resize(m_nParams, m_nParams);
+    m_g.resize(m_nParams);
+    m_delta.resize(m_nParams);
+    m_step.resize(m_nParams);
+    m_predicted.resize(m_nRes);
+    m_ldlt = Eigen::LDLT<Eigen::MatrixXd>(m_nParams);
+}
+
+void FittingCore::updateDerivedParameters(QMap<QString, double>& params)
+{
+    if (params.contains("L") && params.contains("Lf") && params["L"] > 1e-9) params["LfD"] = params["Lf"] / params["L"];
+}
+
+bool FittingCore::isLogParameter(const QString& name, double value)
+{
+    return value > 1e-12 && name != "S" && name != "nf";
+}
+
+void FittingCore::residuals(const ModelCurveData& curve, Eigen::Ref<Eigen::VectorXd> r) const
+{
+    const QVector<double>& pCal = std::get<1>(curve);
+    const QVector<double>& dCal = std::get<2>(curve);
+    int n = m_obs.pressureCount(), nd = m_obs.derivativeCount();
+    double wp = m_weight, wd = 1.0 - m_weight;
+
+    int np = qMin(n, int(pCal.size()));
+    for (int i = 0; i < np; ++i) r(i) = (m_obs.maskP(i) != 0.0 && pCal[i] > 1e-10) ? (m_obs.logP(i) - std::log(pCal[i])) * wp : 0.0;
+    for (int i = np; i < n; ++i) r(i) = 0.0;
+
+    int ndc = qMin(nd, qMin(np, int(dCal.size())));
+    for (int i = 0; i < ndc; ++i) r(n + i) = (m_obs.maskD(i) != 0.0 && dCal[i] > 1e-10) ? (m_obs.logD(i) - std::log(dCal[i])) * wd : 0.0;
+    for (int i = ndc; i < nd; ++i) r(n + i) = 0.0;
+}
+
+QString FittingCore::Result::summary() const
+{
+    return QString("迭代 %1 次，模型计算 %2 次 (雅可比差分 %3 次，解析雅可比 %4 次，Broyden 修正 %5 次，拒绝试探步 %6 次)，MSE %7")
+        .arg(iterations).arg(modelEvaluations).arg(jacobianRefreshes).arg(analyticJacobians).arg(broydenUpdates).arg(rejectedTrials)
+        .arg(mse, 0, 'e', 3);
+}
+
+double FittingCore::evaluate(const ModelFunction& model, const QMap<QString, double>& params, Eigen::Ref<Eigen::VectorXd> r, ModelCurveData& curve)
+{
+    ++m_evaluations;
+    curve = model(params);
+    residuals(curve, r);
+    return r.squaredNorm();
+}
+
+bool FittingCore::computeAnalyticJacobian(const QMap<QString, double>& params)
+{
+    QStringList names;
+    for (const Bound& b : m_bounds) names << b.name;
+
+    // 各时间点相互独立: 按块在引擎线程池中并发 (本会话的公平份额)，块内一次得到全部偏导
+    const QVector<double>& t = m_obs.t;
+    int n = t.size();
+    int chunks = qBound(1, n / 8, qMax(1, ModelSolver01_06::enginePool()->maxThreadCount()));
+    QVector<QVector<double>> pChunk(chunks);
+    QVector<QVector<QVector<double>>> dpChunk(chunks);
+    QVector<int> ok(chunks, 0);
+    FitScheduler::runEngineBatch(chunks, [&](int c) {
+        int begin = c * n / chunks, end = (c + 1) * n / chunks;
+        ok[c] = m_sensitivity(params, names, t.mid(begin, end - begin), pChunk[c], dpChunk[c]) ? 1 : 0;
+    });
+    if (ok.contains(0)) return false;
+
+    QVector<double> p;
+    QVector<QVector<double>> dp(m_nParams);
+    p.reserve(n);
+    for (int c = 0; c < chunks; ++c) {
+        p += pChunk[c];
+        for (int j = 0; j < m_nParams; ++j) dp[j] += dpChunk[c][j];
+    }
+    QVector<double> d = ModelSolver01_06::bourdetDerivative(t, p);
+
+    // 与 residuals() 相同的有效点判断，无效项的偏导为 0
+    int np = m_obs.pressureCount(), nd = m_obs.derivativeCount();
+    int ndc = qMin(nd, np);
+    double wp = m_weight, wd = 1.0 - m_weight;
+    m_J.setZero();
+    for (int j = 0; j < m_nParams; ++j) {
+        const QString& name = m_bounds[j].name;
+        double val = params.value(name);
+        double scale = isLogParameter(name, val) ? val * std::log(10.0) : 1.0;
+        QVector<double> dd = ModelSolver01_06::bourdetDerivative(t, dp[j]);
+        for (int i = 0; i < np; ++i) {
+            if (m_obs.maskP(i) != 0.0 && p[i] > 1e-10) m_J(i, j) = -wp * dp[j][i] / p[i] * scale;
+        }
+        for (int i = 0; i < ndc; ++i) {
+            if (m_obs.maskD(i) != 0.0 && d[i] > 1e-10) m_J(np + i, j) = -wd * dd[i] / d[i] * scale;
+        }
+    }
+    return m_J.allFinite();
+}
+
+bool FittingCore::computeJacobian(const ModelFunction& model, const QMap<QString, double>& params)
+{
+    if (m_sensitivity && computeAnalyticJacobian(params)) return true;
+
+    // 各列的正/负扰动互相独立: 先生成全部 2*nParams 组参数，再在引擎线程池中按本会话的公平份额并发计算
+    QVector<double> steps(m_nParams);
+    QVector<QMap<QString, double>> perturbed;
+    perturbed.reserve(2 * m_nParams);
+    for (int j = 0; j < m_nParams; ++j) {
+        const QString& name = m_bounds[j].name;
+        double val = params.value(name);
+        QMap<QString, double> pPlus = params, pMinus = params;
+        double h;
+        if (isLogParameter(name, val)) {
+            h = 0.01;
+            double valLog = std::log10(val);
+            pPlus[name] = std::pow(10.0, valLog + h);
+            pMinus[name] = std::pow(10.0, valLog - h);
+        } else {
+            h = 1e-4;
+            pPlus[name] = val + h;
+            pMinus[name] = val - h;
+        }
+        if (name == "L" || name == "Lf") { updateDerivedParameters(pPlus); updateDerivedParameters(pMinus); }
+        steps[j] = h;
+        perturbed << pPlus << pMinus;
+    }
+
+    FitScheduler::runEngineBatch(perturbed.size(), [this, &model, &perturbed](int k) {
+        if (k % 2 == 0) residuals(model(perturbed[k]), m_rPlus.col(k / 2));
+        else residuals(model(perturbed[k]), m_rMinus.col(k / 2));
+    });
+    m_evaluations += perturbed.size();
+
+    for (int j = 0; j < m_nParams; ++j) m_J.col(j) = (m_rPlus.col(j) - m_rMinus.col(j)) / (2.0 * steps[j]);
+    return false;
+}
+
+void FittingCore::applyStep(const QMap<QString, double>& from, const Eigen::VectorXd& delta, QMap<QString, double>& to, Eigen::VectorXd& step) const
+{
+    to = from;
+    for (int i = 0; i < m_nParams; ++i) {
+        const Bound& b = m_bounds[i];
+        double oldVal = from.value(b.name);
+        bool isLog = isLogParameter(b.name, oldVal);
+        double newVal = isLog ? std::pow(10.0, std::log10(oldVal) + delta(i)) : oldVal + delta(i);
+        newVal = qMax(b.min, qMin(newVal, b.max));
+        to[b.name] = newVal;
+        step(i) = (isLog && newVal > 0.0) ? std::log10(newVal) - std::log10(oldVal) : newVal - oldVal;
+    }
+    updateDerivedParameters(to);
+}
+
+FittingCore::Result FittingCore::run(const ModelFunction& model, const QMap<QString, double>& start, const Callbacks& callbacks)
+{
+    Result result;
+    result.params = start;
+    updateDerivedParameters(result.params);
+    m_evaluations = 0;
+    if (m_nRes == 0) return result;
+
+    auto stopRequested = [&]() { return callbacks.stopRequested && callbacks.stopRequested(); };
+    double sse = evaluate(model, result.params, m_r, m_curve);
+    if (stopRequested()) {
+        // 初始点的计算可能已被取消，残差不可用
+        result.stopped = true;
+        result.sse = result.mse = std::numeric_limits<double>::infinity();
+        result.modelEvaluations = m_evaluations;
+        return result;
+    }
+    if (callbacks.accepted) callbacks.accepted(sse / m_nRes, result.params, m_curve);
+
+    double lambda = m_options.initialLambda;
+    QMap<QString, double> trial;
+    bool needRefresh = true;
+    bool jacobianUpdated = false;   // 上次重新计算后 J 是否被 Broyden 修正过
+    int sinceRefresh = 0;
+    int stallCount = 0;
+    int iter = 0;
+    for (; iter < m_options.maxIterations && m_nParams > 0; ++iter) {
+        if (stopRequested()) { result.stopped = true; break; }
+        if (sse / m_nRes < m_options.targetMse) break;
+        if (callbacks.progress) callbacks.progress(iter, m_options.maxIterations);
+
+        if (!m_options.broydenUpdates || needRefresh || sinceRefresh >= m_options.jacobianRefreshInterval) {
+            ++(computeJacobian(model, result.params) ? result.analyticJacobians : result.jacobianRefreshes);
+            if (stopRequested()) { result.stopped = true; break; }
+            needRefresh = false;
+            jacobianUpdated = false;
+            sinceRefresh = 0;
+        }
+        // 上一轮全部试探被拒绝时 J 未被修改，仍是当前点的精确雅可比
+        bool fresh = !jacobianUpdated;
+        // 只需下三角 (LDLT 只读下三角)
+        m_H.setZero();
+        m_H.selfadjointView<Eigen::Lower>().rankUpdate(m_J.transpose());
+        m_g.noalias() = m_J.transpose() * m_r;
+
+        bool stepAccepted = false;
+        double lambdaBefore = lambda;
+        double sseBefore = sse;
+        for (int tryIter = 0; tryIter < m_options.maxTrials; ++tryIter) {
+            m_Hlm = m_H;
+            for (int i = 0; i < m_nParams; ++i) m_Hlm(i, i) += lambda * (1.0 + std::abs(m_H(i, i)));
+            m_ldlt.compute(m_Hlm);
+            m_delta = m_ldlt.solve(-m_g);
+
+            applyStep(result.params, m_delta, trial, m_step);
+            double trialSse = evaluate(model, trial, m_rTrial, m_trialCurve);
+            if (stopRequested()) { result.stopped = true; break; }
+            if (trialSse < sse) {
+                if (m_options.broydenUpdates) {
+                    // 线性模型预测的下降量，用于判断修正后的雅可比是否仍可信
+                    m_predicted.noalias() = m_J * m_step;
+                    m_predicted += m_r;
+                    double predictedDecrease = sse - m_predicted.squaredNorm();
+                    double ratio = predictedDecrease > 0.0 ? (sse - trialSse) / predictedDecrease : 0.0;
+
+                    double ss = m_step.squaredNorm();
+                    if (ss > 0.0) {
+                        // m_predicted = r + J s，故 Δr - J s = r_trial - m_predicted
+                        m_J.noalias() += ((m_rTrial - m_predicted) / ss) * m_step.transpose();
+                        jacobianUpdated = true;
+                        ++result.broydenUpdates;
+                    }
+                    ++sinceRefresh;
+                    if (ratio < m_options.refreshRatio) needRefresh = true;
+                }
+                sse = trialSse;
+                result.params = trial;
+                m_r.swap(m_rTrial);
+                std::swap(m_curve, m_trialCurve);
+                lambda /= 10.0;
+                stepAccepted = true;
+                if (callbacks.accepted) callbacks.accepted(sse / m_nRes, result.params, m_curve);
+                break;
+            }
+            ++result.rejectedTrials;
+            lambda *= 10.0;
+            // 修正后的雅可比: 一次失败即改为重新差分，避免在不可信的方向上反复试探
+            if (!fresh) break;
+        }
+        if (result.stopped) break;
+        if (!stepAccepted && !fresh) {
+            // 修正后的雅可比找不到下降方向: 重新差分后再试，不计入停止判据
+            needRefresh = true;
+            lambda = lambdaBefore;
+            continue;
+        }
+        if (!stepAccepted && lambda > m_options.maxLambda) break;
+
+        if (stepAccepted && m_options.minStepNorm > 0.0 && m_step.norm() < m_options.minStepNorm) { result.stalled = true; ++iter; break; }
+        if (m_options.stallImprovement > 0.0) {
+            // 被拒绝的迭代 (完整雅可比下找不到下降方向) 同样计为停滞
+            double improvement = sseBefore > 0.0 ? (sseBefore - sse) / sseBefore : 0.0;
+            stallCount = improvement < m_options.stallImprovement ? stallCount + 1 : 0;
+            if (stallCount >= m_options.stallIterations) { result.stalled = true; ++iter; break; }
+        }
+    }
+
+    result.sse = sse;
+    result.mse = sse / m_nRes;
+    result.iterations = iter;
+    result.modelEvaluations = m_evaluations;
+    result.curve = m_curve;
+    return result;
+}
@@ -0,0 +1,152 @@
+/*
+ * fittingcore.h
+ * 文件作用：Levenberg-Marquardt 拟合核心 (不依赖界面控件)
+ * 功能描述：
+ * 1. 观测数据预处理一次: ln p、ln dp 与有效掩码按数据集缓存，残差计算只需对理论值取对数
+ * 2. 残差、雅可比、JᵀJ 与梯度均为连续的 Eigen 存储，在构造时按残差数与拟合参数数一次分配
+ * 3. 雅可比各列的正/负扰动在引擎线程池中并发计算，结果按下标归位，可复现
+ * 4. 理论曲线由调用方提供的模型函数计算 (须线程安全)，拟合核心只负责参数变换与迭代
+ * 5. 可选拟牛顿模式: 接受步之间以 Broyden 秩一修正更新雅可比，仅在下降比变差、步被拒绝或每 k 次迭代时做完整差分
+ * 6. 每次接受步的理论曲线随回调交出，界面显示无需再解一次模型
+ * 7. 可选解析雅可比: 设置灵敏度函数后由前向自动微分一次得到全部列，失败 (含不可微参数等) 时退回差分
+ * 8. 停止请求在每次模型计算 (含雅可比) 之后检查；停止后的计算结果可能不完整 (引擎被取消)，一律丢弃
+ * 9. 可选停滞判据 (供多精度日程的低精度阶段使用): 相对下降连续过小或步长过小时提前结束
+ */
+
+#ifndef FITTINGCORE_H
+#define FITTINGCORE_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <Eigen/Dense>
+#include "modelsolver01-06.h"
+
+class FittingCore
+{
+public:
+    // 在观测时间上计算理论曲线 <t, Δp, dΔp/dln t>；会被多个线程同时调用
+    using ModelFunction = std::function<ModelCurveData(const QMap<QString, double>& params)>;
+    // 在 t 上计算 Δp 及其对 names 中各参数的偏导 dp[j][i] (参数本身，非变换空间)；不支持时返回 false
+    // 签名与 ModelSolver01_06::calculatePressureSensitivities 相同，会被多个线程同时调用
+    using SensitivityFunction = std::function<bool(const QMap<QString, double>& params, const QStringList& names, const QVector<double>& t,
+                                                   QVector<double>& p, QVector<QVector<double>>& dp)>;
+
+    // 预处理后的观测数据 (每组数据只计算一次)
+    struct Observations {
+        QVector<double> t;
+        Eigen::VectorXd logP;     // ln p (无效点为 0)
+        Eigen::VectorXd logD;     // ln dp (无效点为 0)
+        Eigen::VectorXd maskP;    // 有效为 1，否则为 0 (p <= 1e-10)
+        Eigen::VectorXd maskD;
+
+        static Observations prepare(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
+        int pressureCount() const { return int(logP.size()); }
+        int derivativeCount() const { return int(logD.size()); }
+        bool isEmpty() const { return logP.size() == 0; }
+    };
+
+    // 参与拟合的参数及其范围
+    struct Bound {
+        QString name;
+        double min;
+        double max;
+
+        // 全局搜索 (多起点、差分进化) 在 log10 空间中采样的参数: 下限为正的对数参数
+        bool isLogScale() const { return isLogParameter(name, min) && max > min; }
+    };
+
+    struct Options {
+        int maxIterations = 50;
+        double initialLambda = 0.01;
+        int maxTrials = 5;            // 每次迭代最多尝试的阻尼系数个数
+        double targetMse = 3e-3;      // 均方误差低于此值即停止
+        double maxLambda = 1e10;      // 无法下降且阻尼超过此值时停止
+
+        // Broyden 秩一修正 (每次完整差分需 2*nParams 次模型计算，修正不需要)
+        bool broydenUpdates = false;
+        int jacobianRefreshInterval = 5;   // 最多连续修正的迭代数
+        double refreshRatio = 0.25;        // 实际下降 / 线性模型预测下降低于此值时下一次迭代重新差分
+
+        // 停滞判据 (0 表示不启用): 连续 stallIterations 次迭代的相对下降 Δsse/sse 低于 stallImprovement，
+        // 或接受步的步长范数 (变换空间，对数参数为 log10) 低于 minStepNorm 时结束，Result::stalled 置位
+        double stallImprovement = 0.0;
+        int stallIterations = 2;
+        double minStepNorm = 0.0;
+    };
+
+    // 迭代过程回调 (均在拟合线程中调用，可为空)
+    struct Callbacks {
+        // 通常与模型函数所用引擎的取消标志 (ModelSolver01_06::setCancelFlag) 一致
+        std::function<bool()> stopRequested;
+        std::function<void(int iteration, int maxIterations)> progress;
+        // 初始点与每次接受的步；curve 为该点在观测时间上的理论曲线 (即计算残差所用的曲线)
+        std::function<void(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)> accepted;
+    };
+
+    struct Result {
+        QMap<QString, double> params;
+        double sse = 0.0;
+        double mse = 0.0;
+        int iterations = 0;
+        qint64 modelEvaluations = 0;
+        int jacobianRefreshes = 0;     // 完整差分雅可比次数
+        int analyticJacobians = 0;     // 由灵敏度函数得到的雅可比次数 (不计入模型计算次数)
+        int broydenUpdates = 0;        // 秩一修正次数
+        int rejectedTrials = 0;        // 被拒绝的试探步数 (每个都是一次完整的模型计算)
+        bool stopped = false;          // 因停止请求结束 (结果为此前最后接受的点；初始点未算完时 mse 为无穷大)
+        bool stalled = false;          // 因停滞判据结束
+        ModelCurveData curve;          // 最终参数在观测时间上的理论曲线
+
+        // 单行文本摘要，供界面显示
+        QString summary() const;
+    };
+
+    FittingCore(const Observations& obs, const QVector<Bound>& bounds, double weight, const Options& options);
+
+    // 设置后完整雅可比优先用灵敏度函数计算 (模型函数含叠加等灵敏度函数不能表达的变换时不要设置)
+    void setSensitivityFunction(const SensitivityFunction& sensitivity) { m_sensitivity = sensitivity; }
+
+    Result run(const ModelFunction& model, const QMap<QString, double>& start, const Callbacks& callbacks = Callbacks());
+
+    int residualCount() const { return m_nRes; }
+
+    // 理论曲线 -> 残差 (写入预分配的 r)，曲线点数不足时缺少的项记为 0
+    void residuals(const ModelCurveData& curve, Eigen::Ref<Eigen::VectorXd> r) const;
+
+    // 参数依赖: LfD = Lf / L
+    static void updateDerivedParameters(QMap<QString, double>& params);
+    // 在 log10 空间中拟合的参数 (正值且非表皮系数、裂缝条数)
+    static bool isLogParameter(const QString& name, double value);
+
+private:
+    double evaluate(const ModelFunction& model, const QMap<QString, double>& params, Eigen::Ref<Eigen::VectorXd> r, ModelCurveData& curve);
+    // 返回 true 表示使用了解析雅可比
+    bool computeJacobian(const ModelFunction& model, const QMap<QString, double>& params);
+    bool computeAnalyticJacobian(const QMap<QString, double>& params);
+    // 施加步长 delta 并截断到参数范围，step 写入截断后的实际步长 (与 delta 同一变换空间)
+    void applyStep(const QMap<QString, double>& from, const Eigen::VectorXd& delta, QMap<QString, double>& to, Eigen::VectorXd& step) const;
+
+private:
+    Observations m_obs;
+    QVector<Bound> m_bounds;
+    double m_weight;
+    Options m_options;
+    SensitivityFunction m_sensitivity;
+    int m_nRes;
+    int m_nParams;
+    qint64 m_evaluations;
+
+    // 预分配缓冲区
+    Eigen::VectorXd m_r, m_rTrial;
+    Eigen::MatrixXd m_J;
+    Eigen::MatrixXd m_rPlus, m_rMinus;
+    Eigen::MatrixXd m_H, m_Hlm;
+    Eigen::VectorXd m_g, m_delta, m_step, m_predicted;
+    Eigen::LDLT<Eigen::MatrixXd> m_ldlt;
+    ModelCurveData m_curve, m_trialCurve;   // 当前点 / 试探点的理论曲线
+};
+
+#endif // FITTINGCORE_H
@@ -0,0 +1,228 @@
+/*
+ * fittingevolution.cpp
+ * 文件作用：差分进化全局拟合实现
+ * 功能描述：
+ * 1. 变异 v = x_i + F (x_pbest - x_i) + F (x_r1 - x_r2)，F 每个个体在 [0.5, 0.9] 内随机，x_pbest 取自误差最小的 p 部分
+ * 2. 越界分量取父代与边界的中点，保证个体始终在范围内
+ * 3. 目标函数为 FittingCore 的加权对数残差的均方误差，与 LM 完全一致，精修可直接接续
+ */
+
+#include "fittingevolution.h"
+#include "fittingmultistart.h"
+#include "fitscheduler.h"
+
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+FittingCore::Options polishOptions(FittingCore::Options options, double targetMse)
+{
+    options.targetMse = targetMse;
+    return options;
+}
+
+}
+
+QString FittingEvolution::Result::summary() const
+{
+    QString text = QString("差分进化 %1 代，模型计算 %2 次 (其中低精度 %3 次)，MSE %4")
+        .arg(generations).arg(evaluations).arg(coarseEvaluations).arg(mse, 0, 'e', 3);
+    if (polished) text += "；LM 精修: " + polish.summary();
+    return text;
+}
+
+FittingEvolution::FittingEvolution(const FittingCore::Observations& obs, const QVector<FittingCore::Bound>& bounds, double weight,
+                                   const Options& options, const FittingCore::Options& lmOptions)
+    : m_core(obs, bounds, weight, polishOptions(lmOptions, options.targetMse))
+    , m_bounds(bounds)
+    , m_options(options)
+{
+    int n = bounds.size();
+    m_lower.resize(n);
+    m_upper.resize(n);
+    for (int d = 0; d < n; ++d) {
+        const FittingCore::Bound& b = bounds[d];
+        bool isLog = b.isLogScale();
+        m_lower(d) = isLog ? std::log10(b.min) : b.min;
+        m_upper(d) = isLog ? std::log10(b.max) : b.max;
+    }
+}
+
+void FittingEvolution::toParams(const Eigen::Ref<const Eigen::VectorXd>& x, QMap<QString, double>& params) const
+{
+    for (int d = 0; d < m_bounds.size(); ++d) {
+        const FittingCore::Bound& b = m_bounds[d];
+        params[b.name] = b.isLogScale() ? std::pow(10.0, x(d)) : x(d);
+    }
+    FittingCore::updateDerivedParameters(params);
+}
+
+Eigen::VectorXd FittingEvolution::fromParams(const QMap<QString, double>& params) const
+{
+    Eigen::VectorXd x(m_bounds.size());
+    for (int d = 0; d < m_bounds.size(); ++d) {
+        const FittingCore::Bound& b = m_bounds[d];
+        double v = qBound(b.min, params.value(b.name), b.max);
+        x(d) = b.isLogScale() ? std::log10(v) : v;
+    }
+    return x;
+}
+
+FittingEvolution::Result FittingEvolution::run(const FittingCore::ModelFunction& model, const FittingCore::ModelFunction& coarseModel,
+                                               const QMap<QString, double>& start, const Callbacks& callbacks)
+{
+    Result res;
+    res.params = start;
+    FittingCore::updateDerivedParameters(res.params);
+    int n = m_bounds.size();
+    int nRes = m_core.residualCount();
+    if (n == 0 || nRes == 0) return res;
+
+    int np = m_options.populationSize > 0 ? qMax(4, m_options.populationSize) : qBound(16, 10 * n, 64);
+    qint64 budget = qMax<qint64>(np, m_options.maxEvaluations);
+    bool coarse = coarseModel && m_options.coarseFraction > 0.0;
+    qint64 coarseBudget = coarse ? qint64(m_options.coarseFraction * budget) : 0;
+    auto stopRequested = [&]() { return callbacks.stopRequested && callbacks.stopRequested(); };
+
+    // ---------------- 初始种群: 用户初值 + 拉丁超立方 ----------------
+    QRandomGenerator rng(m_options.seed);
+    QVector<QMap<QString, double>> seeds = FittingMultiStart::startingPoints(res.params, m_bounds, np, rng.generate());
+    Eigen::MatrixXd X(n, np), U(n, np);
+    for (int k = 0; k < np; ++k) X.col(k) = fromParams(seeds[k]);
+    Eigen::VectorXd cost(np), trialCost(np);
+    Eigen::MatrixXd R(nRes, np);
+    QVector<ModelCurveData> curves(np);
+
+    double bestMse = std::numeric_limits<double>::infinity();
+    Eigen::VectorXd bestX = X.col(0);
+    ModelCurveData bestCurve;
+
+    // 整个种群 (或试验种群) 在引擎线程池中按本会话的公平份额并发计算；精确模型下更新全局最优
+    auto evaluate = [&](const Eigen::MatrixXd& P, Eigen::VectorXd& c) {
+        const FittingCore::ModelFunction& f = coarse ? coarseModel : model;
+        FitScheduler::runEngineBatch(np, [&](int k) {
+            QMap<QString, double> p = res.params;
+            toParams(P.col(k), p);
+            curves[k] = f(p);
+            m_core.residuals(curves[k], R.col(k));
+            double mse = R.col(k).squaredNorm() / nRes;
+            c(k) = std::isfinite(mse) ? mse : std::numeric_limits<double>::infinity();
+        });
+        res.evaluations += np;
+        // 停止时本批计算可能已被取消，误差不可用: 保留上一批的误差
+        if (stopRequested()) return false;
+        if (coarse) { res.coarseEvaluations += np; return true; }
+        int k;
+        double m = c.minCoeff(&k);
+        if (m < bestMse) {
+            bestMse = m;
+            bestX = P.col(k);
+            bestCurve = curves[k];
+            if (callbacks.improved) {
+                QMap<QString, double> p = res.params;
+                toParams(bestX, p);
+                callbacks.improved(bestMse, p, bestCurve);
+            }
+        }
+        return true;
+    };
+
+    if (!evaluate(X, cost)) {
+        res.stopped = true;
+        res.mse = std::numeric_limits<double>::infinity();
+        return res;
+    }
+    QVector<int> order(np);
+    int pCount = qBound(2, int(std::ceil(m_options.greediness * np)), np);
+    while (!stopRequested()) {
+        if (callbacks.progress) callbacks.progress(res.evaluations, budget);
+        if (!coarse && bestMse < m_options.targetMse) break;
+        if (res.evaluations + np > budget) break;
+
+        double cMin = cost.minCoeff(), cMax = cost.maxCoeff();
+        bool converged = cMax - cMin <= m_options.tolerance * qMax(cMin, 1e-300);
+        if (coarse && (converged || res.evaluations >= coarseBudget)) {
+            // 低精度阶段结束: 以精确模型重新计算整个种群，之后的选择才可比
+            coarse = false;
+            if (!evaluate(X, trialCost)) { coarse = true; break; }
+            cost = trialCost;
+            continue;
+        }
+        if (converged) break;
+
+        // ---------------- 变异与交叉 ----------------
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + pCount, order.end(), [&](int a, int b) { return cost(a) < cost(b); });
+        for (int i = 0; i < np; ++i) {
+            double F = 0.5 + 0.4 * rng.generateDouble();
+            int pb = order[rng.bounded(pCount)];
+            int r1, r2;
+            do { r1 = rng.bounded(np); } while (r1 == i);
+            do { r2 = rng.bounded(np); } while (r2 == i || r2 == r1);
+            int jRand = rng.bounded(n);
+            for (int d = 0; d < n; ++d) {
+                double xi = X(d, i);
+                double v = xi + F * (X(d, pb) - xi) + F * (X(d, r1) - X(d, r2));
+                if (d != jRand && rng.generateDouble() >= m_options.crossover) v = xi;
+                if (v < m_lower(d)) v = 0.5 * (xi + m_lower(d));
+                else if (v > m_upper(d)) v = 0.5 * (xi + m_upper(d));
+                U(d, i) = v;
+            }
+        }
+
+        // ---------------- 选择 ----------------
+        if (!evaluate(U, trialCost)) break;
+        for (int i = 0; i < np; ++i) {
+            if (trialCost(i) <= cost(i)) {
+                X.col(i) = U.col(i);
+                cost(i) = trialCost(i);
+            }
+        }
+        ++res.generations;
+    }
+
+    res.stopped = stopRequested();
+    if (coarse && res.stopped) {
+        // 低精度阶段被停止: 取廉价模型下的最优个体，不再计算精确模型
+        int k;
+        bestMse = cost.minCoeff(&k);
+        bestX = X.col(k);
+    } else if (coarse) {
+        // 仍处于低精度阶段 (预算用尽) 时，以精确模型计算一次当前最优个体
+        int k;
+        cost.minCoeff(&k);
+        bestX = X.col(k);
+        QMap<QString, double> p = res.params;
+        toParams(bestX, p);
+        bestCurve = model(p);
+        Eigen::VectorXd r(nRes);
+        m_core.residuals(bestCurve, r);
+        bestMse = r.squaredNorm() / nRes;
+        ++res.evaluations;
+    }
+    toParams(bestX, res.params);
+    res.mse = bestMse;
+    res.curve = bestCurve;
+
+    // ---------------- LM 精修 ----------------
+    if (m_options.polish && !stopRequested() && bestMse >= m_options.targetMse) {
+        FittingCore::Callbacks lmCallbacks;
+        lmCallbacks.stopRequested = callbacks.stopRequested;
+        lmCallbacks.accepted = [&](double mse, const QMap<QString, double>& params, const ModelCurveData& curve) {
+            if (mse < bestMse && callbacks.improved) callbacks.improved(mse, params, curve);
+        };
+        res.polish = m_core.run(model, res.params, lmCallbacks);
+        res.polished = true;
+        res.stopped = res.polish.stopped;
+        if (res.polish.mse <= res.mse) {
+            res.params = res.polish.params;
+            res.mse = res.polish.mse;
+            res.curve = res.polish.curve;
+        }
+    }
+    return res;
+}
@@ -0,0 +1,81 @@
+/*
+ * fittingevolution.h
+ * 文件作用：差分进化全局拟合 (可选 Levenberg-Marquardt 精修)
+ * 功能描述：
+ * 1. 在拟合参数的 [min, max] 内搜索，对数参数在 log10 空间中变化 (与 LM、多起点一致)
+ * 2. 策略 DE/current-to-pbest/1/bin: 初始种群为用户初值 + 拉丁超立方样本，每代的试验个体在引擎线程池中并发计算
+ * 3. 模型计算次数受预算限制；预算的前一部分可使用廉价的模型函数 (低精度档)，切换时整个种群以精确模型重新计算
+ * 4. 达到目标误差、种群误差收敛、预算用尽或用户停止时结束，之后可从最优个体出发做一次 LM 精修
+ */
+
+#ifndef FITTINGEVOLUTION_H
+#define FITTINGEVOLUTION_H
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "fittingcore.h"
+
+class FittingEvolution
+{
+public:
+    struct Options {
+        int populationSize = 0;          // 0 时取 10 * 参数数 (限制在 16 ~ 64)
+        int maxEvaluations = 3000;       // 模型计算预算 (不含 LM 精修)
+        double coarseFraction = 0.5;     // 预算中使用廉价模型的比例 (未提供廉价模型时忽略)
+        double crossover = 0.9;          // 交叉概率 CR
+        double greediness = 0.2;         // p-best 的比例 p
+        double targetMse = 3e-3;
+        double tolerance = 1e-6;         // 种群误差相对极差低于此值视为收敛
+        bool polish = true;              // 结束后以 LM 精修最优个体
+        quint32 seed = 1;
+    };
+
+    // 回调在拟合线程中调用 (可为空)
+    struct Callbacks {
+        std::function<bool()> stopRequested;
+        std::function<void(qint64 evaluations, qint64 budget)> progress;
+        // 精确模型下出现更小的均方误差时调用
+        std::function<void(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)> improved;
+    };
+
+    struct Result {
+        QMap<QString, double> params;
+        double mse = 0.0;
+        int generations = 0;
+        qint64 evaluations = 0;          // 差分进化的模型计算次数 (含廉价模型)
+        qint64 coarseEvaluations = 0;    // 其中廉价模型的次数
+        bool stopped = false;            // 因停止请求结束 (低精度阶段停止时 mse 为廉价模型的误差，曲线为空)
+        bool polished = false;
+        FittingCore::Result polish;      // LM 精修的结果 (polished 为 true 时有效)
+        ModelCurveData curve;            // 最终参数在观测时间上的理论曲线
+
+        // 单行文本摘要，供界面显示
+        QString summary() const;
+    };
+
+    // lmOptions 用于精修 (其 targetMse 被 options.targetMse 覆盖)
+    FittingEvolution(const FittingCore::Observations& obs, const QVector<FittingCore::Bound>& bounds, double weight,
+                     const Options& options, const FittingCore::Options& lmOptions);
+
+    // LM 精修使用解析雅可比 (见 FittingCore::setSensitivityFunction)
+    void setSensitivityFunction(const FittingCore::SensitivityFunction& sensitivity) { m_core.setSensitivityFunction(sensitivity); }
+
+    // coarseModel 为空时全程使用 model；两者都会被多个线程同时调用
+    Result run(const FittingCore::ModelFunction& model, const FittingCore::ModelFunction& coarseModel,
+               const QMap<QString, double>& start, const Callbacks& callbacks);
+
+private:
+    // 变换空间坐标 <-> 参数表
+    void toParams(const Eigen::Ref<const Eigen::VectorXd>& x, QMap<QString, double>& params) const;
+    Eigen::VectorXd fromParams(const QMap<QString, double>& params) const;
+
+private:
+    FittingCore m_core;                  // 只用于残差计算与精修
+    QVector<FittingCore::Bound> m_bounds;
+    Options m_options;
+    Eigen::VectorXd m_lower, m_upper;    // 变换空间中的范围
+};
+
+#endif // FITTINGEVOLUTION_H
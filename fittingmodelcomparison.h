@@ -0,0 +1,64 @@
+/*
+ * fittingmodelcomparison.h
+ * 文件作用：候选模型的并发拟合与排序 (模型判别)
+ * 功能描述：
+ * 1. 每个候选模型 (引擎、初值与拟合参数) 以多精度日程 (FittingSchedule) 独立拟合，各候选由 FitScheduler 并发执行
+ * 2. 全部候选使用同一组观测数据与权重，最终阶段的 SSE 可直接比较
+ * 3. 按 AIC 升序排列，同时给出 SSE 与 BIC: AIC = n ln(SSE/n) + 2k，BIC = n ln(SSE/n) + k ln n (n 为有效残差数，k 为拟合参数数)
+ * 4. 停止请求对全部候选生效，已停止的候选保留此前最好的结果 (未进入最终阶段的候选不参与比较)
+ */
+
+#ifndef FITTINGMODELCOMPARISON_H
+#define FITTINGMODELCOMPARISON_H
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "fittingschedule.h"
+
+class FittingModelComparison
+{
+public:
+    struct Candidate {
+        ModelSolver01_06 solver;               // 该模型的引擎 (最终精度)
+        QMap<QString, double> start;
+        QVector<FittingCore::Bound> bounds;
+    };
+
+    struct Ranked {
+        int candidate = 0;                     // 在候选列表中的下标
+        FittingSchedule::Result fit;
+        int parameterCount = 0;                // k
+        double sse = 0.0;
+        double aic = 0.0;
+        double bic = 0.0;
+    };
+
+    // 回调可能在多个线程中调用；progress 已串行化
+    struct Callbacks {
+        std::function<bool()> stopRequested;
+        std::function<void(int finished, int total)> progress;
+    };
+
+    FittingModelComparison(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, double weight,
+                           const FittingCore::Options& options);
+
+    // 并发拟合全部候选，返回按 AIC 升序排列的结果 (不可比较的候选 SSE 为无穷大，排在最后)
+    QVector<Ranked> run(const QVector<Candidate>& candidates, const FittingSchedule::ModelFactory& model,
+                        const FittingSchedule::SensitivityFactory& sensitivity, const Callbacks& callbacks) const;
+
+    // 有效残差数 n (压力与导数中的有效点)
+    int residualCount() const { return m_residualCount; }
+
+    static double aic(double sse, int n, int k);
+    static double bic(double sse, int n, int k);
+
+private:
+    QVector<double> m_t, m_p, m_d;
+    double m_weight;
+    FittingCore::Options m_options;
+    int m_residualCount;
+};
+
+#endif // FITTINGMODELCOMPARISON_H
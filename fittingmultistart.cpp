@@ -0,0 +1,107 @@
+/*
+ * fittingmultistart.cpp
+ * 文件作用：多起点 Levenberg-Marquardt 拟合实现
+ * 功能描述：
+ * 1. 拉丁超立方: 每个参数把区间等分为 count - 1 层，各层恰好取一个点，层序逐参数独立随机排列
+ * 2. 每个起点一个 FittingCore (各自预分配缓冲区)，停止判据与改进回调在起点间共享
+ */
+
+#include "fittingmultistart.h"
+#include "fitscheduler.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+FittingMultiStart::FittingMultiStart(const FittingCore::Observations& obs, const QVector<FittingCore::Bound>& bounds, double weight,
+                                     const FittingCore::Options& options)
+    : m_obs(obs)
+    , m_bounds(bounds)
+    , m_weight(weight)
+    , m_options(options)
+{
+}
+
+QVector<QMap<QString, double>> FittingMultiStart::startingPoints(const QMap<QString, double>& base, const QVector<FittingCore::Bound>& bounds,
+                                                                 int count, quint32 seed)
+{
+    QVector<QMap<QString, double>> starts;
+    if (count < 1) return starts;
+    starts.reserve(count);
+    starts.append(base);
+
+    int n = count - 1;
+    if (n == 0) return starts;
+    QRandomGenerator rng(seed);
+    for (int k = 0; k < n; ++k) starts.append(base);
+
+    QVector<int> strata(n);
+    for (const FittingCore::Bound& b : bounds) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng);
+        // 与拟合核心相同的变换: 正的对数参数在 log10 空间中均匀分层
+        bool isLog = b.isLogScale();
+        double lo = isLog ? std::log10(b.min) : b.min;
+        double hi = isLog ? std::log10(b.max) : b.max;
+        for (int k = 0; k < n; ++k) {
+            double u = (strata[k] + rng.generateDouble()) / n;
+            double x = lo + u * (hi - lo);
+            starts[k + 1][b.name] = isLog ? std::pow(10.0, x) : x;
+        }
+    }
+    return starts;
+}
+
+QVector<FittingMultiStart::Run> FittingMultiStart::run(const FittingCore::ModelFunction& model, const QVector<QMap<QString, double>>& starts,
+                                                       const Callbacks& callbacks) const
+{
+    int total = starts.size();
+    QVector<Run> runs(total);
+
+    std::atomic<bool> finishedEarly(false);
+    QMutex mutex;
+    double bestMse = std::numeric_limits<double>::infinity();
+    int finished = 0;
+
+    FittingCore::Callbacks coreCallbacks;
+    coreCallbacks.stopRequested = [&]() {
+        if (finishedEarly.load(std::memory_order_relaxed)) return true;
+        return callbacks.stopRequested && callbacks.stopRequested();
+    };
+    coreCallbacks.accepted = [&](double mse, const QMap<QString, double>& params, const ModelCurveData& curve) {
+        if (mse < m_options.targetMse) finishedEarly.store(true, std::memory_order_relaxed);
+        QMutexLocker locker(&mutex);
+        if (mse >= bestMse) return;
+        bestMse = mse;
+        if (callbacks.improved) callbacks.improved(mse, params, curve);
+    };
+
+    // 外层各起点按公平份额在全局线程池中并发；每个 FittingCore 的雅可比差分在引擎线程池中执行
+    FitScheduler::run(total, [&](int k) {
+        Run& r = runs[k];
+        r.index = k;
+        r.start = starts[k];
+        if (coreCallbacks.stopRequested()) {
+            // 尚未开始的起点直接放弃
+            r.result.params = starts[k];
+            r.result.stopped = true;
+            r.result.sse = r.result.mse = std::numeric_limits<double>::infinity();
+        } else {
+            FittingCore core(m_obs, m_bounds, m_weight, m_options);
+            core.setSensitivityFunction(m_sensitivity);
+            r.result = core.run(model, starts[k], coreCallbacks);
+        }
+
+        QMutexLocker locker(&mutex);
+        ++finished;
+        if (callbacks.progress) callbacks.progress(finished, total);
+    });
+
+    std::stable_sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) { return a.result.mse < b.result.mse; });
+    return runs;
+}
@@ -0,0 +1,57 @@
+/*
+ * fittingmultistart.h
+ * 文件作用：多起点 Levenberg-Marquardt 拟合
+ * 功能描述：
+ * 1. 在各拟合参数的 [min, max] 内按拉丁超立方抽取起点 (对数参数在 log10 空间分层，与 FittingCore 一致)
+ * 2. 各起点的拟合由 FitScheduler 在全局线程池中并发执行 (线程数为本会话的公平份额)，雅可比差分仍在引擎线程池中并发
+ * 3. 共享提前终止: 任一起点达到目标误差或用户停止时，其余起点在下一次迭代前结束
+ * 4. 结果按均方误差升序排列，供界面列出各局部极小
+ */
+
+#ifndef FITTINGMULTISTART_H
+#define FITTINGMULTISTART_H
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "fittingcore.h"
+
+class FittingMultiStart
+{
+public:
+    struct Run {
+        int index = 0;                       // 起点序号 (0 为用户给定的初值)
+        QMap<QString, double> start;
+        FittingCore::Result result;
+    };
+
+    // 回调可能在多个线程中调用；improved 与 progress 已串行化
+    struct Callbacks {
+        std::function<bool()> stopRequested;
+        std::function<void(int finished, int total)> progress;
+        // 全部起点中出现更小的均方误差时调用 (曲线为该点在观测时间上的理论曲线)
+        std::function<void(double mse, const QMap<QString, double>& params, const ModelCurveData& curve)> improved;
+    };
+
+    FittingMultiStart(const FittingCore::Observations& obs, const QVector<FittingCore::Bound>& bounds, double weight, const FittingCore::Options& options);
+
+    // 各起点的 LM 拟合使用解析雅可比 (见 FittingCore::setSensitivityFunction)
+    void setSensitivityFunction(const FittingCore::SensitivityFunction& sensitivity) { m_sensitivity = sensitivity; }
+
+    // 第一个起点为 base 本身，其余 count - 1 个为拉丁超立方样本 (seed 相同则结果相同)
+    static QVector<QMap<QString, double>> startingPoints(const QMap<QString, double>& base, const QVector<FittingCore::Bound>& bounds,
+                                                         int count, quint32 seed);
+
+    // 并发拟合全部起点，返回按均方误差升序排列的结果
+    QVector<Run> run(const FittingCore::ModelFunction& model, const QVector<QMap<QString, double>>& starts, const Callbacks& callbacks) const;
+
+private:
+    FittingCore::Observations m_obs;
+    QVector<FittingCore::Bound> m_bounds;
+    double m_weight;
+    FittingCore::Options m_options;
+    FittingCore::SensitivityFunction m_sensitivity;
+};
+
+#endif // FITTINGMULTISTART_H
@@ -4,6 +4,8 @@
 #include "modelparameter.h"
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QProgressBar>
+#include <QTabBar>
 #include <QJsonArray>
 #include <QDebug>
 
@@ -43,6 +45,31 @@ void FittingPage::setObservedDataToCurrent(const QVector<double> &t, const QVect
     }
 }
 
+bool FittingPage::setRateHistoryToCurrent(const RateSchedule& schedule)
+{
+    FittingWidget* current = qobject_cast<FittingWidget*>(ui->tabWidget->currentWidget());
+    return current && current->setRateHistory(schedule);
+}
+
+FittingWidget* FittingPage::currentFittingWidget() const
+{
+    return qobject_cast<FittingWidget*>(ui->tabWidget->currentWidget());
+}
+
+void FittingPage::clearDeconvolvedMarks()
+{
+    for(int i = 0; i < ui->tabWidget->count(); ++i) {
+        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
+        if(w) w->clearDeconvolvedMark();
+    }
+}
+
+void FittingPage::setDeconvolutionRunning(bool running)
+{
+    ui->btnDeconvolution->setEnabled(!running);
+    ui->btnDeconvolution->setText(running ? "反褶积中..." : "变产量反褶积");
+}
+
 void FittingPage::updateBasicParameters()
 {
     for(int i = 0; i < ui->tabWidget->count(); ++i) {
@@ -58,6 +85,9 @@ FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject
     if(m_modelManager) w->setModelManager(m_modelManager);
 
     connect(w, &FittingWidget::sigRequestSave, this, &FittingPage::onChildRequestSave);
+    // 进度由拟合线程发出，经队列连接在界面线程中更新
+    connect(w, &FittingWidget::sigFittingStateChanged, this, [this, w](bool running) { setTabProgress(w, running, 0); });
+    connect(w, &FittingWidget::sigProgress, this, [this, w](int progress) { if(w->isFitting()) setTabProgress(w, true, progress); });
 
     int index = ui->tabWidget->addTab(w, name);
     ui->tabWidget->setCurrentIndex(index);
@@ -69,6 +99,31 @@ FittingWidget* FittingPage::createNewTab(const QString &name, const QJsonObject
     return w;
 }
 
+void FittingPage::setTabProgress(FittingWidget* w, bool running, int progress)
+{
+    int idx = ui->tabWidget->indexOf(w);
+    if(idx < 0) return;
+    QTabBar* bar = ui->tabWidget->tabBar();
+    QProgressBar* bar_progress = qobject_cast<QProgressBar*>(bar->tabButton(idx, QTabBar::RightSide));
+    if(!running) {
+        if(bar_progress) {
+            bar->setTabButton(idx, QTabBar::RightSide, nullptr);
+            bar_progress->deleteLater();
+        }
+        ui->tabWidget->setTabToolTip(idx, QString());
+        return;
+    }
+    if(!bar_progress) {
+        bar_progress = new QProgressBar(bar);
+        bar_progress->setRange(0, 100);
+        bar_progress->setTextVisible(false);
+        bar_progress->setFixedSize(40, 8);
+        bar->setTabButton(idx, QTabBar::RightSide, bar_progress);
+    }
+    bar_progress->setValue(progress);
+    ui->tabWidget->setTabToolTip(idx, QString("正在拟合 %1%").arg(progress));
+}
+
 QString FittingPage::generateUniqueName(const QString &baseName)
 {
     QString name = baseName;
@@ -139,13 +194,21 @@ void FittingPage::on_btnDeleteAnalysis_clicked()
         return;
     }
 
-    if(QMessageBox::question(this, "确认", "确定要删除当前分析页吗？\n此操作不可恢复。") == QMessageBox::Yes) {
+    FittingWidget* fw = qobject_cast<FittingWidget*>(ui->tabWidget->widget(idx));
+    QString prompt = (fw && fw->isFitting()) ? "当前分析页正在拟合，删除将停止拟合。\n确定要删除吗？此操作不可恢复。"
+                                            : "确定要删除当前分析页吗？\n此操作不可恢复。";
+    if(QMessageBox::question(this, "确认", prompt) == QMessageBox::Yes) {
         QWidget* w = ui->tabWidget->widget(idx);
         ui->tabWidget->removeTab(idx);
         delete w;
     }
 }
 
+void FittingPage::on_btnDeconvolution_clicked()
+{
+    emit sigRequestDeconvolution();
+}
+
 void FittingPage::saveAllFittingStates()
 {
     QJsonArray analysesArray;
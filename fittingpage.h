@@ -8,6 +8,7 @@
 
 // 前置声明
 class FittingWidget;
+struct RateSchedule;
 
 namespace Ui {
 class FittingPage;
@@ -26,6 +27,14 @@ public:
 
     // 接收来自 MainWindow 的数据，传递给当前激活的 FittingWidget
     void setObservedDataToCurrent(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
+    // 设置当前 FittingWidget 的变产量历史 (为空时恢复定产量)；没有页签或该页签拒绝时返回 false
+    bool setRateHistoryToCurrent(const RateSchedule& schedule);
+    // 当前激活的 FittingWidget (没有页签时为 nullptr)
+    FittingWidget* currentFittingWidget() const;
+    // 原始数据变更: 清除各页签的反褶积标记
+    void clearDeconvolvedMarks();
+    // 反褶积计算期间禁用反褶积按钮
+    void setDeconvolutionRunning(bool running);
 
     // 初始化/重置基本参数
     void updateBasicParameters();
@@ -36,10 +45,15 @@ public:
     // 保存所有拟合分析的状态到项目文件
     void saveAllFittingStates();
 
+signals:
+    // 请求对数据编辑器中的变产量历史反褶积 (由 MainWindow 执行)
+    void sigRequestDeconvolution();
+
 private slots:
     void on_btnNewAnalysis_clicked();
     void on_btnRenameAnalysis_clicked();
     void on_btnDeleteAnalysis_clicked();
+    void on_btnDeconvolution_clicked();
     void onChildRequestSave();
 
 private:
@@ -48,6 +62,8 @@ private:
 
     // 内部函数：创建新页签
     FittingWidget* createNewTab(const QString& name, const QJsonObject& initData = QJsonObject());
+    // 各页签可同时拟合: 在标签上显示该页签的拟合进度 (running 为 false 时移除)
+    void setTabProgress(FittingWidget* w, bool running, int progress);
     QString generateUniqueName(const QString& baseName);
 };
 
@@ -44,7 +44,14 @@ void FittingParameterChart::setModelManager(ModelManager *m)
 void FittingParameterChart::resetParams(ModelManager::ModelType type)
 {
     if(!m_modelManager) return;
-    m_params.clear();
+    m_params = defaultParameters(type);
+    refreshParamTable();
+}
+
+QList<FitParameter> FittingParameterChart::defaultParameters(ModelManager::ModelType type) const
+{
+    QList<FitParameter> params;
+    if(!m_modelManager) return params;
 
     QMap<QString, double> defaultMap = m_modelManager->getDefaultParameters(type);
     QMapIterator<QString, double> it(defaultMap);
@@ -64,9 +71,9 @@ void FittingParameterChart::resetParams(ModelManager::ModelType type)
         QString symbol, uniSym, unit;
         getParamDisplayInfo(p.name, p.displayName, symbol, uniSym, unit);
         p.isVisible = true; // 默认显示
-        m_params.append(p);
+        params.append(p);
     }
-    refreshParamTable();
+    return params;
 }
 
 QList<FitParameter> FittingParameterChart::getParameters() const
@@ -82,15 +89,24 @@ void FittingParameterChart::setParameters(const QList<FitParameter> &params)
 
 void FittingParameterChart::switchModel(ModelManager::ModelType newType)
 {
-    QMap<QString, double> oldValues;
-    for(const auto& p : m_params) oldValues.insert(p.name, p.value);
-
-    resetParams(newType);
+    if(!m_modelManager) return;
+    m_params = parametersForModel(newType, m_params, false);
+    refreshParamTable();
+}
 
-    for(auto& p : m_params) {
-        if(oldValues.contains(p.name)) p.value = oldValues[p.name];
+QList<FitParameter> FittingParameterChart::parametersForModel(ModelManager::ModelType newType, const QList<FitParameter>& from, bool keepFitSettings) const
+{
+    QMap<QString, FitParameter> old;
+    for(const auto& p : from) old.insert(p.name, p);
+
+    QList<FitParameter> params = defaultParameters(newType);
+    for(auto& p : params) {
+        if(!old.contains(p.name)) continue;
+        const FitParameter& o = old[p.name];
+        p.value = o.value;
+        if(keepFitSettings) { p.isFit = o.isFit; p.min = o.min; p.max = o.max; p.isVisible = o.isVisible; }
     }
-    refreshParamTable();
+    return params;
 }
 
 void FittingParameterChart::updateParamsFromTable()
@@ -39,6 +39,10 @@ public:
     // 切换模型（保留公有参数值）
     void switchModel(ModelManager::ModelType newType);
 
+    // 生成 newType 的参数表并沿用 from 中同名参数的数值，keepFitSettings 为 true 时同时沿用拟合标记与范围
+    // 不修改当前参数表，可为多个候选模型分别生成 (须在界面线程中调用)
+    QList<FitParameter> parametersForModel(ModelManager::ModelType newType, const QList<FitParameter>& from, bool keepFitSettings) const;
+
     // 从表格同步数据到内存
     void updateParamsFromTable();
 
@@ -53,6 +57,8 @@ private:
     ModelManager* m_modelManager;
     QList<FitParameter> m_params;
 
+    // 辅助函数：某模型的默认参数表
+    QList<FitParameter> defaultParameters(ModelManager::ModelType type) const;
     // 辅助函数：添加单行数据
     void addRowToTable(const FitParameter& p, int& serialNo, bool highlight);
 };
@@ -0,0 +1,116 @@
+/*
+ * fittingschedule.cpp
+ * 文件作用：多精度拟合日程实现
+ * 功能描述：
+ * 1. 每个阶段构造独立的 FittingCore (观测数据按该阶段抽稀后预处理)，参数在阶段之间直接传递
+ * 2. 与最终阶段等价的低精度阶段 (完整数据且精度相同) 以及抽稀后点数过少的阶段直接跳过
+ * 3. 进度按阶段均分: 第 k 个阶段的第 i 次迭代报告为 k * maxIterations + i
+ */
+
+#include "fittingschedule.h"
+#include "datareduction.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <cmath>
+
+QString FittingSchedule::Result::summary() const
+{
+    QStringList parts;
+    for (const Stage& s : stages) {
+        parts << QString("%1 (%2 点) %3 次迭代 / %4 次计算 / %5 ms")
+                     .arg(s.isFinal ? "最终精度" : "低精度").arg(s.points).arg(s.result.iterations).arg(s.result.modelEvaluations).arg(s.elapsedMs);
+    }
+    return QString("多精度拟合: %1；").arg(parts.join(" -> ")) + finalResult.summary();
+}
+
+QVector<FittingSchedule::Level> FittingSchedule::defaultLevels()
+{
+    // 低精度阶段的计算量约为最终阶段的 1/50，停滞判据从严，尽量在低精度下走完下降过程
+    return { { 8, false, 1e-3, 6, 1e-4, 1e-4 } };
+}
+
+FittingSchedule::FittingSchedule(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d,
+                                 const QVector<FittingCore::Bound>& bounds, double weight, const FittingCore::Options& options)
+    : m_t(t)
+    , m_p(p)
+    , m_d(d)
+    , m_bounds(bounds)
+    , m_weight(weight)
+    , m_options(options)
+    , m_levels(defaultLevels())
+    , m_finalTolerance(1e-6)
+{
+}
+
+FittingSchedule::Result FittingSchedule::run(const ModelSolver01_06& solver, const ModelFactory& model, const SensitivityFactory& sensitivity,
+                                             const QMap<QString, double>& start, const FittingCore::Callbacks& callbacks) const
+{
+    struct Plan {
+        ModelSolver01_06 solver;
+        QVector<double> t, p, d;
+        FittingCore::Options options;
+        bool isFinal;
+    };
+
+    // 最终阶段: 完整数据、原有精度、原有终止判据
+    int finalN = solver.isHighPrecision() ? int(start.value("N", 4)) : 4;
+    if (finalN % 2 != 0) finalN = 4;
+    QVector<Plan> plans;
+    for (const Level& level : m_levels) {
+        Plan plan = { solver, m_t, m_p, m_d, m_options, false };
+        if (level.pointsPerCycle > 0) {
+            DataReduction::Settings reduction;
+            reduction.pointsPerCycle = level.pointsPerCycle;
+            DataReduction::logBinned(m_t, m_p, m_d, reduction, plan.t, plan.p, plan.d);
+            if (plan.t.size() < 3 * m_bounds.size()) continue;
+        }
+        int levelN = level.highPrecision ? int(start.value("N", 4)) : 4;
+        if (levelN % 2 != 0) levelN = 4;
+        bool sameAsFinal = plan.t.size() >= m_t.size() && levelN == finalN && level.quadTolerance == solver.quadratureTolerance()
+                           && level.quadMaxDepth == solver.quadratureMaxDepth();
+        if (sameAsFinal) continue;
+        plan.solver.setHighPrecision(level.highPrecision);
+        plan.solver.setQuadrature(level.quadTolerance, level.quadMaxDepth);
+        plan.options.stallImprovement = level.stallImprovement;
+        plan.options.minStepNorm = level.minStepNorm;
+        plans << plan;
+    }
+    plans << Plan{ solver, m_t, m_p, m_d, m_options, true };
+    plans.last().options.stallImprovement = m_finalTolerance;
+
+    Result result;
+    QMap<QString, double> params = start;
+    int maxIter = qMax(1, m_options.maxIterations);
+    for (int k = 0; k < plans.size(); ++k) {
+        const Plan& plan = plans[k];
+        FittingCore::Callbacks stageCallbacks = callbacks;
+        if (callbacks.progress) {
+            int total = plans.size() * maxIter;
+            stageCallbacks.progress = [&callbacks, k, maxIter, total](int iter, int) { callbacks.progress(k * maxIter + iter, total); };
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        FittingCore core(FittingCore::Observations::prepare(plan.t, plan.p, plan.d), m_bounds, m_weight, plan.options);
+        if (sensitivity) core.setSensitivityFunction(sensitivity(plan.solver));
+        Stage stage;
+        stage.points = plan.t.size();
+        stage.isFinal = plan.isFinal;
+        stage.result = core.run(model(plan.solver, plan.t), params, stageCallbacks);
+        stage.elapsedMs = timer.elapsed();
+        result.stages << stage;
+
+        if (stage.result.stopped) {
+            // 本阶段的初始点未算完时沿用上一阶段的结果
+            bool valid = std::isfinite(stage.result.mse) || result.stages.size() == 1;
+            if (valid) result.finalResult = stage.result;
+            else result.finalResult = result.stages[result.stages.size() - 2].result;
+            result.finalResult.stopped = true;
+            return result;
+        }
+        params = stage.result.params;
+        result.finalResult = stage.result;
+    }
+    return result;
+}
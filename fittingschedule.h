@@ -0,0 +1,77 @@
+/*
+ * fittingschedule.h
+ * 文件作用：多精度 Levenberg-Marquardt 拟合日程
+ * 功能描述：
+ * 1. 依次在若干低精度阶段上拟合 (抽稀数据、N=4、宽松积分容差)，每个阶段以上一阶段的结果为初值
+ * 2. 低精度阶段在改进停滞或步长变小时 (FittingCore 停滞判据) 自动进入下一阶段
+ * 3. 最终阶段总是完整拟合数据 + 调用方给定引擎的原有精度，终止判据为 FittingCore 原有判据加相对下降容差 (默认 1e-6)，
+ *    避免全精度下在平坦谷底反复试探；结果的均方误差与单独的全精度拟合一致 (相对差约 1e-8)
+ * 4. 各阶段的迭代次数、模型计算次数与耗时汇总在结果中
+ */
+
+#ifndef FITTINGSCHEDULE_H
+#define FITTINGSCHEDULE_H
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include "fittingcore.h"
+
+class FittingSchedule
+{
+public:
+    // 低精度阶段定义 (最终阶段无需定义)
+    struct Level {
+        int pointsPerCycle;       // 拟合数据按对数分箱抽稀 (每对数周期点数)，0 为完整数据
+        bool highPrecision;       // 是否使用高精度 Stehfest (N 取参数值)，否则 N=4
+        double quadTolerance;     // 裂缝积分容差
+        int quadMaxDepth;         // 裂缝积分最大细分层数
+        double stallImprovement;  // 连续两次迭代的相对下降低于此值时进入下一阶段
+        double minStepNorm;       // 步长范数 (变换空间) 低于此值时进入下一阶段
+    };
+
+    // 由某一阶段的引擎与时间序列构造模型函数 (叠加等变换由调用方决定)
+    using ModelFactory = std::function<FittingCore::ModelFunction(const ModelSolver01_06& solver, const QVector<double>& t)>;
+    // 由某一阶段的引擎构造灵敏度函数，可为空 (不使用解析雅可比)
+    using SensitivityFactory = std::function<FittingCore::SensitivityFunction(const ModelSolver01_06& solver)>;
+
+    struct Stage {
+        int points = 0;               // 该阶段的观测点数
+        bool isFinal = false;
+        qint64 elapsedMs = 0;
+        FittingCore::Result result;
+    };
+
+    struct Result {
+        QVector<Stage> stages;             // 实际执行的各阶段 (停止时可少于定义的阶段数)
+        FittingCore::Result finalResult;   // 最终阶段的结果 (停止时为最后一个有效阶段的结果)
+
+        // 单行文本摘要，供界面显示
+        QString summary() const;
+    };
+
+    // 默认日程: 8 点/周期 + N=4 + 积分容差 1e-3 / 6 层 -> 最终精度
+    static QVector<Level> defaultLevels();
+
+    FittingSchedule(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, const QVector<FittingCore::Bound>& bounds,
+                    double weight, const FittingCore::Options& options);
+
+    void setLevels(const QVector<Level>& levels) { m_levels = levels; }
+    // 最终阶段的收敛容差: 连续两次迭代的相对下降低于此值即结束 (0 表示只用 FittingCore::Options 原有的终止判据)
+    void setFinalTolerance(double tolerance) { m_finalTolerance = tolerance; }
+
+    // 按日程拟合: solver 为最终精度的引擎 (低精度阶段使用其副本)
+    Result run(const ModelSolver01_06& solver, const ModelFactory& model, const SensitivityFactory& sensitivity,
+               const QMap<QString, double>& start, const FittingCore::Callbacks& callbacks = FittingCore::Callbacks()) const;
+
+private:
+    QVector<double> m_t, m_p, m_d;
+    QVector<FittingCore::Bound> m_bounds;
+    double m_weight;
+    FittingCore::Options m_options;
+    QVector<Level> m_levels;
+    double m_finalTolerance;
+};
+
+#endif // FITTINGSCHEDULE_H
@@ -17,6 +17,7 @@
 #include "modelmanager.h"
 #include "wt_plottingwidget.h" // 引用新的图表头文件
 #include "fittingpage.h"
+#include "wt_fittingwidget.h"
 #include "settingswidget.h"
 
 #include <QDateTime>
@@ -28,6 +29,7 @@
 #include <QStackedWidget>
 #include <cmath>
 #include <QStatusBar>
+#include <QtConcurrent>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -165,12 +167,14 @@ void MainWindow::init()
     // 使用新的 WT_PlottingWidget 类
     m_PlottingWidget = new WT_PlottingWidget(ui->pageData);
     ui->verticalLayout_2->addWidget(m_PlottingWidget);
+    connect(m_PlottingWidget, &WT_PlottingWidget::rateHistoryForFitting, this, &MainWindow::onRateHistoryForFitting);
 
     // 3.5 拟合界面
     if (ui->pageFitting && ui->verticalLayoutFitting) {
         m_FittingPage = new FittingPage(ui->pageFitting);
         ui->verticalLayoutFitting->addWidget(m_FittingPage);
         m_FittingPage->setModelManager(m_ModelManager);
+        connect(m_FittingPage, &FittingPage::sigRequestDeconvolution, this, &MainWindow::onDeconvolutionRequested);
     } else {
         qWarning() << "MainWindow: pageFitting或verticalLayoutFitting为空！无法创建拟合界面";
         m_FittingPage = nullptr;
@@ -182,6 +186,9 @@ void MainWindow::init()
     connect(m_SettingsWidget, &SettingsWidget::settingsChanged,
             this, &MainWindow::onSystemSettingsChanged);
 
+    connect(&m_deconvolutionWatcher, &QFutureWatcher<PressureRateDeconvolution::Result>::finished,
+            this, &MainWindow::onDeconvolutionFinished);
+
     // 执行各模块的辅助初始化
     initProjectForm();
     initDataEditorForm();
@@ -231,6 +238,7 @@ void MainWindow::onProjectClosed()
     qDebug() << "项目已关闭，重置界面状态...";
     m_isProjectLoaded = false;
     m_hasValidData = false;
+    m_deconvolutionTarget = nullptr;
 
     // 1. 清空数据编辑器
     if (m_DataEditorWidget) {
@@ -307,6 +315,7 @@ void MainWindow::onDataEditorDataChanged()
         transferDataFromEditorToPlotting();
     }
     m_hasValidData = hasDataLoaded();
+    if (m_FittingPage) m_FittingPage->clearDeconvolvedMarks();
 }
 
 void MainWindow::onModelCalculationCompleted(const QString &analysisType, const QMap<QString, double> &results)
@@ -322,6 +331,9 @@ void MainWindow::transferDataToFitting()
     if (!model || model->rowCount() == 0) {
         return;
     }
+    // 当前分析页的观测数据为反褶积响应，保留到数据变更为止 (其他页签照常接收原始数据)
+    FittingWidget* current = m_FittingPage->currentFittingWidget();
+    if (current && current->hasDeconvolvedData()) return;
 
     QVector<double> tVec, pVec, dVec;
     double p_initial = 0.0;
@@ -371,6 +383,112 @@ void MainWindow::transferDataToFitting()
     m_FittingPage->setObservedDataToCurrent(tVec, pVec, dVec);
 }
 
+void MainWindow::onDeconvolutionRequested()
+{
+    if (!m_FittingPage || !m_DataEditorWidget || m_deconvolutionWatcher.isRunning()) return;
+
+    auto warn = [this](const QString& text) {
+        QMessageBox msgBox;
+        msgBox.setWindowTitle("反褶积");
+        msgBox.setText(text);
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setStyleSheet(getMessageBoxStyle());
+        msgBox.exec();
+    };
+
+    FittingWidget* target = m_FittingPage->currentFittingWidget();
+    if (!target) {
+        warn("没有拟合分析页，请先新建分析。");
+        return;
+    }
+    if (target->isFitting()) {
+        warn("当前分析正在拟合，请停止拟合后再反褶积。");
+        return;
+    }
+
+    QStandardItemModel* model = m_DataEditorWidget->getDataModel();
+    int rateColumn = -1;
+    QList<ColumnDefinition> definitions = m_DataEditorWidget->getColumnDefinitions();
+    for (int c = 0; c < definitions.size(); ++c) {
+        if (definitions[c].type == WellTestColumnType::FlowRate) { rateColumn = c; break; }
+    }
+    if (!model || model->rowCount() == 0 || rateColumn < 0) {
+        warn("数据中没有流量列，无法反褶积。请在数据界面将产量所在列设为流量列。");
+        return;
+    }
+
+    // 时间、压力列约定同 transferDataToFitting (第 0、1 列)，压力为原始测点压力
+    QVector<double> tVec, pVec, qVec;
+    for(int r=0; r<model->rowCount(); ++r) {
+        bool okT = false, okP = false, okQ = false;
+        double t = model->index(r, 0).data().toDouble(&okT);
+        double p = model->index(r, 1).data().toDouble(&okP);
+        double q = model->index(r, rateColumn).data().toDouble(&okQ);
+        if (!okT || !okP || !okQ) continue;
+        if (!tVec.isEmpty() && t < tVec.last()) continue;
+        tVec.append(t);
+        pVec.append(p);
+        qVec.append(q);
+    }
+
+    RateSchedule schedule = RateSchedule::fromSamples(tVec, qVec);
+    if (schedule.rates.size() < 2) {
+        warn("流量列中产量没有变化，无需反褶积，拟合直接使用原始数据。");
+        return;
+    }
+
+    m_deconvolutionPeriods = schedule.rates.size();
+    m_deconvolutionTarget = target;
+    m_FittingPage->setDeconvolutionRunning(true);
+    if (this->statusBar()) this->statusBar()->showMessage(QString("正在对 %1 段产量历史反褶积...").arg(m_deconvolutionPeriods));
+    m_deconvolutionWatcher.setFuture(QtConcurrent::run([tVec, pVec, schedule]() {
+        return PressureRateDeconvolution(PressureRateDeconvolution::Options()).run(tVec, pVec, schedule);
+    }));
+}
+
+void MainWindow::onDeconvolutionFinished()
+{
+    if (!m_FittingPage) return;
+    m_FittingPage->setDeconvolutionRunning(false);
+    PressureRateDeconvolution::Result result = m_deconvolutionWatcher.result();
+    FittingWidget* target = m_deconvolutionTarget;
+    m_deconvolutionTarget = nullptr;
+    QString failure;
+    if (!result.ok) failure = "反褶积失败: " + result.error + "\n拟合数据保持不变。";
+    else if (!target) failure = "发起反褶积的分析页已关闭，结果未应用。";
+    if (!failure.isEmpty()) {
+        if (this->statusBar()) this->statusBar()->clearMessage();
+        QMessageBox msgBox;
+        msgBox.setWindowTitle("反褶积");
+        msgBox.setText(failure);
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setStyleSheet(getMessageBoxStyle());
+        msgBox.exec();
+        return;
+    }
+
+    // 只写回发起反褶积的分析页；该页此时正在拟合则拒绝 (由 setDeconvolvedData 提示)
+    // 响应对应恒定产量 referenceRate，拟合参数中的 q 同步设为该产量，渗透率等参数才与之对应
+    if (!target->setDeconvolvedData(result.t, result.dp, result.derivative, result.referenceRate)) {
+        if (this->statusBar()) this->statusBar()->clearMessage();
+        return;
+    }
+    if (this->statusBar()) {
+        this->statusBar()->showMessage(QString("已对 %1 段产量历史反褶积: 响应对应恒定产量 %2 (已设为拟合参数 q)，原始地层压力 %3，拟合误差 %4")
+                                       .arg(m_deconvolutionPeriods).arg(result.referenceRate, 0, 'g', 4)
+                                       .arg(result.initialPressure, 0, 'g', 6).arg(result.rmsMisfit, 0, 'g', 3), 10000);
+    }
+}
+
+void MainWindow::onRateHistoryForFitting(const RateSchedule& schedule)
+{
+    if (!m_FittingPage || !m_FittingPage->setRateHistoryToCurrent(schedule)) return;
+    if (this->statusBar()) {
+        this->statusBar()->showMessage(QString("已将 %1 段产量历史设为当前拟合分析的变产量历史，理论曲线按产量阶跃叠加计算")
+                                       .arg(schedule.rates.size()), 8000);
+    }
+}
+
 void MainWindow::onFittingProgressChanged(int progress)
 {
     if (this->statusBar()) {
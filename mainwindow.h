@@ -15,7 +15,10 @@
 #include <QMap>
 #include <QTimer>
 #include <QStandardItemModel>
+#include <QFutureWatcher>
+#include <QPointer>
 #include "modelmanager.h"
+#include "deconvolution.h"
 
 // 前向声明子窗口类，减少头文件依赖
 class NavBtn;
@@ -23,6 +26,7 @@ class WT_ProjectWidget;
 class DataEditorWidget;
 class WT_PlottingWidget; // 使用新的图表类
 class FittingPage;
+class FittingWidget;
 class SettingsWidget;
 
 QT_BEGIN_NAMESPACE
@@ -75,6 +79,11 @@ private slots:
     void onModelCalculationCompleted(const QString &analysisType, const QMap<QString, double> &results);
     // 拟合进度更新回调
     void onFittingProgressChanged(int progress);
+    // 拟合界面请求变产量反褶积: 在后台线程执行，结果交给当前拟合分析
+    void onDeconvolutionRequested();
+    void onDeconvolutionFinished();
+    // 压力产量分析窗口请求将产量历史交给当前拟合分析 (变产量叠加)
+    void onRateHistoryForFitting(const RateSchedule& schedule);
 
 private:
     Ui::MainWindow *ui;
@@ -97,6 +106,12 @@ private:
     // 标记是否已加载项目（新建或打开），用于控制功能访问权限
     bool m_isProjectLoaded = false;
 
+    // 变产量反褶积 (后台计算)
+    QFutureWatcher<PressureRateDeconvolution::Result> m_deconvolutionWatcher;
+    int m_deconvolutionPeriods = 0;
+    // 发起反褶积的分析页: 结果只写回该页 (计算期间页签被关闭时为空)
+    QPointer<FittingWidget> m_deconvolutionTarget;
+
     // --- 内部私有辅助函数 ---
     // 将数据从编辑器传输至绘图模块
     void transferDataFromEditorToPlotting();
@@ -230,14 +230,17 @@ ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMa
     return ModelCurveData();
 }
 
-QVector<double> ModelManager::generateLogTimeSteps(int count, double startExp, double endExp) {
-    QVector<double> t;
-    t.reserve(count);
-    for (int i = 0; i < count; ++i) {
-        double exponent = startExp + (endExp - startExp) * i / (count - 1);
-        t.append(pow(10.0, exponent));
+ModelSolver01_06 ModelManager::getSolver(ModelType type) const
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_modelWidgets.size()) {
+        return m_modelWidgets[index]->solver();
     }
-    return t;
+    return ModelSolver01_06(type);
+}
+
+QVector<double> ModelManager::generateLogTimeSteps(int count, double startExp, double endExp) {
+    return ModelSolver01_06::generateLogTimeSteps(count, startExp, endExp);
 }
 
 void ModelManager::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d)
@@ -39,6 +39,9 @@ public:
     // 计算理论曲线接口 (供 FittingWidget 使用)
     ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
 
+    // 获取指定模型的计算内核副本 (可在工作线程中使用)
+    ModelSolver01_06 getSolver(ModelType type) const;
+
     // 获取默认参数 (供 FittingWidget 使用)
     QMap<QString, double> getDefaultParameters(ModelType type);
 
@@ -0,0 +1,1035 @@
+/*
+ * modelsolver01-06.cpp
+ * 文件作用：压裂水平井复合页岩油模型 (Model 1-6) 计算内核实现
+ * 功能描述：
+ * 1. Stehfest 数值反演、拉普拉斯空间解、裂缝段积分与线性方程组求解
+ *    等间距裂缝利用 Toeplitz 结构只计算 nf 个不同积分；远场用固定阶 Gauss 公式；
+ *    裂缝条数较多时以块 Jacobi 预处理 GMRES 求解，计算量随裂缝条数近似线性增长
+ * 2. 边界条件: 无限大 (mAB=0)、封闭 (mAB=K1/I1)、定压 (mAB=-K0/I0)
+ * 3. 井筒储存与表皮: 仅变井储模型 (1, 3, 5) 启用
+ * 4. 裂缝积分拆为与边界无关的 K0 项和 I0 项，多个模型一次计算时共享积分与 Bessel 值
+ * 5. 可选的引擎统计 (EngineStats): 传入非空指针时记录求值次数、积分层数、NaN 置零、条件数与各阶段耗时
+ * 6. 可选的单精度内核: 被积函数按 Gauss 节点成批以 float 计算，其余部分保持 double
+ * 7. 参数灵敏度: 拉普拉斯解、Bessel 函数、裂缝积分、线性方程组与 Stehfest 反演以对偶数 (前向自动微分) 计算；
+ *    边界因子、被积函数、积分规则与井储公式为 double / Dual 共用的模板
+ * 8. 协作取消: 时间点、Stehfest 项与裂缝积分循环中检查取消标志，置位后提前返回
+ */
+
+#include "modelsolver01-06.h"
+#include "pressurederivativecalculator.h"
+#include "dualnumber.h"
+
+#include <Eigen/Dense>
+#include <boost/math/special_functions/bessel.hpp>
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <QThreadPool>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QStringList>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 裂缝影响系数与多裂缝方程组求解参数
+const double kMidFieldRatio = 1.0;      // 最近距离 >= 1 倍裂缝半长: 单段 15 点 Gauss
+const double kFarFieldRatio = 4.0;      // 最近距离 >= 4 倍裂缝半长: 5 点 Gauss
+const int kDirectSolveMaxStages = 32;   // 裂缝条数不超过此值时直接 LU 分解
+const int kPreconditionerBlock = 32;    // GMRES 块 Jacobi 预处理的块大小 (需覆盖近场相互作用，过小时迭代停滞)
+const int kGmresRestart = 40;
+const int kGmresMaxIterations = 200;
+const double kGmresTolerance = 1e-10;
+
+// 单精度内核参数
+const int kMaxRuleNodes = 15;               // 成批被积函数的最大节点数 (15 点 Gauss)
+const double kFloatQuadTolerance = 1e-5;    // 积分容差下限 (低于此值时 float 舍入误差会使自适应细分无法收敛)
+const double kFloatKernelError = 2e-6;      // 积分矩阵元素的相对误差上界 (近似公式 6e-7 + exp 舍入；实测拉普拉斯值误差不超过由此得到上界的 20%)
+
+// Gauss-Legendre 节点与权重 (正半轴，首项为中心节点)
+const double kGauss15X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
+const double kGauss15W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
+const double kGauss5X[] = { 0.0, 0.5384693101056831, 0.9061798459386640 };
+const double kGauss5W[] = { 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+
+// 缩放 Bessel I: I_v(x) * exp(-x)，大参数时用渐近式
+double scaledBesselI(int v, double x)
+{
+    if (x < 0) x = -x;
+    if (x > 600.0) return 1.0 / std::sqrt(2.0 * M_PI * x);
+    return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
+}
+
+// 单精度 exp/log (Cephes expf/logf 的多项式，相对误差约 1e-7)；用整数位运算代替 ldexp/frexp，可向量化
+inline float expApprox(float x)
+{
+    x = std::min(std::max(x, -87.0f), 88.0f);
+    const float t = x * 1.44269504f + 0.5f;
+    int32_t n = int32_t(t);
+    n -= int32_t(float(n) > t); // floor
+    const float fn = float(n);
+    const float r = x - fn * 0.693359375f + fn * 2.12194440e-4f;
+    const float p = (((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r + 4.1665795894e-2f) * r
+                     + 1.6666665459e-1f) * r + 5.0000001201e-1f) * r * r + r + 1.0f;
+    const int32_t bits = (n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+inline float logApprox(float x)
+{
+    int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    int32_t e = ((bits >> 23) & 0xff) - 126;
+    bits = (bits & 0x807fffff) | 0x3f000000; // 尾数归一到 [0.5, 1)
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    const bool lo = m < 0.70710678f;
+    e -= int32_t(lo);
+    const float m2 = m + m - 1.0f, m1 = m - 1.0f;
+    m = lo ? m2 : m1;
+    const float z = m * m;
+    float y = ((((((((7.0376836292e-2f * m - 1.1514610310e-1f) * m + 1.1676998740e-1f) * m - 1.2420140846e-1f) * m + 1.4249322787e-1f) * m
+              - 1.6668057665e-1f) * m + 2.0000714765e-1f) * m - 2.4999993993e-1f) * m + 3.3333331174e-1f) * m * z;
+    const float fe = float(e);
+    y += -2.12194440e-4f * fe - 0.5f * z;
+    return m + y + 0.693359375f * fe;
+}
+
+// K0(x) 与 I0(x)*exp(-shift) 的单精度近似 (Abramowitz & Stegun 9.8.1-9.8.6，相对误差约 6e-7，
+// I0 项另含 exp 舍入 |x - shift| * 6e-8)。
+// 两个分支的自变量都截断到各自适用范围后全部计算，再以 0/1 系数混合: 循环体无分支，
+// 编译器可按 SIMD 宽度向量化 (SSE 4 路、AVX2 8 路、AVX-512 16 路；GCC 需 -fno-math-errno -fno-trapping-math)
+void besselK0I0Float(const float* x, int n, float shift, float* k, float* i)
+{
+    for (int j = 0; j < n; ++j) {
+        const float v = x[j];
+        const float smallI = float(v < 3.75f), smallK = float(v <= 2.0f);
+        const float rs = 1.0f / std::sqrt(v);
+
+        const float t = std::min(v, 3.75f) * (1.0f / 3.75f), t2 = t * t;
+        const float i0Small = 1.0f + t2 * (3.5156229f + t2 * (3.0899424f + t2 * (1.2067492f + t2 * (0.2659732f + t2 * (0.0360768f + t2 * 0.0045813f)))));
+        const float u = 3.75f / std::max(v, 3.75f);
+        const float i0Scaled = (0.39894228f + u * (0.01328592f + u * (0.00225319f + u * (-0.00157565f + u * (0.00916281f + u * (-0.02057706f
+                               + u * (0.02635537f + u * (-0.01647633f + u * 0.00392377f)))))))) * rs;
+        const float ex = v * (1.0f - smallI) - shift; // 小自变量: I0 * exp(-shift)；大自变量: (e^-x I0) * exp(x - shift)
+        i[j] = (smallI * i0Small + (1.0f - smallI) * i0Scaled) * expApprox(ex) * float(ex > -80.0f);
+
+        const float vs = std::min(v, 2.0f), y = 0.25f * vs * vs;
+        const float k0Small = -logApprox(0.5f * vs) * i0Small + (-0.57721566f + y * (0.42278420f + y * (0.23069756f + y * (0.03488590f
+                              + y * (0.00262698f + y * (0.00010750f + y * 0.0000074f))))));
+        const float w = 2.0f / std::max(v, 2.0f);
+        const float k0Large = expApprox(-v) * rs * (1.25331414f + w * (-0.07832358f + w * (0.02189568f + w * (-0.01062446f
+                              + w * (0.00587872f + w * (-0.00251540f + w * 0.00053208f))))));
+        k[j] = smallK * k0Small + (1.0f - smallK) * k0Large;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 与标量类型无关的内核部分: double 路径 (PWD_composite) 与自动微分路径 (laplaceDual) 以 T = double / Dual 实例化
+// 分支、积分规则选择与收敛判据只看函数值 (valueOf)，两条路径对同一参数走同一分支、同一细分
+// ---------------------------------------------------------------------------
+
+inline double valueOf(double x) { return x; }
+inline double valueOf(const Dual& x) { return x.v; }
+
+inline double besselK0(double x) { return boost::math::cyl_bessel_k(0, x); }
+inline double besselK1(double x) { return boost::math::cyl_bessel_k(1, x); }
+inline double scaledBesselI0(double x) { return scaledBesselI(0, x); }
+inline double scaledBesselI1(double x) { return scaledBesselI(1, x); }
+
+// K0' = -K1, K1' = -K0 - K1/x, (I0 e^-x)' = I1s - I0s, (I1 e^-x)' = I0s - I1s/x - I1s
+Dual besselK0(const Dual& x)
+{
+    return Dual::chain(x, boost::math::cyl_bessel_k(0, x.v), -boost::math::cyl_bessel_k(1, x.v));
+}
+
+Dual besselK1(const Dual& x)
+{
+    double k0 = boost::math::cyl_bessel_k(0, x.v), k1 = boost::math::cyl_bessel_k(1, x.v);
+    return Dual::chain(x, k1, -k0 - k1 / x.v);
+}
+
+Dual scaledBesselI0(const Dual& x)
+{
+    double i0 = scaledBesselI(0, x.v), i1 = scaledBesselI(1, x.v);
+    return Dual::chain(x, i0, i1 - i0);
+}
+
+Dual scaledBesselI1(const Dual& x)
+{
+    double i0 = scaledBesselI(0, x.v), i1 = scaledBesselI(1, x.v);
+    return Dual::chain(x, i1, i0 - i1 / x.v - i1);
+}
+
+// 三种边界的 Ac 前因子 Ac * exp(gama1*rmD) (下标与 ModelSolver01_06::Boundary 一致: 0 无限大、1 封闭、2 定压)
+// MATLAB: mAB = 0 / K1(re)/I1(re) / -K0(re)/I0(re)
+//         Acup = M12*gama1*K1(g1)*(mAB*I0(g2)+K0(g2)) + gama2*K0(g1)*(mAB*I1(g2)-K1(g2))，Acdown 同式 K 换 I
+// 三种边界总是全部计算 (只需几次 Bessel 调用)，使积分判据只取决于参数、与所需模型组合无关；
+// reD 未设置 (<= 0) 时有界边界无意义，按无限大处理。返回积分判据中 I 分量的权重 max|Ac|
+template <class T>
+double boundaryFactors(const T& M12, const T& gama1, const T& gama2, const T& rmD, const T& reD, T Ac[3])
+{
+    T argG2 = gama2 * rmD, argG1 = gama1 * rmD;
+    // 使用缩放贝塞尔函数以避免数值溢出
+    T k0g2 = besselK0(argG2), k1g2 = besselK1(argG2), k0g1 = besselK0(argG1), k1g1 = besselK1(argG1);
+    T i1g1 = scaledBesselI1(argG1), i0g1 = scaledBesselI0(argG1);
+
+    bool bounded = valueOf(reD) > 0.0;
+    T i0re(0.0), i1re(0.0), k0re(0.0), k1re(0.0), i0g2(0.0), i1g2(0.0), shift(0.0);
+    if (bounded) {
+        T argRe = gama2 * reD;
+        i1re = scaledBesselI1(argRe); i0re = scaledBesselI0(argRe);
+        k1re = besselK1(argRe); k0re = besselK0(argRe);
+        i0g2 = scaledBesselI0(argG2); i1g2 = scaledBesselI1(argG2);
+        shift = exp(argG2 - argRe);   // 缩放 I 的指数项
+    }
+    for (int bc = 0; bc < 3; ++bc) {
+        T mI0(0.0), mI1(0.0);   // mAB * I0(g2*rmD)、mAB * I1(g2*rmD)
+        if (bounded && bc == 1 && valueOf(i1re) > 1e-100) {
+            T ratio = k1re / i1re;
+            mI0 = ratio * i0g2 * shift; mI1 = ratio * i1g2 * shift;
+        } else if (bounded && bc == 2 && valueOf(i0re) > 1e-100) {
+            T ratio = -(k0re / i0re);
+            mI0 = ratio * i0g2 * shift; mI1 = ratio * i1g2 * shift;
+        }
+        T term1 = mI0 + k0g2, term2 = mI1 - k1g2;
+        T up = M12 * gama1 * k1g1 * term1 + gama2 * k0g1 * term2;
+        // 缩放版本 Acdown * exp(-gama1*rmD)
+        T down = M12 * gama1 * i1g1 * term1 - gama2 * i0g1 * term2;
+        if (std::abs(valueOf(down)) < 1e-100) down = T(1e-100);
+        Ac[bc] = up / down;
+    }
+    return std::max({ std::abs(valueOf(Ac[0])), std::abs(valueOf(Ac[1])), std::abs(valueOf(Ac[2])) });
+}
+
+// 积分核函数 K0 + Ac*I0 拆为与边界无关的两项 (dist 为观测点到源裂缝上积分点的距离):
+// k = K0(g1*dist), i = I0(g1*dist) * exp(-g1*rmD)，各边界的核函数为 k + Ac * i
+template <class T>
+void kernelNodes(const T* dist, int n, const T& gama1, const T& argG1, T* k, T* i)
+{
+    for (int j = 0; j < n; ++j) {
+        T arg = gama1 * dist[j];
+        if (valueOf(arg) < 1e-10) arg = T(1e-10);
+        // I0(arg) * exp(-argG1) = scaled_I0 * exp(arg - argG1)
+        T exponent = arg - argG1;
+        i[j] = valueOf(exponent) > -700.0 ? T(scaledBesselI0(arg) * exp(exponent)) : T(0.0);
+        k[j] = besselK0(arg);
+    }
+}
+
+// half 个正半轴节点的 Gauss 公式 (共 2*half-1 个节点)；节点按 c, c-dx1, c+dx1, c-dx2, ... 排列，一次交给被积函数
+template <class T, class F>
+void gaussRule(const double* X, const double* W, int half, const F& f, const T& a, const T& b, T& sk, T& si)
+{
+    T h = 0.5 * (b - a), c = 0.5 * (a + b);
+    T nodes[kMaxRuleNodes], k[kMaxRuleNodes], v[kMaxRuleNodes];
+    nodes[0] = c;
+    for (int i = 1; i < half; ++i) { nodes[2 * i - 1] = c - h * X[i]; nodes[2 * i] = c + h * X[i]; }
+    f(nodes, 2 * half - 1, k, v);
+    sk = W[0] * k[0]; si = W[0] * v[0];
+    for (int i = 1; i < half; ++i) {
+        sk += W[i] * (k[2 * i - 1] + k[2 * i]); si += W[i] * (v[2 * i - 1] + v[2 * i]);
+    }
+    sk *= h; si *= h;
+}
+
+// 自适应 15 点 Gauss: 两分量均满足容差才接受 (I 分量按最大的 |Ac| 加权，保证每种边界的核函数都满足容差)
+template <class T, class F>
+void adaptiveQuadrature(const F& f, const T& a, const T& b, double eps, double weightI, int depth, int maxDepth,
+                        T& sk, T& si, EngineStats* stats)
+{
+    T c = 0.5 * (a + b);
+    T k1, i1, kl, il, kr, ir;
+    gaussRule(kGauss15X, kGauss15W, 8, f, a, b, k1, i1);
+    gaussRule(kGauss15X, kGauss15W, 8, f, a, c, kl, il);
+    gaussRule(kGauss15X, kGauss15W, 8, f, c, b, kr, ir);
+    T k2 = kl + kr, i2 = il + ir;
+    bool converged = std::abs(valueOf(k1) - valueOf(k2)) < 1e-10 * std::abs(valueOf(k2)) + eps &&
+                     weightI * std::abs(valueOf(i1) - valueOf(i2)) < 1e-10 * weightI * std::abs(valueOf(i2)) + eps;
+    if (depth >= maxDepth || converged) {
+        if (stats) stats->addDepth(depth, !converged);
+        sk = k2; si = i2;
+        return;
+    }
+    T ka, ia, kb, ib;
+    adaptiveQuadrature(f, a, c, eps / 2, weightI, depth + 1, maxDepth, ka, ia, stats);
+    adaptiveQuadrature(f, c, b, eps / 2, weightI, depth + 1, maxDepth, kb, ib, stats);
+    sk = ka + kb; si = ia + ib;
+}
+
+// 裂缝 j 对裂缝 i 的影响积分 (dx = xwD[i]-xwD[j], dy = ywD[i]-ywD[j])，积分区间 [-LfD, LfD]
+// 近场: 自适应积分，K0 的对数奇点落在积分区间内时在奇点处分段
+// 远场: 被积函数在区间上解析，用固定阶 Gauss 公式代替自适应细分
+// kernel(dist, n, k, i) 给出 n 个距离上的 K0 项与 I0 项；spread = gama1*LfD 为区间半长上指数项的变化量
+template <class T, class Kernel>
+void influenceIntegral(const Kernel& kernel, double dx, double dy, const T& LfD, double spread, double quadTolerance, double weightI,
+                       int maxDepth, T& ik, T& ii, EngineStats* stats)
+{
+    auto integrand = [&](const T* a, int n, T* k, T* i) {
+        T dist[kMaxRuleNodes];
+        for (int j = 0; j < n; ++j) {
+            T diff = dx - a[j];
+            dist[j] = dy == 0.0 ? (valueOf(diff) < 0.0 ? T(-diff) : diff) : T(sqrt(diff * diff + dy * dy));
+        }
+        kernel(dist, n, k, i);
+    };
+    double lf = valueOf(LfD);
+    double gap = std::sqrt(std::pow(std::max(0.0, std::abs(dx) - lf), 2) + dy * dy); // 观测点到源裂缝的最近距离
+    bool fixedRule = (gap >= kMidFieldRatio * lf && spread <= 8.0);
+    if (stats) ++(fixedRule ? stats->fixedRuleIntegrals : stats->adaptiveIntegrals);
+    if (gap >= kFarFieldRatio * lf && spread <= 2.0) {
+        gaussRule(kGauss5X, kGauss5W, 3, integrand, T(-LfD), LfD, ik, ii);
+    } else if (fixedRule) {
+        gaussRule(kGauss15X, kGauss15W, 8, integrand, T(-LfD), LfD, ik, ii);
+    } else if (dy == 0.0 && std::abs(dx) < lf) {
+        // 与整体自适应首次二分后的容差分配一致
+        T k2, i2;
+        adaptiveQuadrature(integrand, T(-LfD), T(dx), quadTolerance / 2, weightI, 1, maxDepth, ik, ii, stats);
+        adaptiveQuadrature(integrand, T(dx), LfD, quadTolerance / 2, weightI, 1, maxDepth, k2, i2, stats);
+        ik += k2; ii += i2;
+    } else {
+        adaptiveQuadrature(integrand, T(-LfD), LfD, quadTolerance, weightI, 0, maxDepth, ik, ii, stats);
+    }
+}
+
+// 井筒储存和表皮 (对应 MATLAB: (z*pf+S)/(z+CD*z^2*(z*pf+S)))，cD 与 S 均为零时不变
+// gain 非空时写入相对误差传递系数 d ln(pf') / d ln(pf) = (z*pf/u) * (z/den)
+template <class T>
+T withStorage(const T& z, const T& pf, const T& cD, const T& S, double* gain = nullptr)
+{
+    if (gain) *gain = 1.0;
+    if (!(valueOf(cD) > 1e-12 || std::abs(valueOf(S)) > 1e-12)) return pf;
+    T u = z * pf + S;
+    T den = z + cD * z * z * u;
+    if (gain) *gain = std::abs(valueOf(z * pf / u)) * std::abs(valueOf(z / den));
+    return u / den;
+}
+
+// 对称 Toeplitz 方程组 T(col) x = b 的预处理 GMRES 解法；未收敛时返回空向量，iterations 为累计迭代次数
+Eigen::VectorXd solveToeplitzGmres(const Eigen::VectorXd& col, const Eigen::VectorXd& b, int* iterations = nullptr)
+{
+    // 右预处理 GMRES(m)；预处理为分块对角 (块 Jacobi)，Toeplitz 矩阵的各整块完全相同，只需分解一次
+    const int n = int(col.size());
+    const int bs = std::min(kPreconditionerBlock, n);
+    const int tail = n % bs;
+    auto toeplitzBlock = [&](int m) {
+        Eigen::MatrixXd T(m, m);
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < m; ++j) T(i, j) = col(std::abs(i - j));
+        return T;
+    };
+    Eigen::PartialPivLU<Eigen::MatrixXd> blockLu(toeplitzBlock(bs));
+    Eigen::PartialPivLU<Eigen::MatrixXd> tailLu;
+    if (tail > 0) tailLu.compute(toeplitzBlock(tail));
+
+    auto precondition = [&](const Eigen::VectorXd& v) {
+        Eigen::VectorXd r(n);
+        int full = n - tail;
+        for (int s = 0; s < full; s += bs) r.segment(s, bs) = blockLu.solve(v.segment(s, bs));
+        if (tail > 0) r.tail(tail) = tailLu.solve(v.tail(tail));
+        return r;
+    };
+    auto multiply = [&](const Eigen::VectorXd& v) {
+        Eigen::VectorXd r(n);
+        for (int i = 0; i < n; ++i) {
+            double s = 0.0;
+            for (int j = 0; j < n; ++j) s += col(std::abs(i - j)) * v(j);
+            r(i) = s;
+        }
+        return r;
+    };
+
+    const int restart = std::min(kGmresRestart, n);
+    const double bnorm = b.norm();
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+    if (bnorm == 0.0) return x;
+
+    Eigen::MatrixXd V(n, restart + 1);
+    Eigen::MatrixXd H(restart + 1, restart);
+    Eigen::VectorXd cs(restart), sn(restart), g(restart + 1);
+
+    int iter = 0;
+    while (iter < kGmresMaxIterations) {
+        Eigen::VectorXd r = b - multiply(x);
+        double beta = r.norm();
+        if (!std::isfinite(beta)) break;
+        if (beta <= kGmresTolerance * bnorm) { if (iterations) *iterations = iter; return x; }
+
+        H.setZero(); g.setZero(); g(0) = beta;
+        V.col(0) = r / beta;
+        int k = 0;
+        bool converged = false;
+        while (k < restart && iter < kGmresMaxIterations) {
+            Eigen::VectorXd w = multiply(precondition(V.col(k)));
+            // 修正 Gram-Schmidt 正交化
+            for (int i = 0; i <= k; ++i) {
+                H(i, k) = V.col(i).dot(w);
+                w -= H(i, k) * V.col(i);
+            }
+            H(k + 1, k) = w.norm();
+            if (H(k + 1, k) > 0.0) V.col(k + 1) = w / H(k + 1, k);
+
+            // Givens 旋转将 H 化为上三角
+            for (int i = 0; i < k; ++i) {
+                double t = cs(i) * H(i, k) + sn(i) * H(i + 1, k);
+                H(i + 1, k) = -sn(i) * H(i, k) + cs(i) * H(i + 1, k);
+                H(i, k) = t;
+            }
+            double d = std::hypot(H(k, k), H(k + 1, k));
+            if (d == 0.0) break;
+            cs(k) = H(k, k) / d; sn(k) = H(k + 1, k) / d;
+            H(k, k) = d; H(k + 1, k) = 0.0;
+            g(k + 1) = -sn(k) * g(k); g(k) = cs(k) * g(k);
+            ++k; ++iter;
+            if (std::abs(g(k)) <= kGmresTolerance * bnorm) { converged = true; break; }
+        }
+        if (k == 0) break;
+
+        Eigen::VectorXd coeff = H.topLeftCorner(k, k).triangularView<Eigen::Upper>().solve(g.head(k));
+        x += precondition(V.leftCols(k) * coeff);
+        if (converged) { if (iterations) *iterations = iter; return x; }
+    }
+    if (iterations) *iterations = iter;
+    return Eigen::VectorXd(); // 未收敛，由调用方改用直接解法
+}
+
+} // namespace
+
+ModelSolver01_06::ModelSolver01_06(ModelType type)
+    : m_type(type)
+    , m_highPrecision(true)
+    , m_quadTolerance(1e-5)
+    , m_quadMaxDepth(10)
+    , m_floatKernel(false)
+    , m_cancel(nullptr)
+{
+}
+
+void ModelSolver01_06::setHighPrecision(bool high) { m_highPrecision = high; }
+
+void ModelSolver01_06::setQuadrature(double eps, int maxDepth)
+{
+    m_quadTolerance = eps;
+    m_quadMaxDepth = maxDepth;
+}
+
+void ModelSolver01_06::setSinglePrecisionKernel(bool on) { m_floatKernel = on; }
+
+void EngineStats::addDepth(int depth, bool hitMaxDepth)
+{
+    if (depth >= depthHistogram.size()) depthHistogram.resize(depth + 1, 0);
+    ++depthHistogram[depth];
+    if (hitMaxDepth) ++maxDepthHits;
+}
+
+void EngineStats::merge(const EngineStats& o)
+{
+    laplaceEvaluations += o.laplaceEvaluations;
+    integrandCalls += o.integrandCalls;
+    adaptiveIntegrals += o.adaptiveIntegrals;
+    fixedRuleIntegrals += o.fixedRuleIntegrals;
+    if (o.depthHistogram.size() > depthHistogram.size()) depthHistogram.resize(o.depthHistogram.size(), 0);
+    for (int i = 0; i < o.depthHistogram.size(); ++i) depthHistogram[i] += o.depthHistogram[i];
+    maxDepthHits += o.maxDepthHits;
+    nanReplacements += o.nanReplacements;
+    directSolves += o.directSolves;
+    iterativeSolves += o.iterativeSolves;
+    gmresIterations += o.gmresIterations;
+    gmresFallbacks += o.gmresFallbacks;
+    maxConditionEstimate = std::max(maxConditionEstimate, o.maxConditionEstimate);
+    maxFloatErrorBound = std::max(maxFloatErrorBound, o.maxFloatErrorBound);
+    quadratureMs += o.quadratureMs;
+    solveMs += o.solveMs;
+    inversionMs += o.inversionMs;
+    derivativeMs += o.derivativeMs;
+    totalMs += o.totalMs;
+}
+
+QString EngineStats::summary() const
+{
+    QString text;
+    text += QString("拉普拉斯求值: %1 次, 被积函数调用: %2 次\n").arg(laplaceEvaluations).arg(integrandCalls);
+    text += QString("裂缝积分: 自适应 %1 次, 固定阶 %2 次\n").arg(adaptiveIntegrals).arg(fixedRuleIntegrals);
+    QStringList depths;
+    for (int i = 0; i < depthHistogram.size(); ++i) {
+        if (depthHistogram[i] > 0) depths << QString("%1:%2").arg(i).arg(depthHistogram[i]);
+    }
+    text += QString("细分层数分布 (层:区间数): %1\n").arg(depths.isEmpty() ? QString("-") : depths.join(" "));
+    text += QString("达到最大层数: %1 次, NaN/Inf 置零: %2 次\n").arg(maxDepthHits).arg(nanReplacements);
+    text += QString("线性求解: 直接 %1 次, GMRES %2 次 (累计迭代 %3, 改用直接解法 %4 次)\n")
+                .arg(directSolves).arg(iterativeSolves).arg(gmresIterations).arg(gmresFallbacks);
+    text += QString("最大条件数估计: %1\n").arg(maxConditionEstimate, 0, 'e', 2);
+    if (maxFloatErrorBound > 0.0) text += QString("单精度内核误差上界 (相对双精度): %1\n").arg(maxFloatErrorBound, 0, 'e', 2);
+    text += QString("耗时 (ms): 积分 %1, 求解 %2, 反演 %3, 导数 %4, 合计 %5\n")
+                .arg(quadratureMs, 0, 'f', 1).arg(solveMs, 0, 'f', 1).arg(inversionMs, 0, 'f', 1)
+                .arg(derivativeMs, 0, 'f', 1).arg(totalMs, 0, 'f', 1);
+    return text;
+}
+
+QThreadPool* ModelSolver01_06::enginePool()
+{
+    // 函数内静态对象，首次使用时创建 (C++11 起线程安全)
+    static QThreadPool* pool = []() {
+        QThreadPool* p = new QThreadPool();
+        p->setMaxThreadCount(QThread::idealThreadCount());
+        p->setExpiryTimeout(30000);
+        return p;
+    }();
+    return pool;
+}
+
+QVector<double> ModelSolver01_06::generateLogTimeSteps(int count, double startExp, double endExp) {
+    QVector<double> t;
+    t.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double exponent = startExp + (endExp - startExp) * i / (count - 1);
+        t.append(pow(10.0, exponent));
+    }
+    return t;
+}
+
+QVector<double> ModelSolver01_06::fracturePositions(int nf) {
+    if (nf <= 1) return QVector<double>(1, 0.0);
+    QVector<double> xwD;
+    xwD.reserve(nf);
+    double start = -0.9; double end = 0.9; double step = (end - start) / (nf - 1);
+    for (int i = 0; i < nf; ++i) xwD.append(start + i * step);
+    return xwD;
+}
+
+void ModelSolver01_06::dimensionalScales(const QMap<QString, double>& params, double& tScale, double& pScale)
+{
+    double phi = params.value("phi", 0.05);
+    double mu = params.value("mu", 0.5);
+    double B = params.value("B", 1.05);
+    double Ct = params.value("Ct", 5e-4);
+    double q = params.value("q", 5.0);
+    double h = params.value("h", 20.0);
+    double kf = params.value("kf", 1e-3);
+    double L = params.value("L", 1000.0);
+
+    tScale = 14.4 * kf / (phi * mu * Ct * pow(L, 2));
+    pScale = 1.842e-3 * q * mu * B / (kf * h);
+}
+
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime, EngineStats* stats) const
+{
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+
+    double tScale, factor;
+    dimensionalScales(params, tScale, factor);
+
+    QVector<double> tD_vec;
+    tD_vec.reserve(tPoints.size());
+    for(double t : tPoints) {
+        tD_vec.append(tScale * t);
+    }
+
+    ModelCurveData dimensionless = calculateDimensionlessCurve(params, tD_vec, stats);
+    const QVector<double>& PD_vec = std::get<1>(dimensionless);
+    const QVector<double>& Deriv_vec = std::get<2>(dimensionless);
+
+    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
+
+    for(int i=0; i<tPoints.size(); ++i) {
+        finalP[i] = factor * PD_vec[i];
+        finalDP[i] = factor * Deriv_vec[i];
+    }
+
+    return std::make_tuple(tPoints, finalP, finalDP);
+}
+
+ModelCurveData ModelSolver01_06::calculateDimensionlessCurve(const QMap<QString, double>& params, const QVector<double>& tD, EngineStats* stats) const
+{
+    return calculateDimensionlessCurves(params, QVector<ModelType>() << m_type, tD, stats).first();
+}
+
+QVector<ModelCurveData> ModelSolver01_06::calculateTheoreticalCurves(const QMap<QString, double>& params, const QVector<ModelType>& types,
+                                                                  const QVector<double>& providedTime, EngineStats* stats) const
+{
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+
+    double tScale, factor;
+    dimensionalScales(params, tScale, factor);
+
+    QVector<double> tD_vec;
+    tD_vec.reserve(tPoints.size());
+    for (double t : tPoints) {
+        tD_vec.append(tScale * t);
+    }
+
+    QVector<ModelCurveData> curves = calculateDimensionlessCurves(params, types, tD_vec, stats);
+    for (ModelCurveData& curve : curves) {
+        for (double& v : std::get<1>(curve)) v *= factor;
+        for (double& v : std::get<2>(curve)) v *= factor;
+        std::get<0>(curve) = tPoints;
+    }
+    return curves;
+}
+
+QVector<ModelCurveData> ModelSolver01_06::calculateDimensionlessCurves(const QMap<QString, double>& params, const QVector<ModelType>& types,
+                                                                    const QVector<double>& tD, EngineStats* stats) const
+{
+    QElapsedTimer timer;
+    if (stats) timer.start();
+
+    QVector<QVector<double>> pd;
+    calculatePD(tD, params, types.constData(), types.size(), pd, stats);
+
+    qint64 derivStart = stats ? timer.nsecsElapsed() : 0;
+    QVector<ModelCurveData> curves;
+    curves.reserve(types.size());
+    for (const QVector<double>& p : pd) {
+        curves.append(std::make_tuple(tD, p, bourdetDerivative(tD, p)));
+    }
+    if (stats) {
+        stats->derivativeMs += (timer.nsecsElapsed() - derivStart) / 1e6;
+        stats->totalMs += timer.nsecsElapsed() / 1e6;
+    }
+    return curves;
+}
+
+QVector<double> ModelSolver01_06::calculateDimensionlessPressure(const QMap<QString, double>& params, const QVector<double>& tD, EngineStats* stats) const
+{
+    QElapsedTimer timer;
+    if (stats) timer.start();
+    QVector<QVector<double>> pd;
+    calculatePD(tD, params, &m_type, 1, pd, stats);
+    if (stats) stats->totalMs += timer.nsecsElapsed() / 1e6;
+    return pd.first();
+}
+
+QVector<double> ModelSolver01_06::calculatePressure(const QMap<QString, double>& params, const QVector<double>& t, EngineStats* stats) const
+{
+    double tScale, pScale;
+    dimensionalScales(params, tScale, pScale);
+    QVector<double> tD(t.size());
+    for (int i = 0; i < t.size(); ++i) tD[i] = tScale * t[i];
+
+    QVector<double> p = calculateDimensionlessPressure(params, tD, stats);
+    for (double& v : p) v *= pScale;
+    return p;
+}
+
+QVector<double> ModelSolver01_06::bourdetDerivative(const QVector<double>& t, const QVector<double>& p)
+{
+    if (t.size() > 2) return PressureDerivativeCalculator::calculateBourdetDerivative(t, p, 0.1);
+    return QVector<double>(t.size(), 0.0);
+}
+
+void ModelSolver01_06::calculatePD(const QVector<double>& tD, const QMap<QString, double>& params, const ModelType* types, int count,
+                                   QVector<QVector<double>>& outPD, EngineStats* stats) const
+{
+    QElapsedTimer timer;
+    if (stats) timer.start();
+
+    int numPoints = tD.size();
+    outPD = QVector<QVector<double>>(count, QVector<double>(numPoints, 0.0));
+
+    int N_param = (int)params.value("N", 4);
+    int N = m_highPrecision ? N_param : 4;
+    if (N % 2 != 0) N = 4;
+    double ln2 = log(2.0);
+
+    // 获取压敏系数 (MATLAB: gamaD)
+    double gamaD = params.value("gamaD", 0.0);
+
+    // 单精度内核的误差上界: 拉普拉斯值相对误差为 δ_m 时 |ΔpD| <= ln2/t * Σ|V_m f(z_m)| δ_m
+    // (Stehfest 系数正负交替，抵消越严重放大越大)
+    bool trackFloatBound = m_floatKernel && stats;
+    QVector<double> pf(count), pd_val(count), pd_abs(count), pf_err(count);
+    for (int k = 0; k < numPoints; ++k) {
+        if (isCancelled()) break;
+        double t = tD[k];
+        if (t <= 1e-12) continue;
+        pd_val.fill(0.0);
+        if (trackFloatBound) pd_abs.fill(0.0);
+        for (int m = 1; m <= N; ++m) {
+            if (isCancelled()) break;
+            double z = m * ln2 / t;
+            double coef = stefestCoefficient(m, N);
+            flaplace_composite(z, params, types, count, pf.data(), stats, trackFloatBound ? pf_err.data() : nullptr);
+            if (stats) ++stats->laplaceEvaluations;
+            for (int c = 0; c < count; ++c) {
+                if (std::isnan(pf[c]) || std::isinf(pf[c])) {
+                    pf[c] = 0.0;
+                    if (stats) ++stats->nanReplacements;
+                }
+                pd_val[c] += coef * pf[c];
+                if (trackFloatBound) pd_abs[c] += std::abs(coef * pf[c]) * pf_err[c];
+            }
+        }
+
+        for (int c = 0; c < count; ++c) {
+            double& pd = outPD[c][k];
+            pd = pd_val[c] * ln2 / t;
+            double bound = trackFloatBound ? pd_abs[c] * ln2 / t : 0.0;
+
+            // 摄动法考虑压敏效应 (对应 MATLAB: -1/gamaD * log(1-gamaD*PD))
+            if (std::abs(gamaD) > 1e-9) {
+                double arg = 1.0 - gamaD * pd;
+                if (arg > 1e-12) {
+                    pd = -1.0 / gamaD * std::log(arg);
+                    bound /= arg; // d(pd')/d(pd) = 1/arg
+                }
+            }
+            if (trackFloatBound && pd != 0.0) stats->maxFloatErrorBound = std::max(stats->maxFloatErrorBound, bound / std::abs(pd));
+        }
+    }
+    if (stats) stats->inversionMs += timer.nsecsElapsed() / 1e6;
+}
+
+void ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double>& p, const ModelType* types, int count, double* out, EngineStats* stats,
+                                          double* floatError) const {
+    double kf = p.value("kf");
+    double km = p.value("km");
+    double LfD = p.value("LfD");
+    double rmD = p.value("rmD");
+    double reD = p.value("reD", 0.0); // 默认0表示无限大(如果未设置)
+    double omga1 = p.value("omega1");
+    double omga2 = p.value("omega2");
+    double remda1 = p.value("lambda1");
+    int nf = (int)p.value("nf", 4); if(nf < 1) nf = 1;
+    double M12 = kf / km;
+    QVector<double> xwD = fracturePositions(nf);
+    double temp = omga2;
+    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
+    double fs2 = M12 * temp;
+
+    // 调用通用 PWD 计算内核: 每种边界只求解一次，同边界的变井储/恒定井储模型共用结果
+    bool needed[BoundaryCount] = { false, false, false };
+    for (int c = 0; c < count; ++c) needed[boundaryOf(types[c])] = true;
+    double pwd[BoundaryCount] = { 0.0, 0.0, 0.0 };
+    double pwdError[BoundaryCount] = { 0.0, 0.0, 0.0 };
+    PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, needed, pwd, stats, floatError ? pwdError : nullptr);
+
+    // 考虑井筒储存和表皮，仅对变井储模型 (1, 3, 5) 启用
+    double CD = p.value("cD", 0.0);
+    double S = p.value("S", 0.0);
+    for (int c = 0; c < count; ++c) {
+        double pf = pwd[boundaryOf(types[c])];
+        bool hasStorage = (types[c] == Model_1 || types[c] == Model_3 || types[c] == Model_5);
+        double err = pwdError[boundaryOf(types[c])];
+        if (hasStorage) {
+            double gain;
+            pf = withStorage(z, pf, CD, S, &gain);
+            err *= gain;
+        }
+        out[c] = pf;
+        if (floatError) floatError[c] = err;
+    }
+}
+
+ModelSolver01_06::Boundary ModelSolver01_06::boundaryOf(ModelType type)
+{
+    if (type == Model_3 || type == Model_4) return Boundary_Closed;
+    if (type == Model_5 || type == Model_6) return Boundary_ConstP;
+    return Boundary_Infinite;
+}
+
+void ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD,
+                                     const bool needed[BoundaryCount], double out[BoundaryCount], EngineStats* stats,
+                                     double floatError[BoundaryCount]) const {
+    QElapsedTimer timer;
+    if (stats) timer.start();
+    QVector<double> ywD(nf, 0.0);
+    double gama1 = sqrt(z * fs1);
+    double gama2 = sqrt(z * fs2);
+    double arg_g1_rm = gama1 * rmD;
+
+    // 边界条件因子: Ac_prefactor = Ac * exp(arg_g1_rm)
+    double Ac_prefactor[BoundaryCount];
+    double weightI = boundaryFactors(M12, gama1, gama2, rmD, reD, Ac_prefactor);
+
+    // 一次计算一条 Gauss 公式的全部节点；单精度内核时整批转为 float 计算
+    auto kernel = [&](const double* dist, int n, double* k, double* i) {
+        if (stats) stats->integrandCalls += n;
+        if (m_floatKernel) {
+            float xf[kMaxRuleNodes], kf[kMaxRuleNodes], fi[kMaxRuleNodes];
+            for (int j = 0; j < n; ++j) xf[j] = float(std::max(gama1 * dist[j], 1e-10));
+            besselK0I0Float(xf, n, float(arg_g1_rm), kf, fi);
+            for (int j = 0; j < n; ++j) { k[j] = kf[j]; i[j] = fi[j]; }
+            return;
+        }
+        kernelNodes(dist, n, gama1, arg_g1_rm, k, i);
+    };
+    const double quadTolerance = m_floatKernel ? std::max(m_quadTolerance, kFloatQuadTolerance) : m_quadTolerance;
+
+    auto influence = [&](double dx, double dy, double& ik, double& ii) {
+        influenceIntegral(kernel, dx, dy, LfD, gama1 * LfD, quadTolerance, weightI, m_quadMaxDepth, ik, ii, stats);
+    };
+
+    // 求解线性方程组
+    // 原方程组 [A -1; z*1' 0][q; p] = [0; 1] 消去 p 后: A*y = 1, p = 1/(z*sum(y))
+    // A = (K + Ac_prefactor * I) / (M12 * 2 * LfD)，K、I 两个积分矩阵由各边界共用
+    double coef = 1.0 / (M12 * 2 * LfD);
+    Eigen::VectorXd ones = Eigen::VectorXd::Ones(nf);
+
+    // 裂缝等间距且共线时 A 为对称 Toeplitz 矩阵，只需按间隔计算 nf 个不同的积分
+    bool toeplitz = (nf > 1);
+    double step = (nf > 1) ? xwD[1] - xwD[0] : 0.0;
+    for (int i = 1; i < nf && toeplitz; ++i) {
+        toeplitz = std::abs(xwD[i] - xwD[i - 1] - step) < 1e-12 * std::max(1.0, std::abs(step)) && ywD[i] == ywD[0];
+    }
+
+    // 直接解法 (统计模式下记录条件数估计 1/rcond)
+    auto directSolve = [&](const Eigen::MatrixXd& A_mat) -> Eigen::VectorXd {
+        Eigen::FullPivLU<Eigen::MatrixXd> lu(A_mat);
+        if (stats) {
+            ++stats->directSolves;
+            double rcond = lu.rcond();
+            stats->maxConditionEstimate = std::max(stats->maxConditionEstimate, rcond > 0.0 ? 1.0 / rcond : std::numeric_limits<double>::infinity());
+        }
+        return lu.solve(ones);
+    };
+
+    // 单精度内核的一阶误差上界 (逐元素): 积分矩阵元素误差 |δA| <= kFloatKernelError * (|K|+|Ac||I|) 时，
+    // Δ(Σy) = -wᵀ δA y (w 为伴随解 Aᵀw = 1)，故 |Δp/p| <= kFloatKernelError * |w|ᵀ (|K|+|Ac||I|) |y| / |Σy|
+    bool trackFloat = m_floatKernel && floatError;
+    auto floatErrorBound = [&](const Eigen::MatrixXd& A_abs, const Eigen::VectorXd& y, const Eigen::VectorXd& w) {
+        return kFloatKernelError * w.cwiseAbs().dot(A_abs * y.cwiseAbs()) / std::abs(y.sum());
+    };
+
+    qint64 solveStart = 0;
+    if (toeplitz) {
+        Eigen::VectorXd colK(nf), colI(nf);
+        for (int k = 0; k < nf; ++k) {
+            if (isCancelled()) return;
+            influence(k * step, 0.0, colK(k), colI(k));
+        }
+        if (stats) solveStart = timer.nsecsElapsed();
+
+        for (int bc = 0; bc < BoundaryCount; ++bc) {
+            if (!needed[bc]) continue;
+            Eigen::VectorXd col = (colK + Ac_prefactor[bc] * colI) * coef;
+            Eigen::VectorXd y;
+            if (nf > kDirectSolveMaxStages) {
+                int iterations = 0;
+                y = solveToeplitzGmres(col, ones, &iterations);
+                if (stats) {
+                    ++stats->iterativeSolves;
+                    stats->gmresIterations += iterations;
+                    if (y.size() != nf) ++stats->gmresFallbacks;
+                }
+            }
+            if (y.size() != nf) {
+                Eigen::MatrixXd A_mat(nf, nf);
+                for (int i = 0; i < nf; ++i)
+                    for (int j = 0; j < nf; ++j) A_mat(i, j) = col(std::abs(i - j));
+                y = directSolve(A_mat);
+            }
+            if (trackFloat) {
+                // 对称 Toeplitz 矩阵的伴随解即 y
+                Eigen::VectorXd colAbs = (colK.cwiseAbs() + std::abs(Ac_prefactor[bc]) * colI.cwiseAbs()) * coef;
+                Eigen::MatrixXd A_abs(nf, nf);
+                for (int i = 0; i < nf; ++i)
+                    for (int j = 0; j < nf; ++j) A_abs(i, j) = colAbs(std::abs(i - j));
+                floatError[bc] = floatErrorBound(A_abs, y, y);
+            }
+            out[bc] = 1.0 / (z * y.sum());
+        }
+    } else {
+        Eigen::MatrixXd K_mat(nf, nf), I_mat(nf, nf);
+        for (int i = 0; i < nf; ++i) {
+            if (isCancelled()) return;
+            for (int j = 0; j < nf; ++j) influence(xwD[i] - xwD[j], ywD[i] - ywD[j], K_mat(i, j), I_mat(i, j));
+        }
+        if (stats) solveStart = timer.nsecsElapsed();
+
+        for (int bc = 0; bc < BoundaryCount; ++bc) {
+            if (!needed[bc]) continue;
+            Eigen::MatrixXd A_mat = (K_mat + Ac_prefactor[bc] * I_mat) * coef;
+            Eigen::VectorXd y = directSolve(A_mat);
+            if (trackFloat) {
+                Eigen::VectorXd w = A_mat.transpose().fullPivLu().solve(ones);
+                floatError[bc] = floatErrorBound((K_mat.cwiseAbs() + std::abs(Ac_prefactor[bc]) * I_mat.cwiseAbs()) * coef, y, w);
+            }
+            out[bc] = 1.0 / (z * y.sum());
+        }
+    }
+
+    if (stats) {
+        stats->quadratureMs += solveStart / 1e6;
+        stats->solveMs += (timer.nsecsElapsed() - solveStart) / 1e6;
+    }
+}
+
+// ===========================================================================
+// 参数灵敏度 (前向自动微分)
+// Ac、被积函数、积分规则选择与自适应细分、井筒储存与 double 路径共用同一组模板 (T = Dual)，分段与细分只按函数值判断，
+// 因此函数值与 double 路径一致，导数是同一离散化结果的精确导数。
+// 此处只保留自动微分专有的部分: 参数装配、Toeplitz 方程组 (直接求解，以二次型给出 d(Σy)) 与 Stehfest 反演；
+// 单精度内核、GMRES 与非 Toeplitz 分支只在 double 路径中
+// ===========================================================================
+
+namespace {
+
+struct DualKernel {
+    Dual kf, km, LfD, rmD, reD, omega1, omega2, lambda1, cD, S;
+    int nf;
+    int boundary;          // 0 无限大、1 封闭、2 定压 (与 ModelSolver01_06::Boundary 一致)
+    bool hasStorage;       // 变井储模型 (1, 3, 5)
+    double quadTolerance;
+    int quadMaxDepth;
+    const std::atomic<bool>* cancel;
+};
+
+// 单一模型的拉普拉斯解 (裂缝等间距共线，矩阵为对称 Toeplitz)
+Dual laplaceDual(const Dual& z, const DualKernel& p)
+{
+    Dual M12 = p.kf / p.km;
+    Dual fs1 = p.omega1 + p.lambda1 * p.omega2 / (p.lambda1 + z * p.omega2);
+    Dual fs2 = M12 * p.omega2;
+    Dual gama1 = sqrt(z * fs1), gama2 = sqrt(z * fs2);
+    Dual argG1 = gama1 * p.rmD;
+
+    // 三种边界的 Ac 全部计算: 积分判据取三者的最大值，与 double 路径一致
+    Dual Ac[3];
+    double weightI = boundaryFactors(M12, gama1, gama2, p.rmD, p.reD, Ac);
+    const Dual& ac = Ac[p.boundary];
+
+    auto kernel = [&](const Dual* dist, int n, Dual* k, Dual* i) { kernelNodes(dist, n, gama1, argG1, k, i); };
+    auto influence = [&](double dx, Dual& ik, Dual& ii) {
+        influenceIntegral(kernel, dx, 0.0, p.LfD, gama1.v * p.LfD.v, p.quadTolerance, weightI, p.quadMaxDepth, ik, ii, nullptr);
+    };
+
+    // A y = 1，p = 1/(z Σy)。A 对称，故 d(Σy) = -yᵀ dA y，每个方向只需一次二次型，不必再解方程
+    int nf = p.nf;
+    // 与 double 路径的 Toeplitz 分支相同的裂缝间距
+    QVector<double> xwD = ModelSolver01_06::fracturePositions(nf);
+    double step = nf > 1 ? xwD[1] - xwD[0] : 0.0;
+    Dual coef = 1.0 / (M12 * 2.0 * p.LfD);
+    QVector<Dual> col(nf);
+    for (int k = 0; k < nf; ++k) {
+        if (p.cancel && p.cancel->load(std::memory_order_relaxed)) return Dual(0.0);
+        Dual ik, ii;
+        influence(k * step, ik, ii);
+        col[k] = (ik + ac * ii) * coef;
+    }
+    Eigen::MatrixXd A(nf, nf);
+    for (int i = 0; i < nf; ++i)
+        for (int j = 0; j < nf; ++j) A(i, j) = col[std::abs(i - j)].v;
+    Eigen::VectorXd y = A.partialPivLu().solve(Eigen::VectorXd::Ones(nf));
+    Dual sum(y.sum());
+    for (const Dual& c : col) sum.n = std::max(sum.n, c.n);
+    for (int d = 0; d < sum.n; ++d) {
+        double q = 0.0;
+        for (int i = 0; i < nf; ++i)
+            for (int j = 0; j < nf; ++j) q += y(i) * col[std::abs(i - j)].dir(d) * y(j);
+        sum.d[d] = -q;
+    }
+    Dual pf = 1.0 / (z * sum);
+
+    return p.hasStorage ? withStorage(z, pf, p.cD, p.S) : pf;
+}
+
+} // namespace
+
+bool ModelSolver01_06::isDifferentiable(const QString& name)
+{
+    static const QStringList names = { "kf", "km", "L", "Lf", "LfD", "rmD", "reD", "omega1", "omega2", "lambda1", "gamaD", "cD", "S",
+                                       "phi", "mu", "B", "Ct", "q", "h" };
+    return names.contains(name);
+}
+
+bool ModelSolver01_06::calculatePressureSensitivities(const QMap<QString, double>& params, const QStringList& names, const QVector<double>& t,
+                                                      QVector<double>& p, QVector<QVector<double>>& dp) const
+{
+    int nd = names.size();
+    if (nd > Dual::kMaxDirections) return false;
+    for (const QString& name : names) {
+        if (!isDifferentiable(name)) return false;
+    }
+
+    // 被求导的参数为自变量，其余为常数 (默认值与 double 路径一致)
+    auto value = [&](const QString& name, double def) {
+        int j = names.indexOf(name);
+        double v = params.value(name, def);
+        return j >= 0 ? Dual::variable(v, nd, j) : Dual(v);
+    };
+
+    DualKernel k;
+    k.kf = value("kf", 0.0);
+    k.km = value("km", 0.0);
+    k.rmD = value("rmD", 0.0);
+    k.reD = value("reD", 0.0);
+    k.omega1 = value("omega1", 0.0);
+    k.omega2 = value("omega2", 0.0);
+    k.lambda1 = value("lambda1", 0.0);
+    k.cD = value("cD", 0.0);
+    k.S = value("S", 0.0);
+    // LfD = Lf / L: 对 L 或 Lf 求导时经由 LfD 传递
+    bool derivedLfD = !names.contains("LfD") && (names.contains("L") || names.contains("Lf")) &&
+                      params.contains("L") && params.contains("Lf") && params.value("L") > 1e-9;
+    k.LfD = derivedLfD ? value("Lf", 0.0) / value("L", 0.0) : value("LfD", 0.0);
+    k.nf = std::max(1, (int)params.value("nf", 4));
+    k.boundary = boundaryOf(m_type);
+    k.hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
+    k.quadTolerance = m_quadTolerance;
+    k.quadMaxDepth = m_quadMaxDepth;
+    k.cancel = m_cancel;
+    Dual gamaD = value("gamaD", 0.0);
+
+    // 量纲换算 (与 dimensionalScales 相同)
+    Dual kf = value("kf", 1e-3), L = value("L", 1000.0), mu = value("mu", 0.5);
+    Dual tScale = 14.4 * kf / (value("phi", 0.05) * mu * value("Ct", 5e-4) * L * L);
+    Dual pScale = 1.842e-3 * value("q", 5.0) * mu * value("B", 1.05) / (kf * value("h", 20.0));
+
+    int N = m_highPrecision ? (int)params.value("N", 4) : 4;
+    if (N % 2 != 0) N = 4;
+    double ln2 = std::log(2.0);
+
+    p = QVector<double>(t.size(), 0.0);
+    dp = QVector<QVector<double>>(nd, QVector<double>(t.size(), 0.0));
+    for (int i = 0; i < t.size(); ++i) {
+        if (isCancelled()) return false;
+        Dual tD = tScale * t[i];
+        if (tD.v <= 1e-12) continue;
+        Dual sum(0.0);
+        for (int m = 1; m <= N; ++m) {
+            if (isCancelled()) return false;
+            Dual f = laplaceDual(m * ln2 / tD, k);
+            if (std::isnan(f.v) || std::isinf(f.v)) continue;
+            sum += stefestCoefficient(m, N) * f;
+        }
+        Dual pd = sum * ln2 / tD;
+        if (std::abs(gamaD.v) > 1e-9) {
+            Dual arg = 1.0 - gamaD * pd;
+            if (arg.v > 1e-12) pd = -1.0 / gamaD * log(arg);
+        }
+        Dual dpv = pScale * pd;
+        p[i] = dpv.v;
+        for (int j = 0; j < nd; ++j) dp[j][i] = dpv.dir(j);
+    }
+    return true;
+}
+
+double ModelSolver01_06::scaled_besseli(int v, double x) { return scaledBesselI(v, x); }
+void ModelSolver01_06::adaptiveGauss(const NodeIntegrand& f, double a, double b, double eps, double weightI, int depth, int maxDepth,
+                                     double& sk, double& si, EngineStats* stats) {
+    adaptiveQuadrature(f, a, b, eps, weightI, depth, maxDepth, sk, si, stats);
+}
+double ModelSolver01_06::stefestCoefficient(int i, int N) {
+    double s = 0.0; int k1 = (i + 1) / 2; int k2 = std::min(i, N / 2);
+    for (int k = k1; k <= k2; ++k) {
+        double num = pow(k, N / 2.0) * factorial(2 * k);
+        double den = factorial(N / 2 - k) * factorial(k) * factorial(k - 1) * factorial(i - k) * factorial(2 * k - i);
+        if(den!=0) s += num/den;
+    }
+    return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * s;
+}
+double ModelSolver01_06::factorial(int n) { if(n<=1)return 1; double r=1; for(int i=2;i<=n;++i)r*=i; return r; }
@@ -0,0 +1,181 @@
+/*
+ * modelsolver01-06.h
+ * 文件作用：压裂水平井复合页岩油模型 (Model 1-6) 计算内核头文件
+ * 功能描述：
+ * 1. 从 ModelWidget01_06 中剥离出的纯计算类，不依赖任何界面控件
+ * 2. 所有计算接口均为 const 且无共享可变状态，可在线程池中并发调用
+ * 3. 提供引擎专用线程池，供敏感性分析、拟合等批量计算使用
+ */
+
+#ifndef MODELSOLVER01_06_H
+#define MODELSOLVER01_06_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <tuple>
+#include <functional>
+#include <atomic>
+
+class QThreadPool;
+
+// 类型定义: <时间, 压力, 导数>
+using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
+
+// 引擎统计 (可选): 计算接口传入非空指针时逐项累加，用于定位慢速或数值不安全的参数区域
+// 不传时内核不做任何计数与计时
+struct EngineStats {
+    qint64 laplaceEvaluations = 0;     // 拉普拉斯空间求值次数 (每个 z 一次，多模型一次计算也只计一次)
+    qint64 integrandCalls = 0;         // 裂缝积分被积函数调用次数 (每次含 K0、I0 各一次)
+    qint64 adaptiveIntegrals = 0;      // 近场自适应积分次数
+    qint64 fixedRuleIntegrals = 0;     // 远场固定阶 Gauss 积分次数
+    QVector<qint64> depthHistogram;    // 自适应积分接受区间时的细分层数分布 (下标为层数)
+    qint64 maxDepthHits = 0;           // 达到最大细分层数仍未满足容差的区间数
+    qint64 nanReplacements = 0;        // 拉普拉斯解为 NaN/Inf 而被置零的次数
+    qint64 directSolves = 0;           // 直接 LU 求解次数
+    qint64 iterativeSolves = 0;        // GMRES 求解次数
+    qint64 gmresIterations = 0;        // GMRES 累计迭代次数
+    qint64 gmresFallbacks = 0;         // GMRES 未收敛、改用直接解法的次数
+    double maxConditionEstimate = 0.0; // 直接求解时条件数估计 (1/rcond) 的最大值
+    double maxFloatErrorBound = 0.0;   // 单精度内核: pD 相对双精度路径的相对误差上界 (各时间点最大值)
+
+    // 各阶段耗时 (毫秒；分块并发计算合并后为各线程耗时之和)
+    double quadratureMs = 0.0;         // 裂缝积分
+    double solveMs = 0.0;              // 线性方程组
+    double inversionMs = 0.0;          // Stehfest 反演 (含积分与求解)
+    double derivativeMs = 0.0;         // Bourdet 导数
+    double totalMs = 0.0;              // 整体
+
+    void addDepth(int depth, bool hitMaxDepth);
+    void merge(const EngineStats& other);
+    // 多行文本摘要，供界面显示
+    QString summary() const;
+};
+
+class ModelSolver01_06
+{
+    // 基准测试 (benchmark/) 需要单独计时内核各部分
+    friend class EngineBenchmark;
+
+public:
+    enum ModelType {
+        Model_1 = 0, // 无限大 + 变井储
+        Model_2,     // 无限大 + 恒定井储
+        Model_3,     // 封闭边界 + 变井储
+        Model_4,     // 封闭边界 + 恒定井储
+        Model_5,     // 定压边界 + 变井储
+        Model_6      // 定压边界 + 恒定井储
+    };
+
+    explicit ModelSolver01_06(ModelType type);
+
+    ModelType getModelType() const { return m_type; }
+
+    // 设置是否使用高精度 Stehfest 反演 (对应 MATLAB 中的 N=8)
+    void setHighPrecision(bool high);
+    bool isHighPrecision() const { return m_highPrecision; }
+
+    // 裂缝积分 (自适应 Gauss-Kronrod) 的容差与最大细分层数，默认 1e-5 / 10；预览时可放宽以换取速度
+    void setQuadrature(double eps, int maxDepth);
+    double quadratureTolerance() const { return m_quadTolerance; }
+    int quadratureMaxDepth() const { return m_quadMaxDepth; }
+
+    // 单精度内核 (预览用): 裂缝积分的被积函数与 K0/I0 以 float 多项式近似成批计算 (可按 SIMD 宽度向量化)，
+    // 积分求和、线性方程组与 Stehfest 反演仍为 double；积分容差不低于 1e-5。
+    // 相对双精度路径的误差上界见 EngineStats::maxFloatErrorBound
+    void setSinglePrecisionKernel(bool on);
+    bool isSinglePrecisionKernel() const { return m_floatKernel; }
+
+    // 协作取消: flag 置位后正在进行的计算在下一个时间点 / Stehfest 项 / 裂缝积分处返回，结果不完整，调用方应丢弃
+    // flag 由调用方持有 (副本共享同一 flag)，须在本对象及其副本使用期间保持有效；为空表示不可取消
+    void setCancelFlag(const std::atomic<bool>* flag) { m_cancel = flag; }
+    bool isCancelled() const { return m_cancel && m_cancel->load(std::memory_order_relaxed); }
+
+    // 计算理论曲线 (线程安全，可并发调用)
+    // stats 非空时累加本次计算的引擎统计
+    ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>(),
+                                             EngineStats* stats = nullptr) const;
+
+    // 计算无因次曲线 <tD, pD, dpD/dlntD> (不做单位换算，供类型曲线图版使用)
+    // 无因次参数中 M12 由 kf/km 给出，可直接设置 kf = M12, km = 1
+    ModelCurveData calculateDimensionlessCurve(const QMap<QString, double>& params, const QVector<double>& tD, EngineStats* stats = nullptr) const;
+
+    // 一次计算多个模型的理论曲线，返回顺序与 types 一致 (仅使用本对象的精度设置，忽略自身模型类型)
+    // 各模型共享 gama1/gama2、Bessel 值与裂缝段积分，同边界的两个模型只求解一次；六个模型的耗时接近单个模型
+    QVector<ModelCurveData> calculateTheoreticalCurves(const QMap<QString, double>& params, const QVector<ModelType>& types,
+                                                       const QVector<double>& providedTime = QVector<double>(), EngineStats* stats = nullptr) const;
+    QVector<ModelCurveData> calculateDimensionlessCurves(const QMap<QString, double>& params, const QVector<ModelType>& types,
+                                                         const QVector<double>& tD, EngineStats* stats = nullptr) const;
+
+    // 仅计算无因次压力 pD (各时间点相互独立，可将时间序列分块并发计算)
+    QVector<double> calculateDimensionlessPressure(const QMap<QString, double>& params, const QVector<double>& tD, EngineStats* stats = nullptr) const;
+    // 仅计算有因次压差 Δp (不求导数)，供分块计算使用
+    QVector<double> calculatePressure(const QMap<QString, double>& params, const QVector<double>& t, EngineStats* stats = nullptr) const;
+
+    // 参数灵敏度 (前向自动微分): Δp(t) 及其对 names 中各参数的偏导 dp[j][i] = ∂Δp(t_i)/∂names[j]
+    // 一次计算得到曲线与全部偏导，导数为离散化结果的精确导数；LfD 由 L、Lf 给出时对二者的偏导经由 LfD 传递
+    // 始终为 double 内核 (忽略单精度内核设置)；names 含不可微参数或超过 Dual::kMaxDirections 个时返回 false
+    // 各时间点相互独立，可分块并发计算；导数曲线的偏导为 bourdetDerivative(t, dp[j]) (Bourdet 导数对 Δp 线性)
+    bool calculatePressureSensitivities(const QMap<QString, double>& params, const QStringList& names, const QVector<double>& t,
+                                        QVector<double>& p, QVector<QVector<double>>& dp) const;
+    // 可由 calculatePressureSensitivities 求导的参数 (nf、N 等整数参数除外)
+    static bool isDifferentiable(const QString& name);
+
+    // Bourdet 导数 (与 calculateTheoreticalCurve 内部一致，L = 0.1)；点数不足 3 时返回全零
+    static QVector<double> bourdetDerivative(const QVector<double>& t, const QVector<double>& p);
+
+    // 有因次/无因次换算系数: tD = tScale * t, Δp = pScale * pD
+    static void dimensionalScales(const QMap<QString, double>& params, double& tScale, double& pScale);
+
+    // 静态工具: 生成对数时间步长
+    static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
+
+    // 静态工具: nf 条裂缝的无因次位置 xwD (等间距分布于 [-0.9, 0.9]，单条裂缝位于 0)，double 与自动微分路径共用
+    static QVector<double> fracturePositions(int nf);
+
+    // 引擎专用线程池
+    // 与 QThreadPool::globalInstance() 分离，避免拟合任务 (运行于全局池) 等待引擎任务时互相占满线程
+    static QThreadPool* enginePool();
+
+private:
+    // 外边界类型 (Model 1/2、3/4、5/6 分别对应)
+    enum Boundary { Boundary_Infinite = 0, Boundary_Closed, Boundary_ConstP, BoundaryCount };
+    static Boundary boundaryOf(ModelType type);
+
+    // 成批被积函数 f(a, n, k, i): 一次给出 n 个节点 (n <= 15) 上的 K0 项与 I0 项
+    using NodeIntegrand = std::function<void(const double* a, int n, double* k, double* i)>;
+
+    // 数学计算核心 (Stehfest 反演循环)，同时反演 types 中各模型的拉普拉斯解
+    void calculatePD(const QVector<double>& tD, const QMap<QString, double>& params, const ModelType* types, int count,
+                     QVector<QVector<double>>& outPD, EngineStats* stats) const;
+
+    // 拉普拉斯空间解 (复合模型通用入口)；同一 z 下多个模型一次求出，out[c] 对应 types[c]
+    // floatError 非空且启用单精度内核时写入各模型拉普拉斯值的相对误差上界
+    void flaplace_composite(double z, const QMap<QString, double>& p, const ModelType* types, int count, double* out, EngineStats* stats,
+                            double* floatError = nullptr) const;
+
+    // PWD 核心计算 (包含边界条件处理 Logic from MATLAB PWD_inf)
+    // 积分只算一次，needed 中标记的各边界分别求解，结果写入 out[边界]
+    void PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD,
+                       const bool needed[BoundaryCount], double out[BoundaryCount], EngineStats* stats,
+                       double floatError[BoundaryCount] = nullptr) const;
+
+    // 数学工具函数 (对应 MATLAB 内置函数或逻辑)
+    static double scaled_besseli(int v, double x); // 缩放 Bessel I
+    // 自适应 15 点 Gauss (内核所用模板的 double 实例，供基准测试单独计时)
+    static void adaptiveGauss(const NodeIntegrand& f, double a, double b, double eps, double weightI, int depth, int maxDepth,
+                              double& sk, double& si, EngineStats* stats);
+    static double stefestCoefficient(int i, int N);
+    static double factorial(int n);
+
+private:
+    ModelType m_type;
+    bool m_highPrecision;
+    double m_quadTolerance;
+    int m_quadMaxDepth;
+    bool m_floatKernel;
+    const std::atomic<bool>* m_cancel;
+};
+
+#endif // MODELSOLVER01_06_H
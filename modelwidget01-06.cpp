@@ -7,16 +7,14 @@
  * 4. Model 4: 压裂水平井复合页岩油 - 封闭边界 + 恒定井储 (对应 MATLAB: mAB=K1/I1, CD/S=0)
  * 5. Model 5: 压裂水平井复合页岩油 - 定压边界 + 变井储表皮 (对应 MATLAB: mAB=-K0/I0, CD/S non-zero)
  * 6. Model 6: 压裂水平井复合页岩油 - 定压边界 + 恒定井储 (对应 MATLAB: mAB=-K0/I0, CD/S=0)
+ * 数学计算内核见 modelsolver01-06.cpp，本文件只负责界面与计算调度。
  */
 
 #include "modelwidget01-06.h"
 #include "ui_modelwidget01-06.h"
 #include "modelmanager.h"
-#include "pressurederivativecalculator.h"
 #include "modelparameter.h"
-
-#include <Eigen/Dense>
-#include <boost/math/special_functions/bessel.hpp>
+#include "typecurveatlasdialog.h"
 
 #include <cmath>
 #include <algorithm>
@@ -25,17 +23,18 @@
 #include <QFileDialog>
 #include <QTextStream>
 #include <QDateTime>
-#include <QCoreApplication>
+#include <QtConcurrent>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+// 图版插值预览的误差容差 (对数压力，约等于相对误差)
+static const double kPreviewTolerance = 0.05;
 
 ModelWidget01_06::ModelWidget01_06(ModelType type, QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::ModelWidget01_06)
     , m_type(type)
-    , m_highPrecision(true)
+    , m_solver(type)
+    , m_sweepDoneCount(0)
+    , m_sweepCollectStats(false)
 {
     ui->setupUi(this);
     m_colorList = { Qt::red, Qt::blue, QColor(0,180,0), Qt::magenta, QColor(255,140,0), Qt::cyan };
@@ -46,7 +45,13 @@ ModelWidget01_06::ModelWidget01_06(ModelType type, QWidget *parent)
     onResetParameters();
 }
 
-ModelWidget01_06::~ModelWidget01_06() { delete ui; }
+ModelWidget01_06::~ModelWidget01_06()
+{
+    // 析构前取消并等待后台扫描，避免回调访问已释放的界面
+    m_sweepWatcher.cancel();
+    m_sweepWatcher.waitForFinished();
+    delete ui;
+}
 
 QString ModelWidget01_06::getModelName() const {
     switch(m_type) {
@@ -131,6 +136,7 @@ void ModelWidget01_06::initChart() {
 
 void ModelWidget01_06::setupConnections() {
     connect(ui->calculateButton, &QPushButton::clicked, this, &ModelWidget01_06::onCalculateClicked);
+    connect(ui->stopButton, &QPushButton::clicked, this, &ModelWidget01_06::onStopClicked);
     connect(ui->resetButton, &QPushButton::clicked, this, &ModelWidget01_06::onResetParameters);
     connect(ui->btnExportData, &QPushButton::clicked, this, &ModelWidget01_06::onExportData);
     connect(ui->btnExportImage, &QPushButton::clicked, this, &ModelWidget01_06::onExportImage);
@@ -140,9 +146,28 @@ void ModelWidget01_06::setupConnections() {
     connect(ui->LEdit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onDependentParamsChanged);
     connect(ui->LfEdit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onDependentParamsChanged);
     connect(ui->checkShowPoints, &QCheckBox::toggled, this, &ModelWidget01_06::onShowPointsToggled);
+    connect(ui->btnTypeCurveAtlas, &QPushButton::clicked, this, &ModelWidget01_06::onOpenAtlas);
+
+    // 参数编辑完成后刷新图版预览 (未加载图版时直接返回)
+    const QList<QLineEdit*> paramEdits = {
+        ui->phiEdit, ui->hEdit, ui->muEdit, ui->BEdit, ui->CtEdit, ui->qEdit, ui->tEdit, ui->pointsEdit,
+        ui->kfEdit, ui->kmEdit, ui->LEdit, ui->LfEdit, ui->nfEdit, ui->rmDEdit, ui->omga1Edit, ui->omga2Edit,
+        ui->remda1Edit, ui->gamaDEdit, ui->reDEdit, ui->cDEdit, ui->sEdit
+    };
+    for (QLineEdit* edit : paramEdits) {
+        connect(edit, &QLineEdit::editingFinished, this, &ModelWidget01_06::updatePreview);
+        connect(edit, &QLineEdit::editingFinished, this, &ModelWidget01_06::onLiveParamsChanged);
+    }
+    connect(ui->checkLiveCalc, &QCheckBox::toggled, this, &ModelWidget01_06::onLiveCalcToggled);
+    connect(&m_liveRunner, &ProgressiveCurveRunner::stageReady, this, &ModelWidget01_06::onLiveStageReady);
+
+    connect(&m_sweepWatcher, &QFutureWatcherBase::resultReadyAt, this, &ModelWidget01_06::onSweepResultReady);
+    connect(&m_sweepWatcher, &QFutureWatcherBase::finished, this, &ModelWidget01_06::onSweepFinished);
+    connect(&m_sweepWatcher, &QFutureWatcherBase::progressRangeChanged, ui->calcProgressBar, &QProgressBar::setRange);
+    connect(&m_sweepWatcher, &QFutureWatcherBase::progressValueChanged, ui->calcProgressBar, &QProgressBar::setValue);
 }
 
-void ModelWidget01_06::setHighPrecision(bool high) { m_highPrecision = high; }
+void ModelWidget01_06::setHighPrecision(bool high) { m_solver.setHighPrecision(high); }
 
 QVector<double> ModelWidget01_06::parseInput(const QString& text) {
     QVector<double> values;
@@ -224,17 +249,36 @@ void ModelWidget01_06::onShowPointsToggled(bool checked) {
 }
 
 void ModelWidget01_06::onCalculateClicked() {
-    ui->calculateButton->setEnabled(false);
-    ui->calculateButton->setText("计算中...");
-    QCoreApplication::processEvents();
+    if (m_sweepWatcher.isRunning()) return;
     runCalculation();
-    ui->calculateButton->setEnabled(true);
-    ui->calculateButton->setText("开始计算");
 }
 
-void ModelWidget01_06::runCalculation() {
-    m_plot->clearGraphs();
+void ModelWidget01_06::onStopClicked() {
+    if (!m_sweepWatcher.isRunning()) return;
+    ui->stopButton->setEnabled(false);
+    ui->stopButton->setText("正在停止...");
+    m_sweepWatcher.cancel();
+}
+
+void ModelWidget01_06::setCalculatingState(bool running) {
+    ui->calculateButton->setEnabled(!running);
+    ui->calculateButton->setText(running ? "计算中..." : "开始计算");
+    ui->stopButton->setEnabled(running);
+    ui->stopButton->setText("停止计算");
+}
 
+QList<QColor> ModelWidget01_06::generateColorRamp(int n) const {
+    if (n <= m_colorList.size()) return m_colorList.mid(0, n);
+    // 色相从红 (0) 到品红 (300) 均匀分布，避免首尾颜色相近
+    QList<QColor> colors;
+    for (int i = 0; i < n; ++i) {
+        int hue = (n > 1) ? (300 * i / (n - 1)) : 0;
+        colors.append(QColor::fromHsv(hue, 230, 210));
+    }
+    return colors;
+}
+
+QMap<QString, QVector<double>> ModelWidget01_06::collectRawParameters() {
     QMap<QString, QVector<double>> rawParams;
     rawParams["phi"] = parseInput(ui->phiEdit->text());
     rawParams["h"] = parseInput(ui->hEdit->text());
@@ -265,6 +309,37 @@ void ModelWidget01_06::runCalculation() {
         rawParams["cD"] = {0.0};
         rawParams["S"] = {0.0};
     }
+    return rawParams;
+}
+
+QMap<QString, double> ModelWidget01_06::currentParameters() {
+    QMap<QString, QVector<double>> rawParams = collectRawParameters();
+    QMap<QString, double> params;
+    for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
+        params[it.key()] = it.value().isEmpty() ? 0.0 : it.value().first();
+    }
+    params["N"] = m_solver.isHighPrecision() ? 8.0 : 4.0;
+    if(params["L"] > 1e-9) params["LfD"] = params["Lf"] / params["L"];
+    else params["LfD"] = 0;
+    return params;
+}
+
+QVector<double> ModelWidget01_06::calculationTimeSteps(const QMap<QString, double>& baseParams) const {
+    int nPoints = ui->pointsEdit->text().toInt();
+    if(nPoints < 5) nPoints = 5;
+
+    double maxTime = baseParams.value("t", 1000.0);
+    if(maxTime < 1e-3) maxTime = 1000.0;
+    return ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
+}
+
+void ModelWidget01_06::runCalculation() {
+    m_liveRunner.cancel();
+    m_plot->clearGraphs();
+    m_overlayGraphs.clear();
+    m_previewGraphs.clear();
+
+    QMap<QString, QVector<double>> rawParams = collectRawParameters();
 
     // 敏感性分析检测
     QString sensitivityKey = "";
@@ -279,61 +354,168 @@ void ModelWidget01_06::runCalculation() {
     }
     bool isSensitivity = !sensitivityKey.isEmpty();
 
-    QMap<QString, double> baseParams;
-    for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
-        baseParams[it.key()] = it.value().isEmpty() ? 0.0 : it.value().first();
-    }
-    baseParams["N"] = m_highPrecision ? 8.0 : 4.0;
-    if(baseParams["L"] > 1e-9) baseParams["LfD"] = baseParams["Lf"] / baseParams["L"];
-    else baseParams["LfD"] = 0;
+    QMap<QString, double> baseParams = currentParameters();
 
-    int nPoints = ui->pointsEdit->text().toInt();
-    if(nPoints < 5) nPoints = 5;
+    QVector<double> t = calculationTimeSteps(baseParams);
 
-    double maxTime = baseParams.value("t", 1000.0);
-    if(maxTime < 1e-3) maxTime = 1000.0;
-    QVector<double> t = ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
-
-    int iterations = isSensitivity ? sensitivityValues.size() : 1;
-    iterations = qMin(iterations, (int)m_colorList.size());
-
-    QString resultTextHeader = QString("计算完成 (%1)\n").arg(getModelName());
-    if(isSensitivity) resultTextHeader += QString("敏感性参数: %1\n").arg(sensitivityKey);
-
-    for(int i = 0; i < iterations; ++i) {
-        QMap<QString, double> currentParams = baseParams;
-        double val = 0;
-        if (isSensitivity) {
-            val = sensitivityValues[i];
+    // 构建每条曲线的参数 (敏感性取值数量不受色表大小限制)
+    QVector<QMap<QString, double>> sweepParams;
+    if (isSensitivity) {
+        for (double val : sensitivityValues) {
+            QMap<QString, double> currentParams = baseParams;
             currentParams[sensitivityKey] = val;
             if (sensitivityKey == "L" || sensitivityKey == "Lf") {
                 if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
             }
+            sweepParams.append(currentParams);
+        }
+    } else {
+        sweepParams.append(baseParams);
+    }
+
+    m_sweepKey = sensitivityKey;
+    m_sweepValues = isSensitivity ? sensitivityValues : QVector<double>();
+    m_sweepBaseParams = baseParams;
+    m_sweepDoneCount = 0;
+    m_sweepCollectStats = ui->checkEngineStats->isChecked();
+    m_sweepStats = EngineStats();
+    m_sweepTimer.start();
+    res_tD.clear(); res_pD.clear(); res_dpD.clear();
+
+    // 预先按顺序创建空曲线，保证图例顺序与输入顺序一致
+    QList<QColor> colors = generateColorRamp(sweepParams.size());
+    m_sweepCurves.clear();
+    for (int i = 0; i < sweepParams.size(); ++i) {
+        QString legendName = isSensitivity ? QString("%1 = %2").arg(sensitivityKey).arg(sensitivityValues[i]) : "理论曲线";
+        plotCurve(ModelCurveData(), legendName, colors[i], isSensitivity);
+
+        CurveBuffer buf;
+        buf.t = t;
+        buf.p = QVector<double>(t.size(), 0.0);
+        buf.done = QVector<bool>(t.size(), false);
+        buf.doneCount = 0;
+        buf.previewShown = false;
+        m_sweepCurves.append(buf);
+    }
+
+    // 图版覆盖的曲线先用插值结果即时显示，精确结果到达后替换
+    if (m_previewLibrary.isLoaded()) {
+        double maxErr = 0.0;
+        int previewed = 0;
+        for (int i = 0; i < sweepParams.size(); ++i) {
+            ModelCurveData pv;
+            double err = 0.0;
+            if (!m_previewLibrary.preview(m_type, sweepParams[i], t, pv, &err)) continue;
+            m_plot->graph(2 * i)->setData(std::get<0>(pv), std::get<1>(pv));
+            m_plot->graph(2 * i + 1)->setData(std::get<0>(pv), std::get<2>(pv));
+            m_sweepCurves[i].previewShown = true;
+            maxErr = qMax(maxErr, err);
+            ++previewed;
+        }
+        if (previewed > 0) {
+            showPreviewStatus(true, maxErr, QString());
+            onFitToData();
         }
+    }
+    m_plot->replot();
+
+    // 按时间分块: 单条曲线也能占满线程池，停止请求在一个分块内即可生效
+    int threads = qMax(1, ModelSolver01_06::enginePool()->maxThreadCount());
+    int chunkSize = qBound(1, t.size() / (2 * threads), 16);
+    QVector<CalcChunk> chunks;
+    for (int c = 0; c < sweepParams.size(); ++c) {
+        for (int b = 0; b < t.size(); b += chunkSize) {
+            CalcChunk chunk;
+            chunk.curve = c;
+            chunk.begin = b;
+            chunk.t = t.mid(b, chunkSize);
+            chunk.params = sweepParams[c];
+            chunks.append(chunk);
+        }
+    }
+
+    ui->resultTextEdit->setText(QString("正在计算 %1 条曲线...").arg(sweepParams.size()));
+    ui->calcProgressBar->setRange(0, chunks.size());
+    ui->calcProgressBar->setValue(0);
+    setCalculatingState(true);
+
+    // 内核按值复制，工作线程之间无共享状态
+    ModelSolver01_06 solver = m_solver;
+    bool collectStats = m_sweepCollectStats;
+    m_sweepWatcher.setFuture(QtConcurrent::mapped(ModelSolver01_06::enginePool(), chunks,
+                                                  [solver, collectStats](const CalcChunk& chunk) {
+                                                      CalcChunkResult r;
+                                                      r.curve = chunk.curve;
+                                                      r.begin = chunk.begin;
+                                                      r.p = solver.calculatePressure(chunk.params, chunk.t, collectStats ? &r.stats : nullptr);
+                                                      return r;
+                                                  }));
+}
 
-        ModelCurveData res = calculateTheoreticalCurve(currentParams, t);
-        res_tD = std::get<0>(res);
-        res_pD = std::get<1>(res);
-        res_dpD = std::get<2>(res);
+void ModelWidget01_06::onSweepResultReady(int index) {
+    CalcChunkResult r = m_sweepWatcher.resultAt(index);
+    if (r.curve < 0 || r.curve >= m_sweepCurves.size() || 2 * r.curve + 1 >= m_plot->graphCount()) return;
 
-        QColor curveColor = isSensitivity ? m_colorList[i] : Qt::red;
-        QString legendName;
-        if (isSensitivity) legendName = QString("%1 = %2").arg(sensitivityKey).arg(val);
-        else legendName = "理论曲线";
+    if (m_sweepCollectStats) m_sweepStats.merge(r.stats);
 
-        plotCurve(res, legendName, curveColor, isSensitivity);
+    CurveBuffer& buf = m_sweepCurves[r.curve];
+    for (int i = 0; i < r.p.size() && r.begin + i < buf.t.size(); ++i) {
+        buf.p[r.begin + i] = r.p[i];
+        if (!buf.done[r.begin + i]) { buf.done[r.begin + i] = true; ++buf.doneCount; }
     }
+    bool complete = (buf.doneCount == buf.t.size());
+    if (buf.previewShown && !complete) return;
+
+    // 已完成的时间点；导数在整条曲线完成前为近似值 (Bourdet 窗口内可能缺点)
+    QVector<double> t, p;
+    t.reserve(buf.doneCount); p.reserve(buf.doneCount);
+    for (int k = 0; k < buf.t.size(); ++k) {
+        if (buf.done[k]) { t.append(buf.t[k]); p.append(buf.p[k]); }
+    }
+    QVector<double> d = ModelSolver01_06::bourdetDerivative(t, p);
+    m_plot->graph(2 * r.curve)->setData(t, p);
+    m_plot->graph(2 * r.curve + 1)->setData(t, d);
+
+    if (complete) {
+        // 结果文本与数据导出使用最近完成的一条曲线
+        res_tD = t;
+        res_pD = p;
+        res_dpD = d;
+        ++m_sweepDoneCount;
+        onFitToData();
+    } else {
+        m_plot->replot(QCustomPlot::rpQueuedReplot);
+    }
+}
 
-    QString resultText = resultTextHeader;
+void ModelWidget01_06::updateResultText(const QString& header) {
+    QString resultText = header;
     resultText += "t(h)\t\tDp(MPa)\t\tdDp(MPa)\n";
     for(int i=0; i<res_pD.size(); ++i) {
         resultText += QString("%1\t%2\t%3\n").arg(res_tD[i],0,'e',4).arg(res_pD[i],0,'e',4).arg(res_dpD[i],0,'e',4);
     }
     ui->resultTextEdit->setText(resultText);
+}
+
+void ModelWidget01_06::onSweepFinished() {
+    setCalculatingState(false);
+
+    int total = m_sweepCurves.size();
+    QString resultTextHeader;
+    if (m_sweepWatcher.isCanceled()) resultTextHeader = QString("计算已取消 (%1, 已完成 %2/%3)\n").arg(getModelName()).arg(m_sweepDoneCount).arg(total);
+    else resultTextHeader = QString("计算完成 (%1)\n").arg(getModelName());
+    if(!m_sweepKey.isEmpty()) resultTextHeader += QString("敏感性参数: %1\n").arg(m_sweepKey);
+    if (m_sweepCollectStats) {
+        // 各阶段耗时为各线程之和，墙钟时间单独列出
+        resultTextHeader += QString("\n[引擎统计] 墙钟时间 %1 ms, 线程池 %2 线程\n")
+                                .arg(m_sweepTimer.elapsed()).arg(ModelSolver01_06::enginePool()->maxThreadCount());
+        resultTextHeader += m_sweepStats.summary() + "\n";
+    }
+    updateResultText(resultTextHeader);
 
     onFitToData();
     onShowPointsToggled(ui->checkShowPoints->isChecked());
-    emit calculationCompleted(getModelName(), baseParams);
+    if (!m_sweepWatcher.isCanceled()) emit calculationCompleted(getModelName(), m_sweepBaseParams);
 }
 
 void ModelWidget01_06::plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity) {
@@ -393,251 +575,155 @@ void ModelWidget01_06::onExportImage() {
     else QMessageBox::critical(this, "错误", "导出图表失败。");
 }
 
-ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
-{
-    QVector<double> tPoints = providedTime;
-    if (tPoints.isEmpty()) {
-        tPoints = ModelManager::generateLogTimeSteps(100, -3.0, 3.0);
+void ModelWidget01_06::onOpenAtlas() {
+    if (m_atlasDialog) {
+        m_atlasDialog->setPageParams(currentParameters());
+        m_atlasDialog->raise();
+        m_atlasDialog->activateWindow();
+        return;
     }
+    m_atlasDialog = new TypeCurveAtlasDialog(m_type, currentParameters(), this);
+    m_atlasDialog->setAttribute(Qt::WA_DeleteOnClose);
+    connect(m_atlasDialog, &TypeCurveAtlasDialog::overlayRequested, this, &ModelWidget01_06::onAtlasOverlay);
+    connect(m_atlasDialog, &TypeCurveAtlasDialog::clearOverlayRequested, this, &ModelWidget01_06::onClearAtlasOverlay);
+    connect(m_atlasDialog, &TypeCurveAtlasDialog::previewLibraryRequested, this, &ModelWidget01_06::onPreviewLibraryRequested);
+    m_atlasDialog->show();
+}
 
-    double phi = params.value("phi", 0.05);
-    double mu = params.value("mu", 0.5);
-    double B = params.value("B", 1.05);
-    double Ct = params.value("Ct", 5e-4);
-    double q = params.value("q", 5.0);
-    double h = params.value("h", 20.0);
-    double kf = params.value("kf", 1e-3);
-    double L = params.value("L", 1000.0);
-
-    QVector<double> tD_vec;
-    tD_vec.reserve(tPoints.size());
-    for(double t : tPoints) {
-        double val = 14.4 * kf * t / (phi * mu * Ct * pow(L, 2));
-        tD_vec.append(val);
+void ModelWidget01_06::onAtlasOverlay(const QVector<ModelCurveData>& curves, const QStringList& names) {
+    onClearAtlasOverlay();
+    // 图版曲线使用细线，与当前计算曲线区分
+    QList<QColor> colors = generateColorRamp(curves.size());
+    for (int i = 0; i < curves.size(); ++i) {
+        QCPGraph* graphP = m_plot->addGraph();
+        graphP->setData(std::get<0>(curves[i]), std::get<1>(curves[i]));
+        graphP->setPen(QPen(colors[i], 1, Qt::SolidLine));
+        graphP->setName(names.value(i));
+
+        QCPGraph* graphD = m_plot->addGraph();
+        graphD->setData(std::get<0>(curves[i]), std::get<2>(curves[i]));
+        graphD->setPen(QPen(colors[i], 1, Qt::DotLine));
+        graphD->removeFromLegend();
+
+        m_overlayGraphs << graphP << graphD;
     }
+    onShowPointsToggled(ui->checkShowPoints->isChecked());
+}
 
-    QVector<double> PD_vec, Deriv_vec;
-    auto func = std::bind(&ModelWidget01_06::flaplace_composite, this, std::placeholders::_1, std::placeholders::_2);
-    calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec);
+void ModelWidget01_06::onClearAtlasOverlay() {
+    for (QCPGraph* g : m_overlayGraphs) m_plot->removeGraph(g);
+    m_overlayGraphs.clear();
+    m_plot->replot();
+}
 
-    double factor = 1.842e-3 * q * mu * B / (kf * h);
-    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
+void ModelWidget01_06::onPreviewLibraryRequested(const QString& path) {
+    for (QCPGraph* g : m_previewGraphs) m_plot->removeGraph(g);
+    m_previewGraphs.clear();
 
-    for(int i=0; i<tPoints.size(); ++i) {
-        finalP[i] = factor * PD_vec[i];
-        finalDP[i] = factor * Deriv_vec[i];
+    if (path.isEmpty()) {
+        m_previewLibrary.unload();
+        ui->labelPreviewStatus->clear();
+        m_plot->replot();
+        return;
     }
 
-    return std::make_tuple(tPoints, finalP, finalDP);
+    QString error;
+    if (!m_previewLibrary.load(path, &error)) {
+        QMessageBox::warning(this, "图版预览", "加载图版失败: " + error);
+        return;
+    }
+    updatePreview();
 }
 
-void ModelWidget01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                                           std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                                           QVector<double>& outPD, QVector<double>& outDeriv)
-{
-    int numPoints = tD.size();
-    outPD.resize(numPoints);
-    outDeriv.resize(numPoints);
-
-    int N_param = (int)params.value("N", 4);
-    int N = m_highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4;
-    double ln2 = log(2.0);
-
-    // 获取压敏系数 (MATLAB: gamaD)
-    double gamaD = params.value("gamaD", 0.0);
-
-    for (int k = 0; k < numPoints; ++k) {
-        double t = tD[k];
-        if (t <= 1e-12) { outPD[k] = 0; continue; }
-        double pd_val = 0.0;
-        for (int m = 1; m <= N; ++m) {
-            double z = m * ln2 / t;
-            double pf = laplaceFunc(z, params);
-            if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
-        }
-        outPD[k] = pd_val * ln2 / t;
+void ModelWidget01_06::updatePreview() {
+    if (!m_previewLibrary.isLoaded() || m_sweepWatcher.isRunning()) return;
 
-        // 摄动法考虑压敏效应 (对应 MATLAB: -1/gamaD * log(1-gamaD*PD))
-        if (std::abs(gamaD) > 1e-9) {
-            double arg = 1.0 - gamaD * outPD[k];
-            if (arg > 1e-12) {
-                outPD[k] = -1.0 / gamaD * std::log(arg);
-            }
-        }
-    }
-    if (numPoints > 2) outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
-    else outDeriv.fill(0.0);
-}
-
-double ModelWidget01_06::flaplace_composite(double z, const QMap<QString, double>& p) {
-    double kf = p.value("kf");
-    double km = p.value("km");
-    double LfD = p.value("LfD");
-    double rmD = p.value("rmD");
-    double reD = p.value("reD", 0.0); // 默认0表示无限大(如果未设置)
-    double omga1 = p.value("omega1");
-    double omga2 = p.value("omega2");
-    double remda1 = p.value("lambda1");
-    int nf = (int)p.value("nf", 4); if(nf < 1) nf = 1;
-    double M12 = kf / km;
-    QVector<double> xwD;
-    if (nf == 1) { xwD.append(0.0); } else {
-        double start = -0.9; double end = 0.9; double step = (end - start) / (nf - 1);
-        for(int i=0; i<nf; ++i) xwD.append(start + i * step);
+    for (QCPGraph* g : m_previewGraphs) m_plot->removeGraph(g);
+    m_previewGraphs.clear();
+
+    QMap<QString, double> params = currentParameters();
+    ModelCurveData pv;
+    double err = 0.0;
+    QString reason;
+    if (!m_previewLibrary.preview(m_type, params, calculationTimeSteps(params), pv, &err, &reason)) {
+        showPreviewStatus(false, 0.0, reason);
+        m_plot->replot();
+        return;
     }
-    double temp = omga2;
-    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
-    double fs2 = M12 * temp;
 
-    // 调用通用 PWD 计算内核，内部包含边界判断逻辑
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type);
+    QCPGraph* graphP = m_plot->addGraph();
+    graphP->setData(std::get<0>(pv), std::get<1>(pv));
+    graphP->setPen(QPen(Qt::darkGray, 2, Qt::DashLine));
+    graphP->setName("图版预览");
 
-    // 考虑井筒储存和表皮 (对应 MATLAB: (z*pf+S)/(z+CD*z^2*(z*pf+S)))
-    // 仅对变井储模型 (1, 3, 5) 启用
-    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
-    if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
-        }
-    }
+    QCPGraph* graphD = m_plot->addGraph();
+    graphD->setData(std::get<0>(pv), std::get<2>(pv));
+    graphD->setPen(QPen(Qt::darkGray, 2, Qt::DotLine));
+    graphD->removeFromLegend();
 
-    return pf;
-}
-
-double ModelWidget01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type) {
-    using namespace boost::math;
-    QVector<double> ywD(nf, 0.0);
-    double gama1 = sqrt(z * fs1);
-    double gama2 = sqrt(z * fs2);
-    double arg_g2_rm = gama2 * rmD;
-    double arg_g1_rm = gama1 * rmD;
-
-    // 使用缩放贝塞尔函数以避免数值溢出
-    double k0_g2 = cyl_bessel_k(0, arg_g2_rm);
-    double k1_g2 = cyl_bessel_k(1, arg_g2_rm);
-    double k0_g1 = cyl_bessel_k(0, arg_g1_rm);
-    double k1_g1 = cyl_bessel_k(1, arg_g1_rm);
-
-    // --- 边界条件因子计算 mAB ---
-    // MATLAB 对应关系:
-    // Infinite: mAB = 0
-    // Closed:   mAB = K1(re)/I1(re)
-    // ConstP:   mAB = -K0(re)/I0(re)
-
-    double term_mAB_i0 = 0.0;
-    double term_mAB_i1 = 0.0;
-
-    bool isInfinite = (type == Model_1 || type == Model_2);
-    bool isClosed = (type == Model_3 || type == Model_4);
-    bool isConstP = (type == Model_5 || type == Model_6);
-
-    if (!isInfinite) {
-        double arg_re = gama2 * reD;
-        double i1_re_s = scaled_besseli(1, arg_re);
-        double i0_re_s = scaled_besseli(0, arg_re);
-        double k1_re = cyl_bessel_k(1, arg_re);
-        double k0_re = cyl_bessel_k(0, arg_re);
-        double i0_g2_s = scaled_besseli(0, arg_g2_rm);
-        double i1_g2_s = scaled_besseli(1, arg_g2_rm);
-
-        if (isClosed) {
-            // 封闭边界: ratio based on K1/I1
-            if (i1_re_s > 1e-100) {
-                // 计算 mAB * I0(g2*rmD) 和 mAB * I1(g2*rmD)
-                // 引入 exp(arg_g2_rm - arg_re) 来处理指数项的缩放
-                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
-            }
-        } else if (isConstP) {
-            // 定压边界: ratio based on -K0/I0
-            if (i0_re_s > 1e-100) {
-                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
-            }
-        }
+    m_previewGraphs << graphP << graphD;
+    showPreviewStatus(true, err, QString());
+    m_plot->replot();
+}
+
+void ModelWidget01_06::showPreviewStatus(bool available, double errorEstimate, const QString& reason) {
+    if (!available) {
+        ui->labelPreviewStatus->setStyleSheet("color: gray;");
+        ui->labelPreviewStatus->setText("图版预览不可用: " + reason);
+        return;
     }
+    QString text = QString("图版预览 误差≈%1%").arg(errorEstimate * 100.0, 0, 'f', 2);
+    if (errorEstimate > kPreviewTolerance) {
+        ui->labelPreviewStatus->setStyleSheet("color: red;");
+        text += QString(" (超出容差 %1%，请以精确计算为准)").arg(kPreviewTolerance * 100.0, 0, 'f', 0);
+    } else {
+        ui->labelPreviewStatus->setStyleSheet("color: green;");
+    }
+    ui->labelPreviewStatus->setText(text);
+}
 
-    // MATLAB: Acup = M12*gama1*K1(g1)*(mAB*I0(g2)+K0(g2)) + gama2*K0(g1)*(mAB*I1(g2)-K1(g2))
-    double term1 = term_mAB_i0 + k0_g2; // (mAB*I0 + K0)
-    double term2 = term_mAB_i1 - k1_g2; // (mAB*I1 - K1)
-
-    double Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
-
-    double i1_g1_s = scaled_besseli(1, arg_g1_rm);
-    double i0_g1_s = scaled_besseli(0, arg_g1_rm);
-
-    // MATLAB: Acdown = M12*gama1*I1(g1)*(...) - gama2*I0(g1)*(...)
-    // 我们这里计算 scaled 版本 Acdown * exp(-arg_g1_rm)
-    double Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
-
-    if (std::abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
-
-    // Ac = Acup / Acdown
-    // Ac_prefactor = Acup / Acdown_scaled = Ac * exp(arg_g1_rm)
-    double Ac_prefactor = Acup / Acdown_scaled;
-
-    // 求解线性方程组
-    int size = nf + 1;
-    Eigen::MatrixXd A_mat(size, size);
-    Eigen::VectorXd b_vec(size);
-    b_vec.setZero(); b_vec(nf) = 1.0;
-
-    for (int i = 0; i < nf; ++i) {
-        for (int j = 0; j < nf; ++j) {
-            // 积分核函数: K0 + Ac*I0
-            auto integrand = [&](double a) -> double {
-                double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
-                double arg_dist = gama1 * dist; if (arg_dist < 1e-10) arg_dist = 1e-10;
-
-                // 计算 Ac * I0(g1*dist)
-                // = (Ac_prefactor * exp(-arg_g1_rm)) * (scaled_I0 * exp(arg_dist))
-                // = Ac_prefactor * scaled_I0 * exp(arg_dist - arg_g1_rm)
-                double term2 = 0.0;
-                double exponent = arg_dist - arg_g1_rm;
-                if (exponent > -700.0) {
-                    term2 = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
-                }
-                return cyl_bessel_k(0, arg_dist) + term2;
-            };
-            double val = adaptiveGauss(integrand, -LfD, LfD, 1e-5, 0, 10);
-            A_mat(i, j) = z * val / (M12 * z * 2 * LfD);
-        }
+void ModelWidget01_06::removeCalculatedGraphs() {
+    for (int i = m_plot->graphCount() - 1; i >= 0; --i) {
+        QCPGraph* g = m_plot->graph(i);
+        if (!m_overlayGraphs.contains(g) && !m_previewGraphs.contains(g)) m_plot->removeGraph(g);
     }
-    // 流量条件
-    for (int i = 0; i < nf; ++i) { A_mat(i, nf) = -1.0; A_mat(nf, i) = z; }
-    A_mat(nf, nf) = 0.0;
-
-    return A_mat.fullPivLu().solve(b_vec)(nf);
-}
-
-double ModelWidget01_06::scaled_besseli(int v, double x) {
-    if (x < 0) x = -x;
-    if (x > 600.0) return 1.0 / std::sqrt(2.0 * M_PI * x);
-    return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
-}
-double ModelWidget01_06::gauss15(std::function<double(double)> f, double a, double b) {
-    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
-    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
-    double h = 0.5 * (b - a); double c = 0.5 * (a + b); double s = W[0] * f(c);
-    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; s += W[i] * (f(c - dx) + f(c + dx)); }
-    return s * h;
-}
-double ModelWidget01_06::adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth) {
-    double c = (a + b) / 2.0; double v1 = gauss15(f, a, b); double v2 = gauss15(f, a, c) + gauss15(f, c, b);
-    if (depth >= maxDepth || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
-    return adaptiveGauss(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss(f, c, b, eps/2, depth+1, maxDepth);
-}
-double ModelWidget01_06::stefestCoefficient(int i, int N) {
-    double s = 0.0; int k1 = (i + 1) / 2; int k2 = std::min(i, N / 2);
-    for (int k = k1; k <= k2; ++k) {
-        double num = pow(k, N / 2.0) * factorial(2 * k);
-        double den = factorial(N / 2 - k) * factorial(k) * factorial(k - 1) * factorial(i - k) * factorial(2 * k - i);
-        if(den!=0) s += num/den;
+}
+
+void ModelWidget01_06::onLiveCalcToggled(bool checked) {
+    if (checked) onLiveParamsChanged();
+    else m_liveRunner.cancel();
+}
+
+void ModelWidget01_06::onLiveParamsChanged() {
+    if (!ui->checkLiveCalc->isChecked() || m_sweepWatcher.isRunning()) return;
+    // 多值输入 (敏感性分析) 时实时计算只取第一个值
+    QMap<QString, double> params = currentParameters();
+    m_liveRunner.request(m_solver, params, calculationTimeSteps(params));
+}
+
+void ModelWidget01_06::onLiveStageReady(int stage, bool isFinal, const ModelCurveData& curve, qint64 elapsedMs, double floatErrorBound) {
+    Q_UNUSED(stage);
+    if (m_sweepWatcher.isRunning()) return;
+
+    // 新阶段替换上一阶段 (及上一次计算) 的曲线
+    removeCalculatedGraphs();
+    plotCurve(curve, QString(), Qt::red, false);
+    onFitToData();
+    onShowPointsToggled(ui->checkShowPoints->isChecked());
+
+    if (isFinal) {
+        res_tD = std::get<0>(curve);
+        res_pD = std::get<1>(curve);
+        res_dpD = std::get<2>(curve);
+        updateResultText(QString("实时计算完成 (%1, 耗时 %2 ms)\n").arg(getModelName()).arg(elapsedMs));
+    } else {
+        QString text = QString("粗算结果 (%1 点, 耗时 %2 ms").arg(std::get<0>(curve).size()).arg(elapsedMs);
+        if (floatErrorBound > 0.0) text += QString("，单精度内核相对误差上界 %1").arg(floatErrorBound, 0, 'e', 1);
+        ui->resultTextEdit->setText(text + ")，正在精算...");
     }
-    return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * s;
 }
-double ModelWidget01_06::factorial(int n) { if(n<=1)return 1; double r=1; for(int i=2;i<=n;++i)r*=i; return r; }
+
+ModelCurveData ModelWidget01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
+{
+    return m_solver.calculateTheoreticalCurve(params, providedTime);
+}
@@ -6,6 +6,7 @@
  * 2. 实现阶梯图的数据转换逻辑：将“时长-产量”转换为“累加时间-产量”的阶梯线。
  * 3. 实现数据导出功能：部分导出为4列，全部导出为3列，文件默认为CSV。
  * 4. 实现图表交互选点逻辑。
+ * 5. 阶梯图的 (时长, 产量) 或逐点的 (时间, 产量) 整理为产量历史，经信号交给拟合界面。
  */
 
 #include "plottingstackwidget.h"
@@ -181,6 +182,11 @@ void PlottingStackWidget::setData(const QVector<double>& pressX, const QVector<d
     m_graphProduction->setName(prodName);
     m_graphProduction->setPen(QPen(prodColor, 2));
 
+    // 阶梯图输入为各段时长 (第一段从 0 开始)，散点/折线输入为逐点记录的产量
+    m_rateSchedule = (prodType == 0) ? RateSchedule::fromDurations(prodX, prodY) : RateSchedule::fromSamples(prodX, prodY);
+    if (!m_rateSchedule.isValid()) m_rateSchedule = RateSchedule();
+    ui->btnRateToFitting->setEnabled(!m_rateSchedule.isEmpty());
+
     // 自动缩放
     m_graphPressure->rescaleAxes();
     m_graphProduction->rescaleAxes();
@@ -368,3 +374,17 @@ void PlottingStackWidget::on_btnFitToData_clicked()
     m_graphProduction->rescaleAxes();
     ui->customPlot->replot();
 }
+
+// 槽函数：产量历史用于拟合
+void PlottingStackWidget::on_btnRateToFitting_clicked()
+{
+    if (m_rateSchedule.isEmpty()) return;
+    QMessageBox msgBox;
+    msgBox.setWindowTitle("产量历史用于拟合");
+    msgBox.setText(QString("将 %1 段产量历史设为当前拟合分析的变产量历史？\n理论曲线将按产量阶跃叠加计算，产量时间轴需与拟合数据的时间轴一致。")
+                   .arg(m_rateSchedule.rates.size()));
+    msgBox.setIcon(QMessageBox::Question);
+    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+    applyMessageBoxStyle(msgBox);
+    if (msgBox.exec() == QMessageBox::Yes) emit rateHistoryForFitting(m_rateSchedule);
+}
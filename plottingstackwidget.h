@@ -6,6 +6,7 @@
  * 2. 声明了数据设置接口，支持自动处理阶梯状的产量数据。
  * 3. 声明了数据导出、图片导出、图表设置等功能槽函数。
  * 4. 包含处理交互式选点导出的成员变量。
+ * 5. 产量数据同时整理为阶梯产量历史，可发送给拟合界面做变产量叠加拟合。
  */
 
 #ifndef PLOTTINGSTACKWIDGET_H
@@ -13,6 +14,7 @@
 
 #include <QWidget>
 #include "mousezoom.h" // 自定义绘图控件基类
+#include "superposition.h"
 
 namespace Ui {
 class PlottingStackWidget;
@@ -40,11 +42,19 @@ public:
 
     QCustomPlot* getPlot() const;
 
+    // 由产量数据整理的阶梯产量历史 (无效时为空)
+    const RateSchedule& rateSchedule() const { return m_rateSchedule; }
+
+signals:
+    // 用户请求将产量历史用于拟合 (变产量叠加)
+    void rateHistoryForFitting(const RateSchedule& schedule);
+
 private slots:
     void on_btnExportImg_clicked();
     void on_btnExportData_clicked();
     void on_btnChartSettings_clicked();
     void on_btnFitToData_clicked();
+    void on_btnRateToFitting_clicked();
 
     // 图表点击事件，用于交互式选点
     void onGraphClicked(QCPAbstractPlottable *plottable, int dataIndex, QMouseEvent *event);
@@ -69,6 +79,7 @@ private:
     QVector<double> m_processedProdX;
     QVector<double> m_processedProdY;
     bool m_isStepChart;
+    RateSchedule m_rateSchedule;
 
     void setupStackedLayout(); // 初始化双坐标系布局
     void executeExport(bool fullRange, double startKey = 0, double endKey = 0);
@@ -0,0 +1,188 @@
+/*
+ * progressivecurverunner.cpp
+ * 文件作用：渐进式理论曲线计算实现
+ * 功能描述：
+ * 1. 请求在引擎线程池中以 QPromise 任务执行，各阶段结果通过 addResult 逐个交付
+ * 2. 阶段内的时间分块由 blockingMapped 并发计算，调用线程同时参与计算，不会占满线程池
+ * 3. 取消请求时，尚未开始的时间分块直接跳过，已开始的分块算完即返回
+ * 4. 每点耗时在界面线程中按完成的预览阶段更新，下一次请求据此选取点数 (参数连续调整时相邻请求的代价接近)
+ */
+
+#include "progressivecurverunner.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <cmath>
+
+namespace {
+const double kDefaultPreviewBudgetMs = 30.0;   // 单核实测预览每点 0.05 ms (1 条裂缝) ~ 2.7 ms (128 条)
+const int kInitialPointsPerDecade = 3;         // 尚无实测耗时时的预览密度
+const int kMinPreviewPoints = 5;
+}
+
+ProgressiveCurveRunner::ProgressiveCurveRunner(QObject* parent)
+    : QObject(parent)
+    , m_previewStages(defaultPreviewStages())
+    , m_previewBudgetMs(kDefaultPreviewBudgetMs)
+    , m_msPerPoint(m_previewStages.size(), 0.0)
+    , m_generation(0)
+{
+    connect(&m_watcher, &QFutureWatcherBase::resultReadyAt, this, &ProgressiveCurveRunner::onResultReadyAt);
+}
+
+ProgressiveCurveRunner::~ProgressiveCurveRunner()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+QVector<ProgressiveCurveRunner::Stage> ProgressiveCurveRunner::defaultPreviewStages()
+{
+    Stage coarse;
+    coarse.pointsPerDecade = 10;
+    coarse.highPrecision = false;
+    coarse.quadTolerance = 1e-3;
+    coarse.quadMaxDepth = 4;
+    coarse.singlePrecisionKernel = true;
+    return QVector<Stage>() << coarse;
+}
+
+void ProgressiveCurveRunner::setPreviewStages(const QVector<Stage>& stages)
+{
+    m_previewStages = stages;
+    m_msPerPoint = QVector<double>(stages.size(), 0.0);
+}
+
+void ProgressiveCurveRunner::setPreviewBudget(double ms)
+{
+    m_previewBudgetMs = qMax(0.0, ms);
+}
+
+int ProgressiveCurveRunner::budgetedPoints(int stage, int maxPoints) const
+{
+    if (m_previewBudgetMs <= 0.0) return maxPoints;
+    double msPerPoint = m_msPerPoint.value(stage, 0.0);
+    if (msPerPoint <= 0.0) return maxPoints;
+    return qBound(kMinPreviewPoints, int(m_previewBudgetMs / msPerPoint), qMax(kMinPreviewPoints, maxPoints));
+}
+
+void ProgressiveCurveRunner::cancel()
+{
+    ++m_generation;
+    m_watcher.cancel();
+}
+
+void ProgressiveCurveRunner::request(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& finalTime,
+                                     const RateSchedule& schedule)
+{
+    // 旧请求只取消不等待，其结果按编号丢弃
+    cancel();
+    if (finalTime.isEmpty()) return;
+
+    // 组装本次请求的阶段: 预览阶段 (引擎点数不少于最终阶段时跳过) + 最终阶段
+    // 定产量时引擎时间点 grid 即曲线时间 t；变产量时 grid 为主网格 (每十倍程 superpositionDensity 点)，曲线仍在 finalTime 上
+    struct Plan {
+        ModelSolver01_06 solver;
+        QVector<double> t;
+        QVector<double> grid;
+        int superpositionDensity;
+        int previewStage;
+        bool isFinal;
+    };
+    QVector<Plan> plans;
+    bool superposed = !schedule.isEmpty();
+    RateSuperposition finalSuperposition(schedule);
+    QVector<double> finalGrid = superposed ? finalSuperposition.masterGrid(finalTime) : finalTime;
+    double gMin = finalGrid.isEmpty() ? 0.0 : finalGrid.first(), gMax = finalGrid.isEmpty() ? 0.0 : finalGrid.last();
+    for (int i = 0; i < m_previewStages.size(); ++i) {
+        const Stage& st = m_previewStages[i];
+        if (gMin <= 0 || gMax <= gMin) break;
+        double decades = std::log10(gMax / gMin);
+        bool measured = m_msPerPoint.value(i, 0.0) > 0.0;
+        int density = measured ? st.pointsPerDecade : qMin(st.pointsPerDecade, kInitialPointsPerDecade);
+        int n = budgetedPoints(i, qMax(kMinPreviewPoints, int(std::ceil(decades * density)) + 1));
+        if (n >= finalGrid.size()) continue;
+
+        ModelSolver01_06 s = solver;
+        s.setHighPrecision(st.highPrecision);
+        s.setQuadrature(st.quadTolerance, st.quadMaxDepth);
+        s.setSinglePrecisionKernel(st.singlePrecisionKernel);
+        if (superposed) {
+            // 主网格密度 (RateSuperposition 至少每十倍程 2 点)，同一叠加器给出网格与插值
+            int ppd = qMax(2, int((n - 1) / decades));
+            RateSuperposition preview(schedule, ppd);
+            plans.append({ s, finalTime, preview.masterGrid(finalTime), preview.pointsPerDecade(), i, false });
+        } else {
+            QVector<double> t = ModelSolver01_06::generateLogTimeSteps(n, std::log10(gMin), std::log10(gMax));
+            plans.append({ s, t, t, 0, i, false });
+        }
+    }
+    plans.append({ solver, finalTime, finalGrid, superposed ? finalSuperposition.pointsPerDecade() : 0, -1, true });
+
+    quint64 generation = m_generation;
+    // 变产量时引擎计算单位产量响应 (与 RateSuperposition::unitResponse 相同)
+    QMap<QString, double> engineParams = params;
+    if (superposed) engineParams["q"] = 1.0;
+    m_watcher.setFuture(QtConcurrent::run(ModelSolver01_06::enginePool(),
+                                          [plans, engineParams, schedule, generation](QPromise<StageResult>& promise) {
+        const QMap<QString, double>& params = engineParams;
+        QElapsedTimer timer;
+        timer.start();
+        int threads = qMax(1, ModelSolver01_06::enginePool()->maxThreadCount());
+
+        for (int i = 0; i < plans.size(); ++i) {
+            if (promise.isCanceled()) return;
+            const Plan& plan = plans[i];
+            qint64 stageStart = timer.nsecsElapsed();
+
+            int chunkSize = qBound(1, plan.grid.size() / (2 * threads), 16);
+            QVector<QVector<double>> chunks;
+            for (int b = 0; b < plan.grid.size(); b += chunkSize) chunks.append(plan.grid.mid(b, chunkSize));
+
+            // 单精度内核阶段带统计计算，以得到误差上界 (引擎只在传入统计时计算上界)
+            struct Piece {
+                QVector<double> p;
+                double floatErrorBound;
+            };
+            bool floatKernel = plan.solver.isSinglePrecisionKernel();
+            QVector<Piece> pieces = QtConcurrent::blockingMapped(ModelSolver01_06::enginePool(), chunks,
+                [&promise, &plan, &params, floatKernel](const QVector<double>& tc) {
+                    if (promise.isCanceled()) return Piece{ QVector<double>(), 0.0 };
+                    EngineStats stats;
+                    QVector<double> p = plan.solver.calculatePressure(params, tc, floatKernel ? &stats : nullptr);
+                    return Piece{ p, stats.maxFloatErrorBound };
+                });
+            if (promise.isCanceled()) return;
+
+            QVector<double> p;
+            p.reserve(plan.grid.size());
+            double floatErrorBound = 0.0;
+            for (const Piece& piece : pieces) {
+                p.append(piece.p);
+                floatErrorBound = qMax(floatErrorBound, piece.floatErrorBound);
+            }
+            if (p.size() != plan.grid.size()) return;
+            if (plan.superpositionDensity > 0) p = RateSuperposition(schedule, plan.superpositionDensity).superpose(plan.grid, p, plan.t);
+
+            StageResult r;
+            r.generation = generation;
+            r.stage = i;
+            r.isFinal = plan.isFinal;
+            r.curve = std::make_tuple(plan.t, p, ModelSolver01_06::bourdetDerivative(plan.t, p));
+            r.elapsedMs = timer.elapsed();
+            r.floatErrorBound = floatErrorBound;
+            r.previewStage = plan.previewStage;
+            r.enginePoints = plan.grid.size();
+            r.stageMs = (timer.nsecsElapsed() - stageStart) / 1e6;
+            promise.addResult(r);
+        }
+    }));
+}
+
+void ProgressiveCurveRunner::onResultReadyAt(int index)
+{
+    StageResult r = m_watcher.resultAt(index);
+    if (r.generation != m_generation) return; // 已被新请求取代
+    if (r.previewStage >= 0 && r.previewStage < m_msPerPoint.size() && r.enginePoints > 0) m_msPerPoint[r.previewStage] = r.stageMs / r.enginePoints;
+    emit stageReady(r.stage, r.isFinal, r.curve, r.elapsedMs, r.floatErrorBound);
+}
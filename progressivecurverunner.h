@@ -0,0 +1,88 @@
+/*
+ * progressivecurverunner.h
+ * 文件作用：由粗到精的渐进式理论曲线计算
+ * 功能描述：
+ * 1. 每次请求按阶段计算: 先以低精度 (N=4、宽松积分容差、单精度内核、稀疏时间点) 快速给出曲线，再以最终精度重算
+ * 2. 每个阶段完成即发出 stageReady，界面用新结果替换上一阶段的曲线；单精度内核阶段同时给出相对双精度的误差上界
+ * 3. 新请求会作废并取消尚未完成的旧请求，过期结果按请求编号丢弃
+ * 4. 每个阶段内按时间分块在引擎线程池中并发计算
+ * 5. 预览点数按耗时预算选取: 以上一次请求实测的每点耗时估计，预算内取尽量多的点 (不超过 pointsPerDecade)
+ * 6. 给定产量历史时各阶段按叠加计算: 引擎只算主网格上的单位产量响应，预览阶段放稀主网格、仍在 finalTime 上给出曲线
+ */
+
+#ifndef PROGRESSIVECURVERUNNER_H
+#define PROGRESSIVECURVERUNNER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QVector>
+#include "modelsolver01-06.h"
+#include "superposition.h"
+
+class ProgressiveCurveRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 预览阶段定义 (最终阶段总是使用请求给定的时间序列与 solver 当前精度，无需定义)
+    struct Stage {
+        int pointsPerDecade;   // 每十倍程点数上限 (有耗时预算时按预算减少)
+        bool highPrecision;    // 是否使用高精度 Stehfest (N 取参数值)
+        double quadTolerance;  // 裂缝积分容差
+        int quadMaxDepth;      // 裂缝积分最大细分层数
+        bool singlePrecisionKernel; // 是否使用单精度内核 (N=4 时相对双精度误差约 1e-6，上界见 EngineStats)
+    };
+
+    explicit ProgressiveCurveRunner(QObject* parent = nullptr);
+    ~ProgressiveCurveRunner();
+
+    // 默认预览阶段: 至多 10 点/十倍程, N=4, 积分容差 1e-3 / 4 层, 单精度内核
+    static QVector<Stage> defaultPreviewStages();
+    void setPreviewStages(const QVector<Stage>& stages);
+
+    // 每个预览阶段的目标耗时 (毫秒，默认 30)；0 表示不限，按 pointsPerDecade 计算
+    // 尚无实测耗时 (首次请求) 时按每十倍程 3 点计算
+    void setPreviewBudget(double ms);
+    double previewBudget() const { return m_previewBudgetMs; }
+
+    // 提交新请求 (旧请求作废): 依次计算各预览阶段，最后以 solver 当前精度计算 finalTime
+    // schedule 非空时按变产量叠加计算 (忽略参数 q，与 RateSuperposition::calculate 一致)
+    void request(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& finalTime,
+                 const RateSchedule& schedule = RateSchedule());
+    void cancel();
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+signals:
+    // 某阶段完成 (elapsedMs 为自请求开始的耗时)；floatErrorBound 为单精度内核压力相对双精度路径的误差上界，
+    // 即 EngineStats::maxFloatErrorBound (双精度阶段为 0)
+    void stageReady(int stage, bool isFinal, const ModelCurveData& curve, qint64 elapsedMs, double floatErrorBound);
+
+private slots:
+    void onResultReadyAt(int index);
+
+private:
+    struct StageResult {
+        quint64 generation;
+        int stage;
+        bool isFinal;
+        ModelCurveData curve;
+        qint64 elapsedMs;
+        double floatErrorBound;
+        int previewStage;   // 预览阶段序号 (最终阶段为 -1)
+        int enginePoints;   // 本阶段引擎计算的时间点数
+        double stageMs;     // 本阶段耗时
+    };
+
+    // 在预算内可计算的引擎时间点数 (不超过 maxPoints，至少 5 点)
+    int budgetedPoints(int stage, int maxPoints) const;
+
+private:
+    QVector<Stage> m_previewStages;
+    double m_previewBudgetMs;
+    QVector<double> m_msPerPoint;   // 各预览阶段最近一次实测的每点耗时 (0 表示尚无)
+    QFutureWatcher<StageResult> m_watcher;
+    quint64 m_generation;
+};
+
+#endif // PROGRESSIVECURVERUNNER_H
@@ -0,0 +1,182 @@
+/*
+ * superposition.cpp
+ * 文件作用：变产量叠加计算实现
+ * 功能描述：
+ * 1. 主网格下界取各观测点距其之前最近一次产量变化的最短时间，上界取距第一段开始的时间
+ * 2. 单位产量响应按时间分块由 FitScheduler::runEngineBatch 在引擎线程池中并发计算 (拟合中按会话公平份额)，调用线程同时参与计算
+ * 3. 叠加: Δp(t) = Σ (q_j - q_{j-1}) · p_u(t - t_j)，每个阶跃对其后的观测点做一次连续的插值循环
+ */
+
+#include "superposition.h"
+#include "fitscheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+RateSchedule RateSchedule::fromDurations(const QVector<double>& durations, const QVector<double>& rates, double t0)
+{
+    RateSchedule s;
+    double t = t0;
+    int n = qMin(durations.size(), rates.size());
+    for (int i = 0; i < n; ++i) {
+        s.startTimes.append(t);
+        s.rates.append(rates[i]);
+        t += durations[i];
+    }
+    return s;
+}
+
+RateSchedule RateSchedule::fromSamples(const QVector<double>& t, const QVector<double>& q)
+{
+    RateSchedule s;
+    int n = qMin(t.size(), q.size());
+    double scale = 0.0;
+    for (int i = 0; i < n; ++i) scale = qMax(scale, std::abs(q[i]));
+    // 小于最大产量 1e-6 的波动视为同一产量
+    double tol = 1e-6 * scale;
+    for (int i = 0; i < n; ++i) {
+        if (!std::isfinite(t[i]) || !std::isfinite(q[i])) continue;
+        if (!s.rates.isEmpty() && (std::abs(q[i] - s.rates.last()) <= tol || t[i] <= s.startTimes.last())) continue;
+        s.startTimes.append(t[i]);
+        s.rates.append(q[i]);
+    }
+    return s;
+}
+
+bool RateSchedule::isValid(QString* error) const
+{
+    auto fail = [error](const QString& msg) { if (error) *error = msg; return false; };
+    if (rates.isEmpty()) return fail("产量历史为空");
+    if (startTimes.size() != rates.size()) return fail("产量段起始时间与产量个数不一致");
+    for (int i = 0; i < rates.size(); ++i) {
+        if (!std::isfinite(startTimes[i]) || !std::isfinite(rates[i])) return fail(QString("第 %1 段含无效数值").arg(i + 1));
+        if (i > 0 && startTimes[i] <= startTimes[i - 1]) return fail(QString("第 %1 段起始时间未递增 (时长需为正)").arg(i + 1));
+    }
+    return true;
+}
+
+double RateSchedule::rateAt(double t) const
+{
+    int j = int(std::upper_bound(startTimes.begin(), startTimes.end(), t) - startTimes.begin()) - 1;
+    return j >= 0 ? rates[j] : 0.0;
+}
+
+RateSuperposition::RateSuperposition(const RateSchedule& schedule, int pointsPerDecade)
+    : m_schedule(schedule)
+    , m_pointsPerDecade(qMax(2, pointsPerDecade))
+{
+}
+
+QVector<double> RateSuperposition::masterGrid(const QVector<double>& t) const
+{
+    const QVector<double>& s = m_schedule.startTimes;
+    if (s.isEmpty() || t.isEmpty()) return QVector<double>();
+
+    // t 与起始时间均升序，双指针找每个观测点之前最近的产量变化
+    double dtMin = HUGE_VAL, dtMax = 0.0;
+    int j = 0;
+    for (double ti : t) {
+        while (j + 1 < s.size() && s[j + 1] < ti) ++j;
+        if (ti <= s[j]) continue;
+        dtMin = qMin(dtMin, ti - s[j]);
+        dtMax = qMax(dtMax, ti - s.first());
+    }
+    if (dtMax <= 0.0) return QVector<double>();
+
+    double lo = std::log10(dtMin), hi = std::log10(dtMax);
+    if (hi - lo < 1e-6) hi = lo + 1.0;
+    int n = qMax(2, int(std::ceil((hi - lo) * m_pointsPerDecade)) + 1);
+    return ModelSolver01_06::generateLogTimeSteps(n, lo, hi);
+}
+
+QVector<double> RateSuperposition::unitResponse(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& gridT,
+                                                EngineStats* stats)
+{
+    QMap<QString, double> unit = params;
+    unit["q"] = 1.0;
+
+    int threads = qMax(1, ModelSolver01_06::enginePool()->maxThreadCount());
+    int chunkSize = qBound(1, gridT.size() / (2 * threads), 16);
+    struct Chunk {
+        QVector<double> t;
+        QVector<double> p;
+        EngineStats stats;
+    };
+    QVector<Chunk> chunks;
+    for (int b = 0; b < gridT.size(); b += chunkSize) chunks.append({ gridT.mid(b, chunkSize), QVector<double>(), EngineStats() });
+
+    // 拟合中按本会话的公平份额借用引擎线程池
+    FitScheduler::runEngineBatch(chunks.size(), [&chunks, &solver, &unit, stats](int k) {
+        Chunk& c = chunks[k];
+        c.p = solver.calculatePressure(unit, c.t, stats ? &c.stats : nullptr);
+    });
+
+    QVector<double> p;
+    p.reserve(gridT.size());
+    for (const Chunk& c : chunks) {
+        p.append(c.p);
+        if (stats) stats->merge(c.stats);
+    }
+    return p;
+}
+
+QVector<double> RateSuperposition::superpose(const QVector<double>& gridT, const QVector<double>& unitP, const QVector<double>& t) const
+{
+    QVector<double> out(t.size(), 0.0);
+    int n = qMin(gridT.size(), unitP.size());
+    if (n < 2 || m_schedule.isEmpty()) return out;
+
+    // (ln t, ln p) 主网格与单调三次 Hermite 斜率 (Fritsch-Butland 调和平均)
+    double g0 = std::log(gridT[0]);
+    double h = (std::log(gridT[n - 1]) - g0) / (n - 1);
+    QVector<double> y(n), m(n);
+    for (int k = 0; k < n; ++k) y[k] = std::log(qMax(unitP[k], 1e-300));
+    for (int k = 1; k < n - 1; ++k) {
+        double d0 = (y[k] - y[k - 1]) / h, d1 = (y[k + 1] - y[k]) / h;
+        m[k] = (d0 * d1 > 0.0) ? 2.0 / (1.0 / d0 + 1.0 / d1) : 0.0;
+    }
+    m[0] = (y[1] - y[0]) / h;
+    m[n - 1] = (y[n - 1] - y[n - 2]) / h;
+    const double* Y = y.constData();
+    const double* M = m.constData();
+    double invH = 1.0 / h, uMax = n - 1;
+
+    const QVector<double>& s = m_schedule.startTimes;
+    const QVector<double>& q = m_schedule.rates;
+    double* P = out.data();
+    const double* T = t.constData();
+    for (int j = 0; j < s.size(); ++j) {
+        double dq = q[j] - (j > 0 ? q[j - 1] : 0.0);
+        if (dq == 0.0) continue;
+        double tj = s[j];
+        int i0 = int(std::upper_bound(t.begin(), t.end(), tj) - t.begin());
+
+        for (int i = i0; i < t.size(); ++i) {
+            double u = (std::log(T[i] - tj) - g0) * invH;
+            double uc = qBound(0.0, u, uMax);
+            int k = qMin(int(uc), n - 2);
+            double r = uc - k;
+            double r2 = r * r, r3 = r2 * r;
+            double v = (2 * r3 - 3 * r2 + 1) * Y[k] + (r3 - 2 * r2 + r) * h * M[k] + (3 * r2 - 2 * r3) * Y[k + 1] + (r3 - r2) * h * M[k + 1];
+            // 网格外 (t 未升序或落在网格之外时) 按端点对数斜率线性外推
+            v += (u - uc) * h * (u < 0.0 ? M[0] : M[n - 1]);
+            P[i] += dq * std::exp(v);
+        }
+    }
+    return out;
+}
+
+QVector<double> RateSuperposition::calculatePressure(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& t,
+                                                     EngineStats* stats) const
+{
+    QVector<double> grid = masterGrid(t);
+    if (grid.isEmpty()) return QVector<double>(t.size(), 0.0);
+    return superpose(grid, unitResponse(solver, params, grid, stats), t);
+}
+
+ModelCurveData RateSuperposition::calculate(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& t,
+                                            EngineStats* stats) const
+{
+    QVector<double> p = calculatePressure(solver, params, t, stats);
+    return std::make_tuple(t, p, ModelSolver01_06::bourdetDerivative(t, p));
+}
@@ -0,0 +1,68 @@
+/*
+ * superposition.h
+ * 文件作用：变产量历史的叠加计算 (单位产量响应 ⊗ 产量阶跃)
+ * 功能描述：
+ * 1. RateSchedule 描述阶梯产量历史，可由压力产量分析中的 (时长, 产量) 两列直接构造
+ * 2. 单位产量响应只在一条公共对数主网格上计算一次 (按时间分块在引擎线程池中并发)，
+ *    各产量阶跃的贡献由主网格插值得到，引擎调用次数与产量段数、观测点数无关
+ * 3. 插值在 (ln t, ln Δp) 坐标下用单调三次 Hermite，主网格均匀对数间隔，定位为 O(1)
+ * 4. 只依赖 ModelSolver01_06，可在工作线程中使用
+ */
+
+#ifndef SUPERPOSITION_H
+#define SUPERPOSITION_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include "modelsolver01-06.h"
+
+// 阶梯产量历史: 第 i 段自 startTimes[i] 起以 rates[i] 生产，直至下一段开始 (最后一段延续到观测结束)
+struct RateSchedule {
+    QVector<double> startTimes;   // 各段起始时间 (h)，严格递增
+    QVector<double> rates;        // 各段产量 (与模型参数 q 同单位)，关井为 0
+
+    // 由各段时长构造 (与 PlottingStackWidget 阶梯图的输入一致)，第一段从 t0 开始
+    static RateSchedule fromDurations(const QVector<double>& durations, const QVector<double>& rates, double t0 = 0.0);
+    // 由逐点记录的产量列构造 (数据表中的流量列): 产量变化处开始新的一段，起始时间取新产量首次出现的时间
+    static RateSchedule fromSamples(const QVector<double>& t, const QVector<double>& q);
+
+    bool isEmpty() const { return rates.isEmpty(); }
+    // 段数一致、起始时间严格递增；error 非空时写入原因
+    bool isValid(QString* error = nullptr) const;
+    // t 时刻的产量 (第一段之前为 0)
+    double rateAt(double t) const;
+};
+
+class RateSuperposition
+{
+public:
+    // pointsPerDecade: 主网格每十倍程点数 (20 点时插值相对误差约 1e-4)
+    explicit RateSuperposition(const RateSchedule& schedule, int pointsPerDecade = 20);
+
+    const RateSchedule& schedule() const { return m_schedule; }
+    int pointsPerDecade() const { return m_pointsPerDecade; }
+
+    // 覆盖 t 上全部正的"距各次产量变化的时间"的对数主网格 (t 升序)
+    QVector<double> masterGrid(const QVector<double>& t) const;
+
+    // 变产量下的理论曲线 <t, Δp, dΔp/dln t>: 以 solver 计算单位产量响应 (忽略参数 q)，再叠加各产量阶跃
+    // 导数为叠加后压差对 ln t 的 Bourdet 导数 (L = 0.1)，与实测数据的导数处理一致
+    ModelCurveData calculate(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& t,
+                             EngineStats* stats = nullptr) const;
+    QVector<double> calculatePressure(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& t,
+                                      EngineStats* stats = nullptr) const;
+
+    // 主网格 gridT (均匀对数间隔) 上的单位产量响应 unitP 与产量阶跃叠加，得到 t 上的压差
+    QVector<double> superpose(const QVector<double>& gridT, const QVector<double>& unitP, const QVector<double>& t) const;
+
+    // 在引擎线程池中分块计算单位产量响应 (q = 1)
+    static QVector<double> unitResponse(const ModelSolver01_06& solver, const QMap<QString, double>& params, const QVector<double>& gridT,
+                                        EngineStats* stats = nullptr);
+
+private:
+    RateSchedule m_schedule;
+    int m_pointsPerDecade;
+};
+
+#endif // SUPERPOSITION_H
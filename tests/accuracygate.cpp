@@ -0,0 +1,794 @@
+/*
+ * accuracygate.cpp
+ * 文件作用：计算引擎精度/代价回归门禁实现
+ * 功能描述：
+ * 1. 参考文件保存参数矩阵、时间网格、各模型参考压力/导数与各档位精度/代价基线
+ * 2. 检查时参数取自参考文件，保证与参考曲线一致；档位与容差取自 tiers()
+ * 3. 代价以积分被积函数调用次数衡量 (与机器无关)，耗时只报告，给定 maxSeconds 时才检查；
+ *    精度基线按参数组/模型记录压力与导数最大对数误差，与代价基线存放在同一条目
+ * 4. 灵敏度误差以 |v (∂p/∂v - 中心差分)| / max|p| 衡量 (对数参数灵敏度，与压力同量纲)，
+ *    避免晚期偏导很小的参数上差分舍入误差被相对误差放大
+ * 5. 叠加误差以 max|Δp - 直接叠加| / max|直接叠加| 衡量 (关井后压差回落，逐点相对误差无意义)
+ * 6. 反褶积误差只在 t ≥ 10 × 采样间隔的节点上比较: 更早的响应在数据中不可分辨 (实测该段导数误差可达 0.35 个 log10 单位)
+ */
+
+#include "accuracygate.h"
+#include "deconvolution.h"
+#include "progressivecurverunner.h"
+#include "superposition.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStringList>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 参考解设置: N=12 与 N=14 的结果相差约 1e-4 (压力) / 1e-3 (导数) 个 log10 单位，远小于各档位容差
+const int kReferenceN = 12;
+const double kReferenceQuadTolerance = 1e-10;
+const int kReferenceQuadMaxDepth = 30;
+// 导数只在参考值大于其最大值 1% 的点比较 (定压边界晚期导数趋于零，对数误差无意义)
+const double kDerivativeFloorRatio = 1e-2;
+// 精度基线的绝对余量 (log10 单位)，避免基线极小 (导数误差低至 7e-5) 时编译器/指令集差异即判为失败
+const double kAccuracyFloor = 1e-4;
+
+// 灵敏度检查: double 路径对参数并非处处光滑 (GMRES 收敛判据、积分规则切换带来 1e-8 量级的跳跃)，
+// 单一步长的差分可能恰好跨过跳跃，故每个参数取三个相对步长中与偏导最接近者 (实测不超过 2e-5)
+const double kSensitivitySteps[] = { 1e-3, 1e-4, 1e-5 };
+const double kMaxSensitivityError = 1e-4;
+const double kMaxSensitivityValueDiff = 1e-6;   // 自动微分路径 (直接 LU) 与 double 路径的压力相对差异 (GMRES 路径实测 6e-8)
+const QStringList kSensitivityNames = { "kf", "km", "omega1", "lambda1", "cD", "S" };
+// 无限大 (变井储)、封闭 (恒定井储)、定压 (变井储) 边界各一个模型
+const ModelSolver01_06::ModelType kSensitivityModels[] = { ModelSolver01_06::Model_1, ModelSolver01_06::Model_4, ModelSolver01_06::Model_5 };
+
+// 叠加检查: 五段产量 (含关井)，主网格 20 点/十倍程 (RateSuperposition 默认)
+const double kRateDurations[] = { 10.0, 5.0, 20.0, 3.0, 40.0 };
+const double kRateValues[] = { 5.0, 8.0, 0.0, 3.0, 6.0 };
+const double kMaxSuperpositionError = 1e-4;    // 实测参数矩阵上最大 1.6e-5
+
+// 反褶积检查: Model_1 + 首个参数组，产量 5 ± 3 (每 5 段关井一次)，段长 1 ~ 2 h，数据等间隔采样
+const int kDeconvolutionPeriods = 500;
+const int kDeconvolutionPoints = 100000;
+const double kDeconvolutionInitialPressure = 30.0;
+const double kMaxDeconvolutionLogErrorP = 0.01;      // 实测 2.2e-3
+const double kMaxDeconvolutionLogErrorDP = 0.05;     // 实测 1.9e-2
+const double kMaxInitialPressureError = 1e-3;       // |p0 - 真值| / max Δp，实测 2.3e-4
+
+QJsonArray toJsonArray(const QVector<double>& v)
+{
+    QJsonArray a;
+    for (double x : v) a.append(x);
+    return a;
+}
+
+QVector<double> fromJsonArray(const QJsonValue& value)
+{
+    QVector<double> v;
+    const QJsonArray a = value.toArray();
+    v.reserve(a.size());
+    for (const QJsonValue& x : a) v.append(x.toDouble());
+    return v;
+}
+
+double positiveMax(const QVector<double>& v)
+{
+    double m = 0.0;
+    for (double x : v) m = qMax(m, x);
+    return m;
+}
+
+AccuracyGate::Case caseFromJson(const QJsonObject& caseObj)
+{
+    AccuracyGate::Case c;
+    c.name = caseObj.value("name").toString();
+    const QJsonObject paramObj = caseObj.value("params").toObject();
+    for (auto it = paramObj.constBegin(); it != paramObj.constEnd(); ++it) c.params[it.key()] = it.value().toDouble();
+    return c;
+}
+} // namespace
+
+AccuracyGate::AccuracyGate(const Options& options)
+    : m_options(options)
+{
+}
+
+QVector<AccuracyGate::Tier> AccuracyGate::tiers()
+{
+    QVector<Tier> list;
+
+    // 最终精度: solver 默认积分设置 + 模型页高精度 N=8 (逐项基线最大 p 7e-4 / dp 4e-2)
+    ModelSolver01_06 defaults(ModelSolver01_06::Model_1);
+    list.append({ "final", true, 8, defaults.quadratureTolerance(), defaults.quadratureMaxDepth(), false, 2e-3, 8e-2 });
+
+    // 渐进式计算的预览阶段 (N=4，宽松积分容差；逐项基线最大 p 6e-2 / dp 0.38)
+    const QVector<ProgressiveCurveRunner::Stage> stages = ProgressiveCurveRunner::defaultPreviewStages();
+    for (int i = 0; i < stages.size(); ++i) {
+        const ProgressiveCurveRunner::Stage& st = stages[i];
+        list.append({ stages.size() == 1 ? QString("preview") : QString("preview%1").arg(i + 1),
+                      st.highPrecision, 8, st.quadTolerance, st.quadMaxDepth, st.singlePrecisionKernel, 0.1, 0.6 });
+    }
+    return list;
+}
+
+QVector<AccuracyGate::Case> AccuracyGate::cases()
+{
+    QVector<Case> list;
+
+    Case base;
+    base.name = "nf1";
+    base.params["kf"] = 10.0; base.params["km"] = 1.0;
+    base.params["LfD"] = 0.1; base.params["rmD"] = 4.0; base.params["reD"] = 10.0;
+    base.params["omega1"] = 0.4; base.params["omega2"] = 0.08; base.params["lambda1"] = 1e-3;
+    base.params["gamaD"] = 0.02; base.params["cD"] = 0.01; base.params["S"] = 1.0;
+    base.params["nf"] = 1;
+    list.append(base);
+
+    // 低导流比、强窜流、无压敏
+    Case c = base;
+    c.name = "nf4_lowM";
+    c.params["kf"] = 2.0; c.params["rmD"] = 3.0; c.params["reD"] = 20.0;
+    c.params["omega1"] = 0.2; c.params["omega2"] = 0.05; c.params["lambda1"] = 1e-2;
+    c.params["gamaD"] = 0.0; c.params["cD"] = 0.1; c.params["S"] = 0.5;
+    c.params["nf"] = 4;
+    list.append(c);
+
+    // 多段短裂缝、高导流比、弱窜流
+    c = base;
+    c.name = "nf16_highM";
+    c.params["kf"] = 50.0; c.params["LfD"] = 0.05; c.params["rmD"] = 6.0; c.params["reD"] = 30.0;
+    c.params["lambda1"] = 1e-4; c.params["gamaD"] = 0.0;
+    c.params["nf"] = 16;
+    list.append(c);
+
+    // 超过直接解法上限 (32 条) 的 GMRES/块 Jacobi 路径，且多数裂缝对落在远场固定阶规则内
+    // 参数取条件数适中的组合: 高导流比 + 密集长裂缝时积分矩阵病态，N=12 的参考解本身不收敛
+    c = base;
+    c.name = "nf64_shortF";
+    c.params["LfD"] = 0.01; c.params["rmD"] = 3.0; c.params["reD"] = 15.0;
+    c.params["nf"] = 64;
+    list.append(c);
+
+    c = base;
+    c.name = "nf128_highM";
+    c.params["kf"] = 30.0; c.params["LfD"] = 0.02; c.params["rmD"] = 5.0; c.params["reD"] = 25.0;
+    c.params["omega1"] = 0.3; c.params["lambda1"] = 1e-2; c.params["gamaD"] = 0.01; c.params["cD"] = 0.05;
+    c.params["nf"] = 128;
+    list.append(c);
+    return list;
+}
+
+QVector<double> AccuracyGate::timeGrid()
+{
+    return ModelSolver01_06::generateLogTimeSteps(25, -3.0, 5.0);
+}
+
+QString AccuracyGate::modelName(ModelSolver01_06::ModelType type)
+{
+    return QString("Model_%1").arg(int(type) + 1);
+}
+
+bool AccuracyGate::enabled(const Tier& tier) const
+{
+    return m_options.filter.isEmpty() || tier.name.contains(m_options.filter, Qt::CaseInsensitive);
+}
+
+double AccuracyGate::maxLogError(const QVector<double>& value, const QVector<double>& reference, double floor)
+{
+    double err = 0.0;
+    int n = qMin(value.size(), reference.size());
+    for (int i = 0; i < n; ++i) {
+        if (!(reference[i] > floor)) continue;
+        if (!(value[i] > 0.0) || !std::isfinite(value[i])) return std::numeric_limits<double>::infinity();
+        err = qMax(err, std::abs(std::log10(value[i]) - std::log10(reference[i])));
+    }
+    if (value.size() != reference.size()) return std::numeric_limits<double>::infinity();
+    return err;
+}
+
+double AccuracyGate::maxRelativeDifference(const QVector<double>& value, const QVector<double>& reference)
+{
+    if (value.size() != reference.size()) return std::numeric_limits<double>::infinity();
+    double diff = 0.0;
+    for (int i = 0; i < value.size(); ++i) {
+        if (reference[i] == 0.0) continue;
+        diff = qMax(diff, std::abs(value[i] - reference[i]) / std::abs(reference[i]));
+    }
+    return diff;
+}
+
+ModelSolver01_06 AccuracyGate::tierSolver(ModelSolver01_06::ModelType type, const Tier& tier)
+{
+    ModelSolver01_06 solver(type);
+    solver.setHighPrecision(tier.highPrecision);
+    solver.setQuadrature(tier.quadTolerance, tier.quadMaxDepth);
+    solver.setSinglePrecisionKernel(tier.singlePrecisionKernel);
+    return solver;
+}
+
+AccuracyGate::TierResult AccuracyGate::evaluate(ModelSolver01_06::ModelType type, const Tier& tier, const Case& c, const QVector<double>& tD)
+{
+    QMap<QString, double> params = c.params;
+    params["N"] = tier.stehfestN;
+
+    TierResult r;
+    ModelCurveData curve = tierSolver(type, tier).calculateDimensionlessCurve(params, tD, &r.stats);
+    r.pD = std::get<1>(curve);
+    r.dpD = std::get<2>(curve);
+    return r;
+}
+
+QJsonObject AccuracyGate::computeBudgets(const QJsonObject& root, QTextStream& log) const
+{
+    const QVector<double> tD = fromJsonArray(root.value("tD"));
+    const QJsonArray caseArray = root.value("cases").toArray();
+    const double floorRatio = root.value("reference").toObject().value("derivativeFloorRatio").toDouble(kDerivativeFloorRatio);
+
+    QJsonObject budgets;
+    for (const Tier& tier : tiers()) {
+        QJsonObject tierBudget;
+        double worstP = 0.0, worstDP = 0.0;
+        for (const QJsonValue& cv : caseArray) {
+            const QJsonObject caseObj = cv.toObject();
+            const Case c = caseFromJson(caseObj);
+            const QJsonObject models = caseObj.value("models").toObject();
+            for (int m = 0; m < 6; ++m) {
+                ModelSolver01_06::ModelType type = ModelSolver01_06::ModelType(m);
+                const QJsonObject refObj = models.value(modelName(type)).toObject();
+                const QVector<double> refDP = fromJsonArray(refObj.value("dpD"));
+
+                TierResult r = evaluate(type, tier, c, tD);
+                double errP = maxLogError(r.pD, fromJsonArray(refObj.value("pD")), 0.0);
+                double errDP = maxLogError(r.dpD, refDP, floorRatio * positiveMax(refDP));
+                worstP = qMax(worstP, errP);
+                worstDP = qMax(worstDP, errDP);
+
+                QJsonObject cost;
+                cost["laplaceEvaluations"] = double(r.stats.laplaceEvaluations);
+                cost["integrandCalls"] = double(r.stats.integrandCalls);
+                cost["maxLogErrorP"] = errP;
+                cost["maxLogErrorDP"] = errDP;
+                tierBudget[c.name + "/" + modelName(type)] = cost;
+            }
+        }
+        budgets[tier.name] = tierBudget;
+        // 基线超过档位上限时照常写入，检查时仍按上限判为失败
+        log << "精度/代价基线: " << tier.name << QString(" (最大对数误差 p %1 / dp %2)").arg(worstP, 0, 'e', 2).arg(worstDP, 0, 'e', 2);
+        if (!(worstP <= tier.maxLogErrorP && worstDP <= tier.maxLogErrorDP)) log << "  超过档位上限";
+        log << "\n";
+        log.flush();
+    }
+    return budgets;
+}
+
+bool AccuracyGate::generate(QTextStream& log, QString* error)
+{
+    const QVector<double> tD = timeGrid();
+    const Tier reference = { "reference", true, kReferenceN, kReferenceQuadTolerance, kReferenceQuadMaxDepth, false, 0.0, 0.0 };
+    QVector<ModelSolver01_06::ModelType> types;
+    for (int m = 0; m < 6; ++m) types.append(ModelSolver01_06::ModelType(m));
+
+    QJsonObject root;
+    root["schema"] = 1;
+    QJsonObject settings;
+    settings["stehfestN"] = kReferenceN;
+    settings["quadTolerance"] = kReferenceQuadTolerance;
+    settings["quadMaxDepth"] = kReferenceQuadMaxDepth;
+    settings["derivativeFloorRatio"] = kDerivativeFloorRatio;
+    root["reference"] = settings;
+    root["tD"] = toJsonArray(tD);
+
+    QJsonArray caseArray;
+    for (const Case& c : cases()) {
+        QElapsedTimer timer;
+        timer.start();
+        QMap<QString, double> params = c.params;
+        params["N"] = reference.stehfestN;
+        // 六个模型一次计算 (与逐个计算结果逐位一致)
+        QVector<ModelCurveData> curves = tierSolver(ModelSolver01_06::Model_1, reference).calculateDimensionlessCurves(params, types, tD);
+
+        QJsonObject paramObj;
+        for (auto it = c.params.constBegin(); it != c.params.constEnd(); ++it) paramObj[it.key()] = it.value();
+        QJsonObject models;
+        for (int m = 0; m < types.size(); ++m) {
+            QJsonObject curve;
+            curve["pD"] = toJsonArray(std::get<1>(curves[m]));
+            curve["dpD"] = toJsonArray(std::get<2>(curves[m]));
+            models[modelName(types[m])] = curve;
+        }
+        QJsonObject caseObj;
+        caseObj["name"] = c.name;
+        caseObj["params"] = paramObj;
+        caseObj["models"] = models;
+        caseArray.append(caseObj);
+        log << "参考曲线: " << c.name << " (" << timer.elapsed() << " ms)\n";
+        log.flush();
+    }
+    root["cases"] = caseArray;
+    root["budgets"] = computeBudgets(root, log);
+    return save(root, error);
+}
+
+bool AccuracyGate::rebaseline(QTextStream& log, QString* error)
+{
+    QJsonObject root;
+    if (!load(root, error)) return false;
+    root["budgets"] = computeBudgets(root, log);
+    return save(root, error);
+}
+
+bool AccuracyGate::load(QJsonObject& root, QString* error) const
+{
+    QFile f(m_options.referencePath);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("无法打开参考文件: %1").arg(m_options.referencePath);
+        return false;
+    }
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) *error = QString("参考文件格式错误: %1").arg(parseError.errorString());
+        return false;
+    }
+    root = doc.object();
+    if (root.value("schema").toInt() != 1) {
+        if (error) *error = "参考文件版本不匹配";
+        return false;
+    }
+    return true;
+}
+
+bool AccuracyGate::save(const QJsonObject& root, QString* error) const
+{
+    QFile f(m_options.referencePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = QString("无法写入参考文件: %1").arg(m_options.referencePath);
+        return false;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+int AccuracyGate::checkSensitivities(const QJsonArray& caseArray, QTextStream& log, QJsonObject& report) const
+{
+    // 最终精度档位的引擎设置；参数矩阵直接作为有量纲参数 (量纲换算参数取默认值)，时间 1e-3 ~ 1e5 h
+    const Tier tier = tiers().first();
+    const QVector<double> t = ModelSolver01_06::generateLogTimeSteps(9, -3.0, 5.0);
+
+    log << "# sensitivity" << QString(" (自动微分 vs 中心差分，相对步长 1e-3/1e-4/1e-5; 容差 %1, 压力差异 %2)\n")
+               .arg(kMaxSensitivityError).arg(kMaxSensitivityValueDiff);
+    log << QString("%1 %2 %3 %4 %5").arg("case/model", -22).arg("valueDiff", 10).arg("maxError", 10).arg("worstParam", 11).arg("ms", 8) << "\n";
+
+    int failures = 0;
+    double worstError = 0.0, worstValueDiff = 0.0;
+    QJsonArray rows;
+    for (const QJsonValue& cv : caseArray) {
+        const QJsonObject caseObj = cv.toObject();
+        const QString caseName = caseObj.value("name").toString();
+        QMap<QString, double> params;
+        const QJsonObject paramObj = caseObj.value("params").toObject();
+        for (auto it = paramObj.constBegin(); it != paramObj.constEnd(); ++it) params[it.key()] = it.value().toDouble();
+        params["N"] = tier.stehfestN;
+
+        for (ModelSolver01_06::ModelType type : kSensitivityModels) {
+            const QString key = caseName + "/" + modelName(type);
+            ModelSolver01_06 solver = tierSolver(type, tier);
+            QElapsedTimer timer;
+            timer.start();
+
+            QVector<double> p;
+            QVector<QVector<double>> dp;
+            bool ok = solver.calculatePressureSensitivities(params, kSensitivityNames, t, p, dp);
+            QVector<double> reference = solver.calculatePressure(params, t);
+            double valueDiff = ok ? maxRelativeDifference(p, reference) : std::numeric_limits<double>::infinity();
+            double scale = 0.0;
+            for (double v : reference) scale = qMax(scale, std::abs(v));
+
+            double maxError = ok ? 0.0 : std::numeric_limits<double>::infinity();
+            QString worstName;
+            QJsonObject errors;
+            for (int j = 0; ok && j < kSensitivityNames.size(); ++j) {
+                const QString& name = kSensitivityNames[j];
+                double v = params.value(name);
+                if (v == 0.0) continue;
+                double err = std::numeric_limits<double>::infinity();
+                for (double step : kSensitivitySteps) {
+                    double h = step * std::abs(v);
+                    QMap<QString, double> plus = params, minus = params;
+                    plus[name] = v + h;
+                    minus[name] = v - h;
+                    QVector<double> pp = solver.calculatePressure(plus, t);
+                    QVector<double> pm = solver.calculatePressure(minus, t);
+                    double e = 0.0;
+                    for (int i = 0; i < t.size(); ++i) e = qMax(e, std::abs(v * ((pp[i] - pm[i]) / (2.0 * h) - dp[j][i])));
+                    err = qMin(err, scale > 0.0 ? e / scale : e);
+                }
+                errors[name] = err;
+                if (!(err <= maxError)) { maxError = err; worstName = name; }
+            }
+
+            QStringList problems;
+            if (!ok) problems << "不支持自动微分";
+            if (!(valueDiff <= kMaxSensitivityValueDiff)) problems << "压力与 double 路径不一致";
+            if (!(maxError <= kMaxSensitivityError)) problems << "偏导与中心差分不一致";
+            failures += problems.size();
+            worstError = qMax(worstError, maxError);
+            worstValueDiff = qMax(worstValueDiff, valueDiff);
+
+            log << QString("%1 %2 %3 %4 %5").arg(key, -22).arg(valueDiff, 10, 'e', 2).arg(maxError, 10, 'e', 2)
+                       .arg(worstName, 11).arg(double(timer.elapsed()), 8, 'f', 1);
+            if (!problems.isEmpty()) log << "  FAIL: " << problems.join(", ");
+            log << "\n";
+            log.flush();
+
+            QJsonObject row;
+            row["case"] = caseName;
+            row["model"] = modelName(type);
+            row["valueDifference"] = valueDiff;
+            row["maxError"] = maxError;
+            row["errors"] = errors;
+            row["problems"] = QJsonArray::fromStringList(problems);
+            rows.append(row);
+        }
+    }
+    log << QString("sensitivity: 最大误差 %1, 压力最大相对差异 %2\n\n").arg(worstError, 0, 'e', 2).arg(worstValueDiff, 0, 'e', 2);
+
+    report["maxError"] = worstError;
+    report["maxValueDifference"] = worstValueDiff;
+    report["tolerance"] = kMaxSensitivityError;
+    report["valueTolerance"] = kMaxSensitivityValueDiff;
+    report["rows"] = rows;
+    return failures;
+}
+
+int AccuracyGate::checkSuperposition(const QJsonArray& caseArray, QTextStream& log, QJsonObject& report) const
+{
+    const Tier tier = tiers().first();
+    QVector<double> durations, rates;
+    for (double d : kRateDurations) durations.append(d);
+    for (double q : kRateValues) rates.append(q);
+    const RateSchedule schedule = RateSchedule::fromDurations(durations, rates);
+    const RateSuperposition superposition(schedule);
+    // 观测时间 0.01 ~ 78 h (覆盖每次产量变化后的早期)，每十倍程 15 点
+    const QVector<double> t = ModelSolver01_06::generateLogTimeSteps(61, -2.0, std::log10(78.0));
+
+    log << "# superposition" << QString(" (%1 段产量，主网格 %2 点/十倍程; 容差 %3)\n")
+               .arg(schedule.rates.size()).arg(superposition.pointsPerDecade()).arg(kMaxSuperpositionError);
+    log << QString("%1 %2 %3 %4 %5").arg("case/model", -22).arg("maxError", 10).arg("laplace", 10).arg("directLap", 10).arg("ms", 8) << "\n";
+
+    int failures = 0;
+    double worstError = 0.0;
+    QJsonArray rows;
+    for (const QJsonValue& cv : caseArray) {
+        const QJsonObject caseObj = cv.toObject();
+        const QString caseName = caseObj.value("name").toString();
+        QMap<QString, double> params;
+        const QJsonObject paramObj = caseObj.value("params").toObject();
+        for (auto it = paramObj.constBegin(); it != paramObj.constEnd(); ++it) params[it.key()] = it.value().toDouble();
+        params["N"] = tier.stehfestN;
+
+        for (ModelSolver01_06::ModelType type : kSensitivityModels) {
+            const QString key = caseName + "/" + modelName(type);
+            ModelSolver01_06 solver = tierSolver(type, tier);
+            QElapsedTimer timer;
+            timer.start();
+            EngineStats stats;
+            QVector<double> p = superposition.calculatePressure(solver, params, t, &stats);
+
+            // 直接叠加: 每个产量阶跃以各自的 t - t_j 调用一次引擎
+            QMap<QString, double> unit = params;
+            unit["q"] = 1.0;
+            EngineStats directStats;
+            QVector<double> direct(t.size(), 0.0);
+            for (int j = 0; j < schedule.rates.size(); ++j) {
+                double dq = schedule.rates[j] - (j > 0 ? schedule.rates[j - 1] : 0.0);
+                QVector<double> dt;
+                int i0 = 0;
+                while (i0 < t.size() && t[i0] <= schedule.startTimes[j]) ++i0;
+                for (int i = i0; i < t.size(); ++i) dt.append(t[i] - schedule.startTimes[j]);
+                if (dq == 0.0 || dt.isEmpty()) continue;
+                QVector<double> pu = solver.calculatePressure(unit, dt, &directStats);
+                for (int i = i0; i < t.size(); ++i) direct[i] += dq * pu[i - i0];
+            }
+
+            double scale = 0.0, err = 0.0;
+            for (double v : direct) scale = qMax(scale, std::abs(v));
+            for (int i = 0; i < t.size(); ++i) err = qMax(err, std::abs(p[i] - direct[i]));
+            err = (scale > 0.0 && p.size() == t.size()) ? err / scale : std::numeric_limits<double>::infinity();
+
+            QStringList problems;
+            if (!(err <= kMaxSuperpositionError)) problems << "叠加结果与直接叠加不一致";
+            failures += problems.size();
+            worstError = qMax(worstError, err);
+
+            log << QString("%1 %2 %3 %4 %5").arg(key, -22).arg(err, 10, 'e', 2).arg(stats.laplaceEvaluations, 10)
+                       .arg(directStats.laplaceEvaluations, 10).arg(double(timer.elapsed()), 8, 'f', 1);
+            if (!problems.isEmpty()) log << "  FAIL: " << problems.join(", ");
+            log << "\n";
+            log.flush();
+
+            QJsonObject row;
+            row["case"] = caseName;
+            row["model"] = modelName(type);
+            row["maxError"] = err;
+            row["laplaceEvaluations"] = double(stats.laplaceEvaluations);
+            row["directLaplaceEvaluations"] = double(directStats.laplaceEvaluations);
+            row["problems"] = QJsonArray::fromStringList(problems);
+            rows.append(row);
+        }
+    }
+    log << QString("superposition: 最大误差 %1\n\n").arg(worstError, 0, 'e', 2);
+
+    report["maxError"] = worstError;
+    report["tolerance"] = kMaxSuperpositionError;
+    report["rows"] = rows;
+    return failures;
+}
+
+int AccuracyGate::checkDeconvolution(const QJsonArray& caseArray, QTextStream& log, QJsonObject& report) const
+{
+    const Tier tier = tiers().first();
+    const ModelSolver01_06::ModelType type = ModelSolver01_06::Model_1;
+    const QJsonObject caseObj = caseArray.isEmpty() ? QJsonObject() : caseArray.first().toObject();
+    QMap<QString, double> params;
+    const QJsonObject paramObj = caseObj.value("params").toObject();
+    for (auto it = paramObj.constBegin(); it != paramObj.constEnd(); ++it) params[it.key()] = it.value().toDouble();
+    params["N"] = tier.stehfestN;
+
+    RateSchedule schedule;
+    double tEnd = 0.0;
+    for (int j = 0; j < kDeconvolutionPeriods; ++j) {
+        schedule.startTimes.append(tEnd);
+        schedule.rates.append(j % 5 == 4 ? 0.0 : 5.0 + 3.0 * std::sin(0.7 * j));
+        tEnd += 1.0 + 0.5 * (1.0 + std::cos(1.3 * j));
+    }
+    QVector<double> t(kDeconvolutionPoints);
+    for (int i = 0; i < t.size(); ++i) t[i] = tEnd * (i + 1.0) / t.size();
+
+    // 合成数据: 主网格 40 点/十倍程叠加 (误差远小于容差)
+    ModelSolver01_06 solver = tierSolver(type, tier);
+    const QVector<double> dp = RateSuperposition(schedule, 40).calculatePressure(solver, params, t);
+    QVector<double> p(t.size());
+    double dpMax = 0.0;
+    for (int i = 0; i < t.size(); ++i) {
+        p[i] = kDeconvolutionInitialPressure - dp[i];
+        dpMax = qMax(dpMax, std::abs(dp[i]));
+    }
+
+    log << "# deconvolution" << QString(" (%1 段产量，%2 点，%3 / %4; 容差 p %5 / dp %6 / p0 %7)\n")
+               .arg(kDeconvolutionPeriods).arg(kDeconvolutionPoints).arg(caseObj.value("name").toString()).arg(modelName(type))
+               .arg(kMaxDeconvolutionLogErrorP).arg(kMaxDeconvolutionLogErrorDP).arg(kMaxInitialPressureError);
+
+    QElapsedTimer timer;
+    timer.start();
+    const PressureRateDeconvolution::Result r = PressureRateDeconvolution(PressureRateDeconvolution::Options()).run(t, p, schedule);
+    double ms = double(timer.elapsed());
+
+    QStringList problems;
+    double errP = std::numeric_limits<double>::infinity(), errDP = errP, errP0 = errP;
+    int compared = 0;
+    if (!r.ok) {
+        problems << "反褶积失败: " + r.error;
+    } else {
+        // 真值: 参考产量下的引擎直接解；末节点只受最后一段约束，不参与比较
+        QMap<QString, double> reference = params;
+        reference["q"] = r.referenceRate;
+        const auto truth = solver.calculateTheoreticalCurve(reference, r.t);
+        const double tMin = 10.0 * tEnd / t.size();
+        errP = errDP = 0.0;
+        for (int k = 0; k + 1 < r.t.size(); ++k) {
+            if (r.t[k] < tMin) continue;
+            errP = qMax(errP, std::abs(std::log10(r.dp[k] / std::get<1>(truth)[k])));
+            errDP = qMax(errDP, std::abs(std::log10(r.derivative[k] / std::get<2>(truth)[k])));
+            ++compared;
+        }
+        if (compared == 0) errP = errDP = std::numeric_limits<double>::infinity();
+        errP0 = std::abs(r.initialPressure - kDeconvolutionInitialPressure) / dpMax;
+        if (!(errP <= kMaxDeconvolutionLogErrorP)) problems << "压力响应误差超过容差";
+        if (!(errDP <= kMaxDeconvolutionLogErrorDP)) problems << "导数误差超过容差";
+        if (!(errP0 <= kMaxInitialPressureError)) problems << "初始压力误差超过容差";
+    }
+
+    log << QString("deconvolution: 节点 %1 (比较 %2), 样本 %3, 迭代 %4, 最大对数误差 p %5 / dp %6, 初始压力误差 %7, %8 ms")
+               .arg(r.t.size()).arg(compared).arg(r.sampleTime.size()).arg(r.iterations)
+               .arg(errP, 0, 'e', 2).arg(errDP, 0, 'e', 2).arg(errP0, 0, 'e', 2).arg(ms, 0, 'f', 1);
+    if (!problems.isEmpty()) log << "  FAIL: " << problems.join(", ");
+    log << "\n\n";
+    log.flush();
+
+    report["maxLogErrorP"] = errP;
+    report["maxLogErrorDP"] = errDP;
+    report["initialPressureError"] = errP0;
+    report["toleranceP"] = kMaxDeconvolutionLogErrorP;
+    report["toleranceDP"] = kMaxDeconvolutionLogErrorDP;
+    report["toleranceInitialPressure"] = kMaxInitialPressureError;
+    report["iterations"] = r.iterations;
+    report["ms"] = ms;
+    report["problems"] = QJsonArray::fromStringList(problems);
+    return problems.size();
+}
+
+int AccuracyGate::run(QTextStream& log, QJsonObject* report)
+{
+    QJsonObject root;
+    QString error;
+    if (!load(root, &error)) {
+        log << error << "\n";
+        return -1;
+    }
+
+    const QVector<double> tD = fromJsonArray(root.value("tD"));
+    const QJsonArray caseArray = root.value("cases").toArray();
+    const QJsonObject budgets = root.value("budgets").toObject();
+    const double floorRatio = root.value("reference").toObject().value("derivativeFloorRatio").toDouble(kDerivativeFloorRatio);
+
+    int failures = 0;
+    QElapsedTimer total;
+    total.start();
+    QJsonArray tierArray;
+
+    for (const Tier& tier : tiers()) {
+        if (!enabled(tier)) continue;
+        const QJsonObject tierBudget = budgets.value(tier.name).toObject();
+
+        log << "# " << tier.name << QString(" (N=%1, 积分容差 %2 / %3 层%4; 误差上限 p %5, dp %6; 基线余量 %7)\n")
+                   .arg(tier.highPrecision ? tier.stehfestN : 4).arg(tier.quadTolerance).arg(tier.quadMaxDepth)
+                   .arg(tier.singlePrecisionKernel ? QString(", 单精度内核") : QString())
+                   .arg(tier.maxLogErrorP).arg(tier.maxLogErrorDP).arg(m_options.accuracySlack);
+        log << QString("%1 %2 %3 %4 %5 %6 %7 %8").arg("case/model", -22).arg("errP", 10).arg("baseP", 10)
+                   .arg("errDP", 10).arg("baseDP", 10).arg("integrand", 12).arg("budget", 12).arg("ms", 8);
+        if (tier.singlePrecisionKernel) log << QString(" %1 %2 %3").arg("vsDouble", 10).arg("bound", 10).arg("doubleMs", 9);
+        log << "\n";
+
+        // 单精度内核档位: 同设置的双精度路径，用于核对误差上界
+        Tier doubleTier = tier;
+        doubleTier.singlePrecisionKernel = false;
+
+        double worstP = 0.0, worstDP = 0.0, worstFloatDiff = 0.0, worstFloatBound = 0.0, tierMs = 0.0, doubleMs = 0.0;
+        qint64 tierIntegrand = 0, tierLaplace = 0;
+        QJsonArray rows;
+
+        for (const QJsonValue& cv : caseArray) {
+            const QJsonObject caseObj = cv.toObject();
+            const Case c = caseFromJson(caseObj);
+            const QJsonObject models = caseObj.value("models").toObject();
+
+            for (int m = 0; m < 6; ++m) {
+                ModelSolver01_06::ModelType type = ModelSolver01_06::ModelType(m);
+                const QString key = c.name + "/" + modelName(type);
+                const QJsonObject refObj = models.value(modelName(type)).toObject();
+                const QVector<double> refP = fromJsonArray(refObj.value("pD"));
+                const QVector<double> refDP = fromJsonArray(refObj.value("dpD"));
+
+                TierResult r = evaluate(type, tier, c, tD);
+                double errP = maxLogError(r.pD, refP, 0.0);
+                double errDP = maxLogError(r.dpD, refDP, floorRatio * positiveMax(refDP));
+                const QJsonObject baseline = tierBudget.value(key).toObject();
+                double budget = baseline.value("integrandCalls").toDouble(-1.0);
+                double baseP = baseline.value("maxLogErrorP").toDouble(-1.0);
+                double baseDP = baseline.value("maxLogErrorDP").toDouble(-1.0);
+
+                QStringList problems;
+                if (refP.isEmpty()) problems << "缺少参考曲线";
+                if (!(errP <= tier.maxLogErrorP)) problems << "压力误差超限";
+                if (!(errDP <= tier.maxLogErrorDP)) problems << "导数误差超限";
+                if (baseP < 0 || baseDP < 0) problems << "缺少精度基线";
+                else {
+                    if (!(errP <= baseP * (1.0 + m_options.accuracySlack) + kAccuracyFloor)) problems << "压力误差超出基线";
+                    if (!(errDP <= baseDP * (1.0 + m_options.accuracySlack) + kAccuracyFloor)) problems << "导数误差超出基线";
+                }
+                if (budget < 0) problems << "缺少代价基线";
+                else if (r.stats.integrandCalls > budget * (1.0 + m_options.costSlack)) problems << "求值次数超出预算";
+
+                double floatDiff = 0.0, floatBound = 0.0, rowDoubleMs = 0.0;
+                if (tier.singlePrecisionKernel) {
+                    TierResult d = evaluate(type, doubleTier, c, tD);
+                    floatDiff = maxRelativeDifference(r.pD, d.pD);
+                    floatBound = r.stats.maxFloatErrorBound;
+                    rowDoubleMs = d.stats.totalMs;
+                    if (!(floatDiff <= floatBound)) problems << "单精度差异超出误差上界";
+                    worstFloatDiff = qMax(worstFloatDiff, floatDiff);
+                    worstFloatBound = qMax(worstFloatBound, floatBound);
+                    doubleMs += rowDoubleMs;
+                }
+                failures += problems.size();
+
+                worstP = qMax(worstP, errP);
+                worstDP = qMax(worstDP, errDP);
+                tierMs += r.stats.totalMs;
+                tierIntegrand += r.stats.integrandCalls;
+                tierLaplace += r.stats.laplaceEvaluations;
+
+                log << QString("%1 %2 %3 %4 %5 %6 %7 %8").arg(key, -22).arg(errP, 10, 'e', 2).arg(baseP, 10, 'e', 2)
+                           .arg(errDP, 10, 'e', 2).arg(baseDP, 10, 'e', 2).arg(r.stats.integrandCalls, 12).arg(qint64(budget), 12).arg(r.stats.totalMs, 8, 'f', 1);
+                if (tier.singlePrecisionKernel) {
+                    log << QString(" %1 %2 %3").arg(floatDiff, 10, 'e', 2).arg(floatBound, 10, 'e', 2).arg(rowDoubleMs, 9, 'f', 1);
+                }
+                if (!problems.isEmpty()) log << "  FAIL: " << problems.join(", ");
+                log << "\n";
+                log.flush();
+
+                QJsonObject row;
+                row["case"] = c.name;
+                row["model"] = modelName(type);
+                row["maxLogErrorP"] = errP;
+                row["maxLogErrorDP"] = errDP;
+                row["baselineLogErrorP"] = baseP;
+                row["baselineLogErrorDP"] = baseDP;
+                row["laplaceEvaluations"] = double(r.stats.laplaceEvaluations);
+                row["integrandCalls"] = double(r.stats.integrandCalls);
+                row["integrandBudget"] = budget;
+                row["ms"] = r.stats.totalMs;
+                if (tier.singlePrecisionKernel) {
+                    row["maxRelativeDifferenceToDouble"] = floatDiff;
+                    row["floatErrorBound"] = floatBound;
+                    row["doubleMs"] = rowDoubleMs;
+                }
+                row["problems"] = QJsonArray::fromStringList(problems);
+                rows.append(row);
+            }
+        }
+
+        log << QString("%1: 最大对数误差 p %2 / dp %3, Laplace 求值 %4, 被积函数调用 %5, %6 ms\n")
+                   .arg(tier.name).arg(worstP, 0, 'e', 2).arg(worstDP, 0, 'e', 2)
+                   .arg(tierLaplace).arg(tierIntegrand).arg(tierMs, 0, 'f', 1);
+        if (tier.singlePrecisionKernel) {
+            log << QString("%1: 相对双精度路径最大差异 %2 (误差上界 %3), 双精度耗时 %4 ms\n")
+                       .arg(tier.name).arg(worstFloatDiff, 0, 'e', 2).arg(worstFloatBound, 0, 'e', 2).arg(doubleMs, 0, 'f', 1);
+        }
+        log << "\n";
+
+        QJsonObject tierObj;
+        tierObj["name"] = tier.name;
+        tierObj["maxLogErrorP"] = worstP;
+        tierObj["maxLogErrorDP"] = worstDP;
+        tierObj["toleranceP"] = tier.maxLogErrorP;
+        tierObj["toleranceDP"] = tier.maxLogErrorDP;
+        tierObj["laplaceEvaluations"] = double(tierLaplace);
+        tierObj["integrandCalls"] = double(tierIntegrand);
+        tierObj["ms"] = tierMs;
+        tierObj["singlePrecisionKernel"] = tier.singlePrecisionKernel;
+        if (tier.singlePrecisionKernel) {
+            tierObj["maxRelativeDifferenceToDouble"] = worstFloatDiff;
+            tierObj["floatErrorBound"] = worstFloatBound;
+            tierObj["doubleMs"] = doubleMs;
+        }
+        tierObj["rows"] = rows;
+        tierArray.append(tierObj);
+    }
+
+    // 灵敏度、叠加、反褶积检查按名称 "sensitivity" / "superposition" / "deconvolution" 参与 --filter
+    QJsonObject sensitivity;
+    bool checkSensitivity = m_options.filter.isEmpty() || QString("sensitivity").contains(m_options.filter, Qt::CaseInsensitive);
+    if (checkSensitivity) failures += checkSensitivities(caseArray, log, sensitivity);
+    QJsonObject superposition;
+    bool checkRates = m_options.filter.isEmpty() || QString("superposition").contains(m_options.filter, Qt::CaseInsensitive);
+    if (checkRates) failures += checkSuperposition(caseArray, log, superposition);
+    QJsonObject deconvolution;
+    bool checkDeconv = m_options.filter.isEmpty() || QString("deconvolution").contains(m_options.filter, Qt::CaseInsensitive);
+    if (checkDeconv) failures += checkDeconvolution(caseArray, log, deconvolution);
+
+    double seconds = total.elapsed() / 1000.0;
+    if (m_options.maxSeconds > 0 && seconds > m_options.maxSeconds) {
+        log << QString("总耗时 %1 s 超过上限 %2 s\n").arg(seconds).arg(m_options.maxSeconds);
+        ++failures;
+    }
+    log << (failures == 0 ? QString("PASS") : QString("FAIL (%1 项)").arg(failures))
+        << QString(", 总耗时 %1 s\n").arg(seconds, 0, 'f', 2);
+
+    if (report) {
+        (*report)["schema"] = 1;
+        (*report)["tiers"] = tierArray;
+        if (checkSensitivity) (*report)["sensitivity"] = sensitivity;
+        if (checkRates) (*report)["superposition"] = superposition;
+        if (checkDeconv) (*report)["deconvolution"] = deconvolution;
+        (*report)["costSlack"] = m_options.costSlack;
+        (*report)["accuracySlack"] = m_options.accuracySlack;
+        (*report)["accuracyFloor"] = kAccuracyFloor;
+        (*report)["totalSeconds"] = seconds;
+        (*report)["failures"] = failures;
+    }
+    return failures;
+}
@@ -0,0 +1,102 @@
+/*
+ * accuracygate.h
+ * 文件作用：计算引擎精度/代价回归门禁
+ * 功能描述：
+ * 1. 参数矩阵: 六个模型 × 若干无因次参数组 (1 ~ 128 条裂缝，覆盖直接解法与 GMRES 路径)，时间网格固定 (tD = 1e-3 ~ 1e5，25 点)
+ * 2. 参考曲线以高精度设置 (Stehfest N=12、积分容差 1e-10 / 30 层) 预先计算并保存为 JSON
+ * 3. 每个计算档位 (最终精度、渐进式预览...) 计算全部曲线，报告压力与导数的最大对数误差、
+ *    积分/Laplace 求值次数与耗时
+ * 4. 每个参数组/模型的误差超过其精度基线 × (1 + accuracySlack) + 1e-4、或求值次数超过代价基线 × (1 + costSlack) 时判为失败；
+ *    档位容差为误差的绝对上限 (基线本身也不得超过)
+ * 5. 单精度内核档位另以同设置的双精度路径计算，实际差异超过引擎报告的误差上界时判为失败
+ * 6. 灵敏度检查 (sensitivity): 自动微分路径 (calculatePressureSensitivities) 的压力与偏导
+ *    分别与 double 路径及其中心差分比较 (参数矩阵 × 三种边界各一个模型，nf > 32 时 double 路径为 GMRES)
+ * 7. 叠加检查 (superposition): 变产量历史 (含关井) 下 RateSuperposition 的主网格插值结果与逐个产量阶跃直接计算的叠加比较
+ * 8. 反褶积检查 (deconvolution): 500 段产量、10 万点的合成压力历史 (无噪声) 反褶积，单位产量响应与导数与引擎直接计算比较
+ * 新增或修改计算档位时应在 tiers() 中登记容差，并用 --rebaseline 更新精度/代价基线。
+ */
+
+#ifndef ACCURACYGATE_H
+#define ACCURACYGATE_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+#include "modelsolver01-06.h"
+
+class AccuracyGate
+{
+public:
+    struct Options {
+        QString referencePath;     // 参考曲线文件
+        double costSlack = 0.25;   // 允许求值次数超过基线的比例
+        double accuracySlack = 0.25;   // 允许对数误差超过基线的比例
+        double maxSeconds = 0.0;   // 全部档位总耗时上限 (秒)，0 表示不检查 (耗时随机器变化)
+        QString filter;            // 只检查名称包含该字符串的档位
+    };
+
+    // 计算档位: solver 精度设置 + 对数误差上限 (log10 单位)
+    struct Tier {
+        QString name;
+        bool highPrecision;
+        int stehfestN;          // 高精度时的 Stehfest N
+        double quadTolerance;
+        int quadMaxDepth;
+        bool singlePrecisionKernel;
+        double maxLogErrorP;    // 压力最大对数误差
+        double maxLogErrorDP;   // 导数最大对数误差
+    };
+
+    struct Case {
+        QString name;
+        QMap<QString, double> params;   // 无因次参数 (kf = M12, km = 1)
+    };
+
+    explicit AccuracyGate(const Options& options);
+
+    static QVector<Tier> tiers();
+    static QVector<Case> cases();
+    static QVector<double> timeGrid();
+
+    // 以高精度设置重新计算全部参考曲线，并生成各档位精度/代价基线 (耗时较长)
+    bool generate(QTextStream& log, QString* error = nullptr);
+    // 保留参考曲线，只重新生成各档位精度/代价基线
+    bool rebaseline(QTextStream& log, QString* error = nullptr);
+    // 检查全部档位，返回失败项数 (参考文件无法读取时返回 -1)；report 为完整结果
+    int run(QTextStream& log, QJsonObject* report = nullptr);
+
+    // 对数误差: 参考值不大于 floor 的点不参与比较，计算值非正时误差为无穷大
+    static double maxLogError(const QVector<double>& value, const QVector<double>& reference, double floor);
+    // 最大相对差异 (参考值为零的点不参与比较)
+    static double maxRelativeDifference(const QVector<double>& value, const QVector<double>& reference);
+
+private:
+    struct TierResult {
+        QVector<double> pD;
+        QVector<double> dpD;
+        EngineStats stats;
+    };
+
+    static ModelSolver01_06 tierSolver(ModelSolver01_06::ModelType type, const Tier& tier);
+    static TierResult evaluate(ModelSolver01_06::ModelType type, const Tier& tier, const Case& c, const QVector<double>& tD);
+    static QString modelName(ModelSolver01_06::ModelType type);
+
+    // 返回失败项数；report 为逐行结果
+    int checkSensitivities(const QJsonArray& caseArray, QTextStream& log, QJsonObject& report) const;
+    int checkSuperposition(const QJsonArray& caseArray, QTextStream& log, QJsonObject& report) const;
+    int checkDeconvolution(const QJsonArray& caseArray, QTextStream& log, QJsonObject& report) const;
+
+    // 按参考文件中的参数组与参考曲线计算各档位基线 (误差 + 求值次数)
+    QJsonObject computeBudgets(const QJsonObject& root, QTextStream& log) const;
+    bool load(QJsonObject& root, QString* error) const;
+    bool save(const QJsonObject& root, QString* error) const;
+    bool enabled(const Tier& tier) const;
+
+private:
+    Options m_options;
+};
+
+#endif // ACCURACYGATE_H
@@ -0,0 +1,54 @@
+######################################################################
+# 计算引擎精度/代价回归门禁 (控制台程序，不依赖界面)
+# 用法: qmake accuracygate.pro && make && make check
+#       参考曲线: reference_curves.json (accuracygate --generate 重新生成)
+######################################################################
+QT += core gui concurrent
+QT -= widgets
+
+TEMPLATE = app
+TARGET = accuracygate
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -O3
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+# 单精度内核 (modelsolver01-06.cpp) 的向量化需要以下两项，不影响双精度结果 (默认 SSE 4 路)
+QMAKE_CXXFLAGS += -fno-math-errno -fno-trapping-math
+# 可选指令集: qmake CONFIG+=avx2 (AVX2 + FMA，8 路) 或 CONFIG+=avx512 (16 路)；生成的程序只能在支持该指令集的 CPU 上运行，
+# 且编译器会融合乘加，双精度结果与默认构建可能有末位差异
+avx2|avx512 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX2
+    else: QMAKE_CXXFLAGS += -mavx2 -mfma
+}
+avx512 {
+    msvc: QMAKE_CXXFLAGS += /arch:AVX512
+    else: QMAKE_CXXFLAGS += -mavx512f -mavx512dq
+}
+
+unix: LIBS += -lm
+win32: LIBS += -lm
+
+DEFINES += REFERENCE_FILE=\\\"$$PWD/reference_curves.json\\\"
+
+INCLUDEPATH += ..
+INCLUDEPATH += D:/08YYYXXX/eigen-3.3.8
+INCLUDEPATH += D:/08YYYXXX/boost_1_89_0
+
+HEADERS += accuracygate.h \
+           ../deconvolution.h \
+           ../fitscheduler.h \
+           ../modelsolver01-06.h \
+           ../pressurederivativecalculator.h \
+           ../progressivecurverunner.h \
+           ../superposition.h
+
+SOURCES += main.cpp \
+           accuracygate.cpp \
+           ../deconvolution.cpp \
+           ../fitscheduler.cpp \
+           ../modelsolver01-06.cpp \
+           ../pressurederivativecalculator.cpp \
+           ../progressivecurverunner.cpp \
+           ../superposition.cpp
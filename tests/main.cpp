@@ -0,0 +1,73 @@
+/*
+ * main.cpp (tests)
+ * 文件作用：精度/代价回归门禁入口
+ * 功能描述：
+ * 1. 默认检查全部计算档位，任一项失败时返回非零退出码 (可由 make check 调用)
+ * 2. --generate 重新计算参考曲线，--rebaseline 只更新各档位精度/代价基线
+ * 用法: accuracygate [--reference 文件] [--filter 档位] [--cost-slack 比例] [--accuracy-slack 比例] [--max-seconds 秒]
+ *                    [--report 文件] [--generate | --rebaseline]
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+#include "accuracygate.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("accuracygate");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("WellTest 计算引擎精度/代价回归门禁");
+    parser.addHelpOption();
+    QCommandLineOption referenceOption("reference", "参考曲线文件", "file", REFERENCE_FILE);
+    QCommandLineOption filterOption("filter", "只检查名称包含该字符串的档位", "tier");
+    QCommandLineOption slackOption("cost-slack", "允许求值次数超过基线的比例 (默认 0.25)", "ratio", "0.25");
+    QCommandLineOption accuracySlackOption("accuracy-slack", "允许对数误差超过基线的比例 (默认 0.25)", "ratio", "0.25");
+    QCommandLineOption maxSecondsOption("max-seconds", "总耗时上限 (默认 0，不检查)", "seconds", "0");
+    QCommandLineOption reportOption("report", "JSON 结果文件", "file");
+    QCommandLineOption generateOption("generate", "以高精度设置重新计算参考曲线 (耗时较长)");
+    QCommandLineOption rebaselineOption("rebaseline", "保留参考曲线，只更新各档位精度/代价基线");
+    parser.addOption(referenceOption);
+    parser.addOption(filterOption);
+    parser.addOption(slackOption);
+    parser.addOption(accuracySlackOption);
+    parser.addOption(maxSecondsOption);
+    parser.addOption(reportOption);
+    parser.addOption(generateOption);
+    parser.addOption(rebaselineOption);
+    parser.process(app);
+
+    AccuracyGate::Options options;
+    options.referencePath = parser.value(referenceOption);
+    options.filter = parser.value(filterOption);
+    options.costSlack = qMax(0.0, parser.value(slackOption).toDouble());
+    options.accuracySlack = qMax(0.0, parser.value(accuracySlackOption).toDouble());
+    options.maxSeconds = qMax(0.0, parser.value(maxSecondsOption).toDouble());
+
+    QTextStream out(stdout);
+    AccuracyGate gate(options);
+
+    if (parser.isSet(generateOption) || parser.isSet(rebaselineOption)) {
+        QString error;
+        bool ok = parser.isSet(generateOption) ? gate.generate(out, &error) : gate.rebaseline(out, &error);
+        if (!ok) {
+            out << error << "\n";
+            return 2;
+        }
+        out << "参考文件已更新: " << options.referencePath << "\n";
+        return 0;
+    }
+
+    QJsonObject report;
+    int failures = gate.run(out, &report);
+    if (parser.isSet(reportOption)) {
+        QFile f(parser.value(reportOption));
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) f.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    }
+    if (failures < 0) return 2;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,463 @@
+/*
+ * typecurveatlas.cpp
+ * 文件作用：类型曲线图版存储与批量生成实现
+ * 文件布局 (本机字节序，各段按 8 字节对齐):
+ *   [AtlasFileHeader]
+ *   [轴记录 x axisCount]   name[32] + count(int32) + logScale(int32) + values(double x count)
+ *   [固定参数 x fixedCount] name[32] + value(double)
+ *   [无因次时间 tD]         double x timeCount
+ *   [完成标记]              uint8 x curveCount
+ *   [曲线数据]              float x (2 * timeCount) x curveCount   (pD 在前, pD' 在后)
+ */
+
+#include "typecurveatlas.h"
+
+#include <QtConcurrent>
+#include <QFileInfo>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char kAtlasMagic[8] = { 'W', 'T', 'A', 'T', 'L', 'A', 'S', '\0' };
+const qint32 kAtlasVersion = 1;
+const quint32 kByteOrderMark = 0x01020304;
+const int kNameSize = 32;
+
+struct AtlasFileHeader {
+    char magic[8];
+    qint32 version;
+    quint32 byteOrderMark;
+    qint32 modelType;
+    qint32 axisCount;
+    qint32 fixedCount;
+    qint32 timeCount;
+    qint64 curveCount;
+    qint64 axesOffset;
+    qint64 fixedOffset;
+    qint64 timeOffset;
+    qint64 maskOffset;
+    qint64 dataOffset;
+    qint64 fileSize;
+};
+
+qint64 align8(qint64 v) { return (v + 7) & ~qint64(7); }
+
+void writeName(QByteArray& buf, const QString& name) {
+    QByteArray utf8 = name.toUtf8().left(kNameSize - 1);
+    utf8.append(QByteArray(kNameSize - utf8.size(), '\0'));
+    buf.append(utf8);
+}
+
+QString readName(const uchar* p) {
+    return QString::fromUtf8(reinterpret_cast<const char*>(p), int(qstrnlen(reinterpret_cast<const char*>(p), kNameSize)));
+}
+
+template<typename T> void appendPod(QByteArray& buf, const T& v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+void padTo8(QByteArray& buf) {
+    while (buf.size() % 8 != 0) buf.append('\0');
+}
+
+// [offset, offset + count * elementSize) 是否位于文件内 (以除法比较，count * elementSize 不会溢出)
+bool inFile(qint64 offset, qint64 count, qint64 elementSize, qint64 fileSize) {
+    if (offset < 0 || offset > fileSize || count < 0 || elementSize <= 0) return false;
+    return count <= (fileSize - offset) / elementSize;
+}
+
+// 文件头与各段的边界检查: 全部通过后才读取映射区，损坏的文件不会导致越界访问
+bool validateLayout(const AtlasFileHeader& h, const uchar* map, qint64 fileSize) {
+    if (h.modelType < 0 || h.modelType > qint32(ModelSolver01_06::Model_6)) return false;
+    if (h.axisCount < 1 || h.fixedCount < 0 || h.timeCount < 1 || h.curveCount < 1) return false;
+
+    // 轴记录为变长: 逐条检查记录头与取值，同时核对曲线数 = 各轴取值数之积
+    const qint64 recordHead = kNameSize + 2 * qint64(sizeof(qint32));
+    qint64 pos = h.axesOffset, product = 1;
+    for (qint32 i = 0; i < h.axisCount; ++i) {
+        if (!inFile(pos, 1, recordHead, fileSize)) return false;
+        qint32 count;
+        std::memcpy(&count, map + pos + kNameSize, sizeof(qint32));
+        pos += recordHead;
+        if (count < 1 || !inFile(pos, count, sizeof(double), fileSize)) return false;
+        pos += qint64(count) * qint64(sizeof(double));
+        if (product > h.curveCount / count) return false;
+        product *= count;
+    }
+    if (product != h.curveCount) return false;
+
+    const qint64 curveBytes = 2 * qint64(h.timeCount) * qint64(sizeof(float));
+    return inFile(h.fixedOffset, h.fixedCount, kNameSize + qint64(sizeof(double)), fileSize)
+        && inFile(h.timeOffset, h.timeCount, sizeof(double), fileSize)
+        && inFile(h.maskOffset, h.curveCount, 1, fileSize)
+        && inFile(h.dataOffset, h.curveCount, curveBytes, fileSize);
+}
+
+} // namespace
+
+// ===========================================================================
+// AtlasAxis
+// ===========================================================================
+
+AtlasAxis AtlasAxis::makeRange(const QString& name, double minVal, double maxVal, int count, bool logScale)
+{
+    AtlasAxis axis;
+    axis.name = name;
+    axis.logScale = logScale && minVal > 0 && maxVal > 0;
+    if (count < 1) count = 1;
+    if (count == 1) { axis.values.append(minVal); return axis; }
+    for (int i = 0; i < count; ++i) {
+        double f = double(i) / (count - 1);
+        if (axis.logScale) axis.values.append(std::pow(10.0, std::log10(minVal) + f * (std::log10(maxVal) - std::log10(minVal))));
+        else axis.values.append(minVal + f * (maxVal - minVal));
+    }
+    return axis;
+}
+
+// ===========================================================================
+// TypeCurveAtlas
+// ===========================================================================
+
+TypeCurveAtlas::TypeCurveAtlas()
+    : m_map(nullptr), m_writable(false), m_type(ModelSolver01_06::Model_1)
+    , m_curveCount(0), m_maskOffset(0), m_dataOffset(0)
+{
+}
+
+TypeCurveAtlas::~TypeCurveAtlas() { close(); }
+
+bool TypeCurveAtlas::create(const QString& path, ModelSolver01_06::ModelType type, const QVector<AtlasAxis>& axes,
+                            const QMap<QString, double>& fixedParams, const QVector<double>& tD, QString* error)
+{
+    close();
+    if (axes.isEmpty() || tD.isEmpty()) {
+        if (error) *error = "扫描轴或时间网格为空";
+        return false;
+    }
+
+    qint64 curveCount = 1;
+    for (const AtlasAxis& a : axes) {
+        if (a.values.isEmpty()) { if (error) *error = "扫描轴 " + a.name + " 没有取值"; return false; }
+        curveCount *= a.values.size();
+    }
+
+    // --- 组装元数据段 ---
+    QByteArray meta;
+    AtlasFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    meta.append(QByteArray(sizeof(AtlasFileHeader), '\0'));
+
+    header.axesOffset = meta.size();
+    for (const AtlasAxis& a : axes) {
+        writeName(meta, a.name);
+        appendPod(meta, qint32(a.values.size()));
+        appendPod(meta, qint32(a.logScale ? 1 : 0));
+        for (double v : a.values) appendPod(meta, v);
+    }
+    padTo8(meta);
+
+    header.fixedOffset = meta.size();
+    for (auto it = fixedParams.constBegin(); it != fixedParams.constEnd(); ++it) {
+        writeName(meta, it.key());
+        appendPod(meta, it.value());
+    }
+    padTo8(meta);
+
+    header.timeOffset = meta.size();
+    for (double v : tD) appendPod(meta, v);
+    padTo8(meta);
+
+    std::memcpy(header.magic, kAtlasMagic, sizeof(kAtlasMagic));
+    header.version = kAtlasVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.modelType = qint32(type);
+    header.axisCount = axes.size();
+    header.fixedCount = fixedParams.size();
+    header.timeCount = tD.size();
+    header.curveCount = curveCount;
+    header.maskOffset = meta.size();
+    header.dataOffset = align8(header.maskOffset + curveCount);
+    header.fileSize = header.dataOffset + curveCount * qint64(2 * tD.size()) * qint64(sizeof(float));
+    std::memcpy(meta.data(), &header, sizeof(header));
+
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = "无法创建图版文件: " + f.errorString();
+        return false;
+    }
+    if (f.write(meta) != meta.size() || !f.resize(header.fileSize)) {
+        if (error) *error = "写入图版文件失败 (磁盘空间不足?): " + f.errorString();
+        f.close();
+        return false;
+    }
+    f.close();
+
+    return open(path, true, error);
+}
+
+bool TypeCurveAtlas::open(const QString& path, bool writable, QString* error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(writable ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+        if (error) *error = "无法打开图版文件: " + m_file.errorString();
+        return false;
+    }
+    if (m_file.size() < qint64(sizeof(AtlasFileHeader))) {
+        if (error) *error = "图版文件格式错误";
+        m_file.close();
+        return false;
+    }
+
+    m_map = m_file.map(0, m_file.size());
+    if (!m_map) {
+        if (error) *error = "内存映射失败: " + m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    m_writable = writable;
+
+    AtlasFileHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+    if (std::memcmp(header.magic, kAtlasMagic, sizeof(kAtlasMagic)) != 0 || header.version != kAtlasVersion
+        || header.byteOrderMark != kByteOrderMark || header.fileSize != m_file.size()
+        || !validateLayout(header, m_map, m_file.size())) {
+        if (error) *error = "不是有效的类型曲线图版文件 (或版本不兼容)";
+        close();
+        return false;
+    }
+
+    m_type = ModelSolver01_06::ModelType(header.modelType);
+    m_curveCount = header.curveCount;
+    m_maskOffset = header.maskOffset;
+    m_dataOffset = header.dataOffset;
+
+    const uchar* p = m_map + header.axesOffset;
+    m_axes.clear();
+    for (int i = 0; i < header.axisCount; ++i) {
+        AtlasAxis a;
+        a.name = readName(p); p += kNameSize;
+        qint32 count, logScale;
+        std::memcpy(&count, p, sizeof(qint32)); p += sizeof(qint32);
+        std::memcpy(&logScale, p, sizeof(qint32)); p += sizeof(qint32);
+        a.logScale = (logScale != 0);
+        a.values.resize(count);
+        std::memcpy(a.values.data(), p, sizeof(double) * count); p += sizeof(double) * count;
+        m_axes.append(a);
+    }
+
+    p = m_map + header.fixedOffset;
+    m_fixedParams.clear();
+    for (int i = 0; i < header.fixedCount; ++i) {
+        QString name = readName(p); p += kNameSize;
+        double v; std::memcpy(&v, p, sizeof(double)); p += sizeof(double);
+        m_fixedParams.insert(name, v);
+    }
+
+    m_tD.resize(header.timeCount);
+    std::memcpy(m_tD.data(), m_map + header.timeOffset, sizeof(double) * header.timeCount);
+    return true;
+}
+
+void TypeCurveAtlas::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) m_file.close();
+    m_axes.clear();
+    m_fixedParams.clear();
+    m_tD.clear();
+    m_curveCount = 0;
+}
+
+bool TypeCurveAtlas::matches(ModelSolver01_06::ModelType type, const QVector<AtlasAxis>& axes,
+                             const QMap<QString, double>& fixedParams, const QVector<double>& tD) const
+{
+    if (!isOpen() || type != m_type || axes.size() != m_axes.size() || tD != m_tD || fixedParams != m_fixedParams) return false;
+    for (int i = 0; i < axes.size(); ++i) {
+        if (axes[i].name != m_axes[i].name || axes[i].values != m_axes[i].values) return false;
+    }
+    return true;
+}
+
+qint64 TypeCurveAtlas::completedCount() const
+{
+    if (!isOpen()) return 0;
+    const uchar* mask = m_map + m_maskOffset;
+    qint64 n = 0;
+    for (qint64 i = 0; i < m_curveCount; ++i) n += (mask[i] != 0);
+    return n;
+}
+
+QVector<int> TypeCurveAtlas::indexToCoords(qint64 index) const
+{
+    QVector<int> coords(m_axes.size(), 0);
+    for (int a = m_axes.size() - 1; a >= 0; --a) {
+        int n = m_axes[a].values.size();
+        coords[a] = int(index % n);
+        index /= n;
+    }
+    return coords;
+}
+
+qint64 TypeCurveAtlas::coordsToIndex(const QVector<int>& coords) const
+{
+    qint64 index = 0;
+    for (int a = 0; a < m_axes.size(); ++a) {
+        index = index * m_axes[a].values.size() + coords.value(a, 0);
+    }
+    return index;
+}
+
+QMap<QString, double> TypeCurveAtlas::curveParams(qint64 index) const
+{
+    QMap<QString, double> p = m_fixedParams;
+    QVector<int> coords = indexToCoords(index);
+    for (int a = 0; a < m_axes.size(); ++a) p[m_axes[a].name] = m_axes[a].values[coords[a]];
+    return p;
+}
+
+bool TypeCurveAtlas::isCompleted(qint64 index) const
+{
+    if (!isOpen() || index < 0 || index >= m_curveCount) return false;
+    return m_map[m_maskOffset + index] != 0;
+}
+
+const float* TypeCurveAtlas::curveData(qint64 index) const
+{
+    if (!isOpen() || index < 0 || index >= m_curveCount) return nullptr;
+    return reinterpret_cast<const float*>(m_map + m_dataOffset + index * qint64(2 * m_tD.size()) * qint64(sizeof(float)));
+}
+
+bool TypeCurveAtlas::readCurve(qint64 index, QVector<double>& pD, QVector<double>& dpD) const
+{
+    if (!isCompleted(index)) return false;
+    const float* data = curveData(index);
+    int n = m_tD.size();
+    pD.resize(n); dpD.resize(n);
+    for (int i = 0; i < n; ++i) { pD[i] = data[i]; dpD[i] = data[n + i]; }
+    return true;
+}
+
+bool TypeCurveAtlas::writeCurve(qint64 index, const QVector<double>& pD, const QVector<double>& dpD)
+{
+    if (!isOpen() || !m_writable || index < 0 || index >= m_curveCount) return false;
+    int n = m_tD.size();
+    if (pD.size() != n || dpD.size() != n) return false;
+
+    float* data = reinterpret_cast<float*>(m_map + m_dataOffset + index * qint64(2 * n) * qint64(sizeof(float)));
+    for (int i = 0; i < n; ++i) { data[i] = float(pD[i]); data[n + i] = float(dpD[i]); }
+    // 先写数据后置标记，中断时未置标记的曲线会在续算时重新计算
+    m_map[m_maskOffset + index] = 1;
+    return true;
+}
+
+QMap<QString, double> TypeCurveAtlas::toSolverParams(const QMap<QString, double>& dimensionless)
+{
+    QMap<QString, double> p = dimensionless;
+    // 内核中只通过 M12 = kf/km 使用渗透率
+    p["kf"] = dimensionless.value("M12", 10.0);
+    p["km"] = 1.0;
+    return p;
+}
+
+QStringList TypeCurveAtlas::dimensionlessParams(ModelSolver01_06::ModelType type)
+{
+    QStringList names;
+    names << "omega1" << "omega2" << "lambda1" << "rmD" << "M12" << "LfD" << "nf" << "gamaD";
+    if (type != ModelSolver01_06::Model_1 && type != ModelSolver01_06::Model_2) names << "reD";
+    if (type == ModelSolver01_06::Model_1 || type == ModelSolver01_06::Model_3 || type == ModelSolver01_06::Model_5) names << "cD" << "S";
+    return names;
+}
+
+QMap<QString, double> TypeCurveAtlas::fromPageParams(const QMap<QString, double>& params)
+{
+    static const char* names[] = { "omega1", "omega2", "lambda1", "rmD", "reD", "nf", "cD", "S", "gamaD" };
+    QMap<QString, double> p;
+    for (const char* name : names) {
+        if (params.contains(name)) p[name] = params.value(name);
+    }
+    double km = params.value("km", 1e-4);
+    p["M12"] = (km > 0) ? params.value("kf", 1e-3) / km : 10.0;
+    if (params.contains("LfD")) p["LfD"] = params.value("LfD");
+    else if (params.value("L", 0.0) > 1e-9) p["LfD"] = params.value("Lf", 0.0) / params.value("L");
+    return p;
+}
+
+// ===========================================================================
+// TypeCurveAtlasBuilder
+// ===========================================================================
+
+TypeCurveAtlasBuilder::TypeCurveAtlasBuilder(QObject* parent)
+    : QObject(parent), m_doneBefore(0)
+{
+    connect(&m_watcher, &QFutureWatcher<void>::progressValueChanged, this, &TypeCurveAtlasBuilder::onProgressValueChanged);
+    connect(&m_watcher, &QFutureWatcher<void>::finished, this, &TypeCurveAtlasBuilder::onWatcherFinished);
+}
+
+TypeCurveAtlasBuilder::~TypeCurveAtlasBuilder()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+bool TypeCurveAtlasBuilder::start(const QString& path, ModelSolver01_06::ModelType type, const QVector<AtlasAxis>& axes,
+                                  const QMap<QString, double>& fixedParams, const QVector<double>& tD, QString* error)
+{
+    if (isRunning()) { if (error) *error = "图版正在生成中"; return false; }
+
+    // 断点续算: 文件存在且扫描定义一致时沿用已完成的曲线
+    bool resumed = false;
+    if (QFileInfo::exists(path) && m_atlas.open(path, true)) {
+        resumed = m_atlas.matches(type, axes, fixedParams, tD);
+        if (!resumed) m_atlas.close();
+    }
+    if (!resumed && !m_atlas.create(path, type, axes, fixedParams, tD, error)) return false;
+
+    m_pending.clear();
+    for (qint64 i = 0; i < m_atlas.curveCount(); ++i) {
+        if (!m_atlas.isCompleted(i)) m_pending.append(i);
+    }
+    m_doneBefore = m_atlas.curveCount() - m_pending.size();
+
+    emit progressChanged(m_doneBefore, m_atlas.curveCount());
+    if (m_pending.isEmpty()) {
+        m_atlas.close();
+        emit finished(false);
+        return true;
+    }
+
+    // 每个工作线程独立计算并写入映射区中互不重叠的位置
+    ModelSolver01_06 solver(type);
+    TypeCurveAtlas* atlas = &m_atlas;
+    m_watcher.setFuture(QtConcurrent::map(ModelSolver01_06::enginePool(), m_pending, [solver, atlas](const qint64& index) {
+        QMap<QString, double> params = TypeCurveAtlas::toSolverParams(atlas->curveParams(index));
+        ModelCurveData res = solver.calculateDimensionlessCurve(params, atlas->timeGrid());
+        atlas->writeCurve(index, std::get<1>(res), std::get<2>(res));
+    }));
+    return true;
+}
+
+void TypeCurveAtlasBuilder::cancel()
+{
+    m_watcher.cancel();
+}
+
+void TypeCurveAtlasBuilder::onProgressValueChanged(int value)
+{
+    emit progressChanged(m_doneBefore + value, m_atlas.curveCount());
+}
+
+void TypeCurveAtlasBuilder::onWatcherFinished()
+{
+    bool canceled = m_watcher.isCanceled();
+    qint64 total = m_atlas.curveCount();
+    qint64 done = m_atlas.completedCount();
+    // 关闭映射以将数据落盘
+    m_atlas.close();
+    emit progressChanged(done, total);
+    emit finished(canceled);
+}
@@ -0,0 +1,128 @@
+/*
+ * typecurveatlas.h
+ * 文件作用：类型曲线图版 (多参数网格扫描结果) 的存储与批量生成
+ * 功能描述：
+ * 1. TypeCurveAtlas: 紧凑二进制图版文件的创建/打开/读写，文件通过内存映射访问
+ *    文件内容: 文件头 + 扫描轴 (参数名与取值) + 固定参数 + 无因次对数时间网格 + 完成标记 + 曲线数据 (pD / pD')
+ * 2. TypeCurveAtlasBuilder: 在引擎线程池中并发计算参数网格的笛卡尔积，
+ *    每条曲线完成后直接写入映射区并置完成标记，中断后可从文件断点续算
+ */
+
+#ifndef TYPECURVEATLAS_H
+#define TYPECURVEATLAS_H
+
+#include <QObject>
+#include <QFile>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include "modelsolver01-06.h"
+
+// 扫描轴定义
+struct AtlasAxis {
+    QString name;            // 无因次参数名 (omega1, lambda1, rmD, M12 ...)
+    QVector<double> values;  // 网格取值 (升序)
+    bool logScale;           // 是否按对数间隔生成 (仅用于界面显示与插值)
+
+    AtlasAxis() : logScale(false) {}
+
+    // 生成等间隔 (或对数等间隔) 的轴取值
+    static AtlasAxis makeRange(const QString& name, double minVal, double maxVal, int count, bool logScale);
+};
+
+class TypeCurveAtlas
+{
+public:
+    TypeCurveAtlas();
+    ~TypeCurveAtlas();
+
+    // 创建新图版文件: 预分配全部空间，所有曲线标记为未完成
+    bool create(const QString& path, ModelSolver01_06::ModelType type, const QVector<AtlasAxis>& axes,
+                const QMap<QString, double>& fixedParams, const QVector<double>& tD, QString* error = nullptr);
+    // 打开已有图版文件 (内存映射)
+    bool open(const QString& path, bool writable, QString* error = nullptr);
+    void close();
+
+    bool isOpen() const { return m_map != nullptr; }
+    QString filePath() const { return m_file.fileName(); }
+
+    // 判断已打开的图版与给定扫描定义是否一致 (一致时可断点续算)
+    bool matches(ModelSolver01_06::ModelType type, const QVector<AtlasAxis>& axes,
+                 const QMap<QString, double>& fixedParams, const QVector<double>& tD) const;
+
+    // --- 元数据 ---
+    ModelSolver01_06::ModelType modelType() const { return m_type; }
+    const QVector<AtlasAxis>& axes() const { return m_axes; }
+    const QMap<QString, double>& fixedParams() const { return m_fixedParams; }
+    const QVector<double>& timeGrid() const { return m_tD; }
+    qint64 curveCount() const { return m_curveCount; }
+    qint64 completedCount() const;
+
+    // --- 网格索引 (行优先，最后一个轴变化最快) ---
+    QVector<int> indexToCoords(qint64 index) const;
+    qint64 coordsToIndex(const QVector<int>& coords) const;
+    // 获取某条曲线的完整无因次参数 (固定参数 + 轴取值)
+    QMap<QString, double> curveParams(qint64 index) const;
+
+    // --- 曲线数据 ---
+    bool isCompleted(qint64 index) const;
+    // 直接访问映射区数据: 前 timeCount 个为 pD，后 timeCount 个为 pD' (无拷贝)
+    const float* curveData(qint64 index) const;
+    bool readCurve(qint64 index, QVector<double>& pD, QVector<double>& dpD) const;
+    // 写入曲线并置完成标记；不同 index 写入互不重叠的区域，可在多个工作线程中并发调用
+    bool writeCurve(qint64 index, const QVector<double>& pD, const QVector<double>& dpD);
+
+    // 将无因次参数集转换为内核输入 (M12 -> kf/km)
+    static QMap<QString, double> toSolverParams(const QMap<QString, double>& dimensionless);
+    // 对给定模型有意义的无因次参数 (reD 仅用于有界模型，cD/S 仅用于变井储模型)
+    static QStringList dimensionlessParams(ModelSolver01_06::ModelType type);
+    // 从有因次参数集 (模型页/拟合参数) 提取图版使用的无因次参数 (M12 = kf/km, LfD = Lf/L)
+    static QMap<QString, double> fromPageParams(const QMap<QString, double>& params);
+
+private:
+    QFile m_file;
+    uchar* m_map;
+    bool m_writable;
+
+    ModelSolver01_06::ModelType m_type;
+    QVector<AtlasAxis> m_axes;
+    QMap<QString, double> m_fixedParams;
+    QVector<double> m_tD;
+    qint64 m_curveCount;
+    qint64 m_maskOffset;
+    qint64 m_dataOffset;
+};
+
+class TypeCurveAtlasBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TypeCurveAtlasBuilder(QObject* parent = nullptr);
+    ~TypeCurveAtlasBuilder();
+
+    // 开始生成: 若文件已存在且扫描定义一致则只计算未完成的曲线
+    bool start(const QString& path, ModelSolver01_06::ModelType type, const QVector<AtlasAxis>& axes,
+               const QMap<QString, double>& fixedParams, const QVector<double>& tD, QString* error = nullptr);
+    // 停止生成 (已完成的曲线保留在文件中)
+    void cancel();
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+signals:
+    void progressChanged(qint64 done, qint64 total);
+    void finished(bool canceled);
+
+private slots:
+    void onProgressValueChanged(int value);
+    void onWatcherFinished();
+
+private:
+    TypeCurveAtlas m_atlas;
+    QFutureWatcher<void> m_watcher;
+    QVector<qint64> m_pending;   // 本次需要计算的曲线索引
+    qint64 m_doneBefore;         // 续算前已完成的曲线数
+};
+
+#endif // TYPECURVEATLAS_H
@@ -0,0 +1,424 @@
+/*
+ * typecurveatlasdialog.cpp
+ * 文件作用：类型曲线图版对话框实现
+ * 功能描述：
+ * 1. 生成页: 扫描轴表格 (参数/最小值/最大值/个数/对数)，无因次时间网格，后台生成与进度显示
+ * 2. 浏览页: 内存映射打开图版文件，按轴选择并叠加曲线
+ */
+
+#include "typecurveatlasdialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QTabWidget>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLineEdit>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QProgressBar>
+#include <QLabel>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <cmath>
+#include "modelparameter.h"
+
+// 单次叠加的曲线数上限 (防止整轴叠加组合过多导致图表卡顿)
+static const int kMaxOverlayCurves = 64;
+
+TypeCurveAtlasDialog::TypeCurveAtlasDialog(ModelSolver01_06::ModelType type, const QMap<QString, double>& pageParams, QWidget* parent)
+    : QDialog(parent), m_type(type), m_pageParams(pageParams)
+{
+    setWindowTitle("类型曲线图版");
+    resize(620, 520);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    QTabWidget* tabs = new QTabWidget(this);
+    tabs->addTab(createBuildPage(), "生成图版");
+    tabs->addTab(createBrowsePage(), "浏览图版");
+    mainLayout->addWidget(tabs);
+
+    m_builder = new TypeCurveAtlasBuilder(this);
+    connect(m_builder, &TypeCurveAtlasBuilder::progressChanged, this, &TypeCurveAtlasDialog::onBuildProgress);
+    connect(m_builder, &TypeCurveAtlasBuilder::finished, this, &TypeCurveAtlasDialog::onBuildFinished);
+
+    // 默认扫描 omega1 x lambda1
+    addAxisRow("omega1", 0.1, 0.9, 5, false);
+    addAxisRow("lambda1", 1e-5, 1e-1, 5, true);
+}
+
+TypeCurveAtlasDialog::~TypeCurveAtlasDialog() {}
+
+void TypeCurveAtlasDialog::setPageParams(const QMap<QString, double>& pageParams)
+{
+    m_pageParams = pageParams;
+}
+
+QStringList TypeCurveAtlasDialog::scannableParams(ModelSolver01_06::ModelType type)
+{
+    return TypeCurveAtlas::dimensionlessParams(type);
+}
+
+QMap<QString, double> TypeCurveAtlasDialog::dimensionlessPageParams() const
+{
+    QMap<QString, double> all = TypeCurveAtlas::fromPageParams(m_pageParams);
+    QMap<QString, double> p;
+    for (const QString& name : scannableParams(m_type)) p[name] = all.value(name, 0.0);
+    p["N"] = m_pageParams.value("N", 8.0);
+    return p;
+}
+
+// ===========================================================================
+// 生成页
+// ===========================================================================
+
+QWidget* TypeCurveAtlasDialog::createBuildPage()
+{
+    QWidget* page = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(page);
+
+    QGroupBox* axisGroup = new QGroupBox("扫描轴 (笛卡尔积)", page);
+    QVBoxLayout* axisLayout = new QVBoxLayout(axisGroup);
+    m_axisTable = new QTableWidget(0, 5, axisGroup);
+    m_axisTable->setHorizontalHeaderLabels(QStringList() << "参数" << "最小值" << "最大值" << "个数" << "对数");
+    m_axisTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_axisTable->verticalHeader()->setVisible(false);
+    axisLayout->addWidget(m_axisTable);
+
+    QHBoxLayout* axisBtnLayout = new QHBoxLayout();
+    QPushButton* btnAdd = new QPushButton("添加扫描轴", axisGroup);
+    QPushButton* btnRemove = new QPushButton("删除选中轴", axisGroup);
+    connect(btnAdd, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onAddAxis);
+    connect(btnRemove, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onRemoveAxis);
+    axisBtnLayout->addWidget(btnAdd);
+    axisBtnLayout->addWidget(btnRemove);
+    axisBtnLayout->addStretch();
+    axisLayout->addLayout(axisBtnLayout);
+    layout->addWidget(axisGroup);
+
+    // 默认时间范围与模型页一致 (1e-3 h ~ t)
+    double tScale = 1.0, pScale = 1.0;
+    ModelSolver01_06::dimensionalScales(m_pageParams, tScale, pScale);
+    double tMax = m_pageParams.value("t", 1000.0);
+
+    QGroupBox* timeGroup = new QGroupBox("无因次时间网格", page);
+    QFormLayout* timeLayout = new QFormLayout(timeGroup);
+    m_tDMinEdit = new QLineEdit(QString::number(tScale * 1e-3, 'g', 4), timeGroup);
+    m_tDMaxEdit = new QLineEdit(QString::number(tScale * tMax, 'g', 4), timeGroup);
+    m_pointsPerDecade = new QSpinBox(timeGroup);
+    m_pointsPerDecade->setRange(3, 100);
+    m_pointsPerDecade->setValue(15);
+    timeLayout->addRow("tD 最小值:", m_tDMinEdit);
+    timeLayout->addRow("tD 最大值:", m_tDMaxEdit);
+    timeLayout->addRow("每对数周期点数:", m_pointsPerDecade);
+    layout->addWidget(timeGroup);
+
+    QHBoxLayout* fileLayout = new QHBoxLayout();
+    QString defaultDir = ModelParameter::instance()->getProjectPath();
+    if (defaultDir.isEmpty()) defaultDir = ".";
+    m_buildPathEdit = new QLineEdit(defaultDir + "/TypeCurveAtlas.wtatlas", page);
+    QPushButton* btnBrowse = new QPushButton("浏览...", page);
+    connect(btnBrowse, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onBrowseBuildFile);
+    fileLayout->addWidget(new QLabel("图版文件:", page));
+    fileLayout->addWidget(m_buildPathEdit);
+    fileLayout->addWidget(btnBrowse);
+    layout->addLayout(fileLayout);
+
+    m_buildProgress = new QProgressBar(page);
+    m_buildProgress->setValue(0);
+    m_buildStatus = new QLabel("同名文件且扫描定义一致时自动断点续算。", page);
+    layout->addWidget(m_buildProgress);
+    layout->addWidget(m_buildStatus);
+
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    m_btnStart = new QPushButton("开始 / 续算", page);
+    m_btnStop = new QPushButton("停止", page);
+    m_btnStop->setEnabled(false);
+    connect(m_btnStart, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onStartBuild);
+    connect(m_btnStop, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onStopBuild);
+    btnLayout->addStretch();
+    btnLayout->addWidget(m_btnStart);
+    btnLayout->addWidget(m_btnStop);
+    layout->addLayout(btnLayout);
+
+    return page;
+}
+
+void TypeCurveAtlasDialog::addAxisRow(const QString& name, double minVal, double maxVal, int count, bool logScale)
+{
+    int row = m_axisTable->rowCount();
+    m_axisTable->insertRow(row);
+
+    QComboBox* combo = new QComboBox(m_axisTable);
+    combo->addItems(scannableParams(m_type));
+    int idx = combo->findText(name);
+    combo->setCurrentIndex(idx >= 0 ? idx : 0);
+    m_axisTable->setCellWidget(row, 0, combo);
+
+    m_axisTable->setItem(row, 1, new QTableWidgetItem(QString::number(minVal, 'g', 6)));
+    m_axisTable->setItem(row, 2, new QTableWidgetItem(QString::number(maxVal, 'g', 6)));
+    m_axisTable->setItem(row, 3, new QTableWidgetItem(QString::number(count)));
+
+    QCheckBox* check = new QCheckBox(m_axisTable);
+    check->setChecked(logScale);
+    m_axisTable->setCellWidget(row, 4, check);
+}
+
+void TypeCurveAtlasDialog::onAddAxis()
+{
+    if (m_axisTable->rowCount() >= 3) {
+        QMessageBox::information(this, "提示", "最多支持 3 个扫描轴。");
+        return;
+    }
+    addAxisRow("rmD", 2.0, 10.0, 5, false);
+}
+
+void TypeCurveAtlasDialog::onRemoveAxis()
+{
+    int row = m_axisTable->currentRow();
+    if (row < 0) row = m_axisTable->rowCount() - 1;
+    if (row >= 0) m_axisTable->removeRow(row);
+}
+
+void TypeCurveAtlasDialog::onBrowseBuildFile()
+{
+    QString path = QFileDialog::getSaveFileName(this, "图版文件", m_buildPathEdit->text(), "Type Curve Atlas (*.wtatlas)");
+    if (!path.isEmpty()) m_buildPathEdit->setText(path);
+}
+
+bool TypeCurveAtlasDialog::collectBuildSpec(QVector<AtlasAxis>& axes, QMap<QString, double>& fixed, QVector<double>& tD, QString* error)
+{
+    axes.clear();
+    QStringList used;
+    for (int row = 0; row < m_axisTable->rowCount(); ++row) {
+        QComboBox* combo = qobject_cast<QComboBox*>(m_axisTable->cellWidget(row, 0));
+        QCheckBox* check = qobject_cast<QCheckBox*>(m_axisTable->cellWidget(row, 4));
+        QString name = combo ? combo->currentText() : QString();
+        if (name.isEmpty() || used.contains(name)) { if (error) *error = "扫描参数为空或重复: " + name; return false; }
+        used << name;
+
+        bool ok1 = false, ok2 = false, ok3 = false;
+        double minVal = m_axisTable->item(row, 1) ? m_axisTable->item(row, 1)->text().toDouble(&ok1) : 0;
+        double maxVal = m_axisTable->item(row, 2) ? m_axisTable->item(row, 2)->text().toDouble(&ok2) : 0;
+        int count = m_axisTable->item(row, 3) ? m_axisTable->item(row, 3)->text().toInt(&ok3) : 0;
+        if (!ok1 || !ok2 || !ok3 || count < 1 || maxVal < minVal) { if (error) *error = "扫描轴 " + name + " 的范围设置无效"; return false; }
+        if (name == "nf") { minVal = std::round(minVal); maxVal = std::round(maxVal); }
+        axes.append(AtlasAxis::makeRange(name, minVal, maxVal, count, check && check->isChecked()));
+    }
+    if (axes.isEmpty()) { if (error) *error = "请至少添加一个扫描轴"; return false; }
+
+    // 固定参数: 模型页当前的无因次参数，去掉已作为扫描轴的项
+    fixed = dimensionlessPageParams();
+    for (const AtlasAxis& a : axes) fixed.remove(a.name);
+
+    double tDMin = m_tDMinEdit->text().toDouble();
+    double tDMax = m_tDMaxEdit->text().toDouble();
+    if (tDMin <= 0 || tDMax <= tDMin) { if (error) *error = "无因次时间范围无效"; return false; }
+    double decades = std::log10(tDMax) - std::log10(tDMin);
+    int nPoints = qMax(5, int(std::ceil(decades * m_pointsPerDecade->value())) + 1);
+    tD = ModelSolver01_06::generateLogTimeSteps(nPoints, std::log10(tDMin), std::log10(tDMax));
+    return true;
+}
+
+void TypeCurveAtlasDialog::onStartBuild()
+{
+    QVector<AtlasAxis> axes;
+    QMap<QString, double> fixed;
+    QVector<double> tD;
+    QString error;
+    if (!collectBuildSpec(axes, fixed, tD, &error)) {
+        QMessageBox::warning(this, "参数错误", error);
+        return;
+    }
+
+    QString path = m_buildPathEdit->text().trimmed();
+    if (path.isEmpty()) { QMessageBox::warning(this, "参数错误", "请指定图版文件路径。"); return; }
+
+    if (!m_builder->start(path, m_type, axes, fixed, tD, &error)) {
+        QMessageBox::critical(this, "错误", error);
+        return;
+    }
+    if (m_builder->isRunning()) {
+        m_btnStart->setEnabled(false);
+        m_btnStop->setEnabled(true);
+        m_buildStatus->setText("正在生成图版...");
+    }
+}
+
+void TypeCurveAtlasDialog::onStopBuild()
+{
+    m_btnStop->setEnabled(false);
+    m_buildStatus->setText("正在停止 (已完成的曲线将保留)...");
+    m_builder->cancel();
+}
+
+void TypeCurveAtlasDialog::onBuildProgress(qint64 done, qint64 total)
+{
+    m_buildProgress->setValue(total > 0 ? int(100 * done / total) : 0);
+    m_buildStatus->setText(QString("已完成 %1 / %2 条曲线").arg(done).arg(total));
+}
+
+void TypeCurveAtlasDialog::onBuildFinished(bool canceled)
+{
+    m_btnStart->setEnabled(true);
+    m_btnStop->setEnabled(false);
+    m_buildStatus->setText(m_buildStatus->text() + (canceled ? " (已停止，可续算)" : " (生成完成)"));
+    if (!canceled) {
+        m_browsePathEdit->setText(m_buildPathEdit->text().trimmed());
+        openAtlasForBrowse(m_browsePathEdit->text());
+    }
+}
+
+// ===========================================================================
+// 浏览页
+// ===========================================================================
+
+QWidget* TypeCurveAtlasDialog::createBrowsePage()
+{
+    QWidget* page = new QWidget(this);
+    QVBoxLayout* layout = new QVBoxLayout(page);
+
+    QHBoxLayout* fileLayout = new QHBoxLayout();
+    m_browsePathEdit = new QLineEdit(page);
+    m_browsePathEdit->setReadOnly(true);
+    QPushButton* btnOpen = new QPushButton("打开图版...", page);
+    connect(btnOpen, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onBrowseOpenFile);
+    fileLayout->addWidget(m_browsePathEdit);
+    fileLayout->addWidget(btnOpen);
+    layout->addLayout(fileLayout);
+
+    m_browseInfo = new QLabel("未打开图版。", page);
+    m_browseInfo->setWordWrap(true);
+    layout->addWidget(m_browseInfo);
+
+    QGroupBox* selectGroup = new QGroupBox("曲线选择", page);
+    m_axisSelectLayout = new QFormLayout(selectGroup);
+    layout->addWidget(selectGroup);
+    layout->addStretch();
+
+    QHBoxLayout* btnLayout = new QHBoxLayout();
+    QPushButton* btnOverlay = new QPushButton("叠加到图表", page);
+    QPushButton* btnClear = new QPushButton("清除叠加", page);
+    QPushButton* btnPreview = new QPushButton("用作实时预览", page);
+    QPushButton* btnPreviewOff = new QPushButton("停用实时预览", page);
+    btnPreview->setToolTip("参数落在图版范围内时，模型页修改参数后立即显示插值曲线及误差估计");
+    connect(btnOverlay, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onOverlay);
+    connect(btnClear, &QPushButton::clicked, this, &TypeCurveAtlasDialog::clearOverlayRequested);
+    connect(btnPreview, &QPushButton::clicked, this, &TypeCurveAtlasDialog::onUseAsPreview);
+    connect(btnPreviewOff, &QPushButton::clicked, this, [this]() { emit previewLibraryRequested(QString()); });
+    btnLayout->addWidget(btnPreview);
+    btnLayout->addWidget(btnPreviewOff);
+    btnLayout->addStretch();
+    btnLayout->addWidget(btnOverlay);
+    btnLayout->addWidget(btnClear);
+    layout->addLayout(btnLayout);
+
+    return page;
+}
+
+void TypeCurveAtlasDialog::onBrowseOpenFile()
+{
+    QString dir = m_browsePathEdit->text().isEmpty() ? m_buildPathEdit->text() : m_browsePathEdit->text();
+    QString path = QFileDialog::getOpenFileName(this, "打开图版文件", dir, "Type Curve Atlas (*.wtatlas)");
+    if (path.isEmpty()) return;
+    m_browsePathEdit->setText(path);
+    openAtlasForBrowse(path);
+}
+
+bool TypeCurveAtlasDialog::openAtlasForBrowse(const QString& path)
+{
+    for (QComboBox* c : m_axisCombos) {
+        m_axisSelectLayout->removeRow(c);
+    }
+    m_axisCombos.clear();
+
+    QString error;
+    if (!m_browseAtlas.open(path, false, &error)) {
+        m_browseInfo->setText("打开失败: " + error);
+        return false;
+    }
+
+    QString info = QString("模型: Model %1\n曲线: %2 条 (已完成 %3)，每条 %4 个时间点")
+                       .arg(int(m_browseAtlas.modelType()) + 1)
+                       .arg(m_browseAtlas.curveCount()).arg(m_browseAtlas.completedCount()).arg(m_browseAtlas.timeGrid().size());
+    if (m_browseAtlas.modelType() != m_type) info += "\n注意: 图版模型与当前页面模型不同。";
+    m_browseInfo->setText(info);
+
+    for (const AtlasAxis& axis : m_browseAtlas.axes()) {
+        QComboBox* combo = new QComboBox(this);
+        combo->addItem("全部 (叠加)");
+        for (double v : axis.values) combo->addItem(QString::number(v, 'g', 6));
+        m_axisSelectLayout->addRow(axis.name + ":", combo);
+        m_axisCombos.append(combo);
+    }
+    return true;
+}
+
+void TypeCurveAtlasDialog::onOverlay()
+{
+    if (!m_browseAtlas.isOpen()) { QMessageBox::information(this, "提示", "请先打开图版文件。"); return; }
+
+    const QVector<AtlasAxis>& axes = m_browseAtlas.axes();
+
+    // 每个轴的候选坐标: 选择 "全部" 时为整轴，否则为单个取值
+    QVector<QVector<int>> choices;
+    qint64 combos = 1;
+    for (int a = 0; a < axes.size(); ++a) {
+        QVector<int> c;
+        int sel = m_axisCombos.value(a) ? m_axisCombos[a]->currentIndex() : 1;
+        if (sel <= 0) { for (int i = 0; i < axes[a].values.size(); ++i) c.append(i); }
+        else c.append(sel - 1);
+        combos *= c.size();
+        choices.append(c);
+    }
+    if (combos > kMaxOverlayCurves) {
+        QMessageBox::warning(this, "提示", QString("所选组合共 %1 条曲线，超过单次叠加上限 %2 条，请固定部分轴的取值。").arg(combos).arg(kMaxOverlayCurves));
+        return;
+    }
+
+    double tScale = 1.0, pScale = 1.0;
+    ModelSolver01_06::dimensionalScales(m_pageParams, tScale, pScale);
+    const QVector<double>& tD = m_browseAtlas.timeGrid();
+
+    QVector<ModelCurveData> curves;
+    QStringList names;
+    int skipped = 0;
+    for (qint64 k = 0; k < combos; ++k) {
+        // 展开第 k 个组合
+        QVector<int> coords(axes.size());
+        qint64 rest = k;
+        for (int a = axes.size() - 1; a >= 0; --a) {
+            coords[a] = choices[a][int(rest % choices[a].size())];
+            rest /= choices[a].size();
+        }
+        qint64 index = m_browseAtlas.coordsToIndex(coords);
+
+        QVector<double> pD, dpD;
+        if (!m_browseAtlas.readCurve(index, pD, dpD)) { ++skipped; continue; }
+
+        QVector<double> t(tD.size()), p(tD.size()), d(tD.size());
+        for (int i = 0; i < tD.size(); ++i) {
+            t[i] = tD[i] / tScale;
+            p[i] = pScale * pD[i];
+            d[i] = pScale * dpD[i];
+        }
+        curves.append(std::make_tuple(t, p, d));
+
+        QStringList parts;
+        for (int a = 0; a < axes.size(); ++a) parts << QString("%1=%2").arg(axes[a].name).arg(axes[a].values[coords[a]], 0, 'g', 4);
+        names << parts.join(", ");
+    }
+
+    if (skipped > 0) QMessageBox::information(this, "提示", QString("%1 条所选曲线尚未生成，已跳过。").arg(skipped));
+    if (!curves.isEmpty()) emit overlayRequested(curves, names);
+}
+
+void TypeCurveAtlasDialog::onUseAsPreview()
+{
+    if (!m_browseAtlas.isOpen()) { QMessageBox::information(this, "提示", "请先打开图版文件。"); return; }
+    emit previewLibraryRequested(m_browseAtlas.filePath());
+}
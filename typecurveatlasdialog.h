@@ -0,0 +1,97 @@
+/*
+ * typecurveatlasdialog.h
+ * 文件作用：类型曲线图版对话框头文件
+ * 功能描述：
+ * 1. "生成图版" 页: 设置 1~3 个扫描轴与无因次时间网格，在后台批量生成图版文件，可停止与断点续算
+ * 2. "浏览图版" 页: 打开图版文件，按轴选择取值 (或整轴叠加)，直接读取文件中的曲线叠加到模型图表，无需重新计算；
+ *    也可将图版设为模型页的实时插值预览 (见 TypeCurveLibrary)
+ */
+
+#ifndef TYPECURVEATLASDIALOG_H
+#define TYPECURVEATLASDIALOG_H
+
+#include <QDialog>
+#include <QMap>
+#include <QVector>
+#include <QStringList>
+#include "typecurveatlas.h"
+
+class QTableWidget;
+class QLineEdit;
+class QSpinBox;
+class QPushButton;
+class QProgressBar;
+class QLabel;
+class QComboBox;
+class QFormLayout;
+
+class TypeCurveAtlasDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // pageParams: 模型页当前参数 (有因次)，用于确定固定参数与曲线换算
+    TypeCurveAtlasDialog(ModelSolver01_06::ModelType type, const QMap<QString, double>& pageParams, QWidget* parent = nullptr);
+    ~TypeCurveAtlasDialog();
+
+    // 模型页参数变化后更新 (影响固定参数默认值与叠加曲线的单位换算)
+    void setPageParams(const QMap<QString, double>& pageParams);
+
+    // 图版可扫描的无因次参数
+    static QStringList scannableParams(ModelSolver01_06::ModelType type);
+
+signals:
+    // 请求在模型图表上叠加曲线 (已换算为有因次时间/压力)
+    void overlayRequested(const QVector<ModelCurveData>& curves, const QStringList& names);
+    void clearOverlayRequested();
+    // 请求将图版用作模型页实时预览 (path 为空表示停用)
+    void previewLibraryRequested(const QString& path);
+
+private slots:
+    void onAddAxis();
+    void onRemoveAxis();
+    void onBrowseBuildFile();
+    void onStartBuild();
+    void onStopBuild();
+    void onBuildProgress(qint64 done, qint64 total);
+    void onBuildFinished(bool canceled);
+
+    void onBrowseOpenFile();
+    void onOverlay();
+    void onUseAsPreview();
+
+private:
+    QWidget* createBuildPage();
+    QWidget* createBrowsePage();
+    void addAxisRow(const QString& name, double minVal, double maxVal, int count, bool logScale);
+    bool collectBuildSpec(QVector<AtlasAxis>& axes, QMap<QString, double>& fixed, QVector<double>& tD, QString* error);
+    bool openAtlasForBrowse(const QString& path);
+
+    // 从有因次页面参数提取无因次参数 (M12 = kf/km)
+    QMap<QString, double> dimensionlessPageParams() const;
+
+private:
+    ModelSolver01_06::ModelType m_type;
+    QMap<QString, double> m_pageParams;
+
+    // 生成页
+    QTableWidget* m_axisTable;
+    QLineEdit* m_tDMinEdit;
+    QLineEdit* m_tDMaxEdit;
+    QSpinBox* m_pointsPerDecade;
+    QLineEdit* m_buildPathEdit;
+    QPushButton* m_btnStart;
+    QPushButton* m_btnStop;
+    QProgressBar* m_buildProgress;
+    QLabel* m_buildStatus;
+    TypeCurveAtlasBuilder* m_builder;
+
+    // 浏览页
+    QLineEdit* m_browsePathEdit;
+    QLabel* m_browseInfo;
+    QFormLayout* m_axisSelectLayout;
+    QVector<QComboBox*> m_axisCombos;
+    TypeCurveAtlas m_browseAtlas;
+};
+
+#endif // TYPECURVEATLASDIALOG_H
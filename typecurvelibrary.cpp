@@ -0,0 +1,324 @@
+/*
+ * typecurvelibrary.cpp
+ * 文件作用：类型曲线插值库实现
+ * 功能描述：
+ * 1. 参数轴: 对数轴在 log10 空间、线性轴在原空间做多线性插值 (2^d 个角点曲线)
+ * 2. 时间轴: 在 log10(tD) 上线性插值；压力与导数为正时在对数空间插值，否则退化为线性插值
+ * 3. 误差估计: 线性插值误差 ≈ s(1-s)/2 · h²|f''|，h²f'' 由相邻三条网格曲线的二阶差分给出，各轴误差累加
+ */
+
+#include "typecurvelibrary.h"
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+TypeCurveLibrary::TypeCurveLibrary()
+{
+}
+
+bool TypeCurveLibrary::load(const QString& path, QString* error)
+{
+    unload();
+    if (!m_atlas.open(path, false, error)) return false;
+    m_logTD.clear();
+    for (double t : m_atlas.timeGrid()) m_logTD.append(std::log10(t));
+    return true;
+}
+
+void TypeCurveLibrary::unload()
+{
+    m_atlas.close();
+    m_logTD.clear();
+}
+
+bool TypeCurveLibrary::fixedParamEqual(double a, double b)
+{
+    return std::abs(a - b) <= 1e-6 * qMax(std::abs(a), std::abs(b)) + 1e-12;
+}
+
+bool TypeCurveLibrary::covers(ModelSolver01_06::ModelType type, const QMap<QString, double>& dimensionless, QString* reason) const
+{
+    if (!isLoaded()) { if (reason) *reason = "未加载图版"; return false; }
+    if (type != m_atlas.modelType()) { if (reason) *reason = "图版模型与当前模型不同"; return false; }
+
+    const QVector<AtlasAxis>& axes = m_atlas.axes();
+    for (int a = 0; a < axes.size(); ++a) {
+        int lo; double s;
+        if (!dimensionless.contains(axes[a].name) || !locateAxis(a, dimensionless.value(axes[a].name), lo, s)) {
+            if (reason) *reason = QString("参数 %1 超出图版范围").arg(axes[a].name);
+            return false;
+        }
+    }
+
+    // 只比较对当前模型有意义的参数
+    QStringList relevant = TypeCurveAtlas::dimensionlessParams(type);
+    const QMap<QString, double>& fixed = m_atlas.fixedParams();
+    for (auto it = fixed.constBegin(); it != fixed.constEnd(); ++it) {
+        if (!relevant.contains(it.key()) || !dimensionless.contains(it.key())) continue;
+        if (!fixedParamEqual(dimensionless.value(it.key()), it.value())) {
+            if (reason) *reason = QString("参数 %1 与图版固定值 %2 不一致").arg(it.key()).arg(it.value(), 0, 'g', 6);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TypeCurveLibrary::locateTime(double tD, TimeBracket& b) const
+{
+    int n = m_logTD.size();
+    if (n == 0 || tD <= 0) return false;
+    double x = std::log10(tD);
+    const double tol = 1e-9;
+    if (x < m_logTD.first() - tol || x > m_logTD.last() + tol) return false;
+    if (n == 1) { b.i = 0; b.u = 0.0; return true; }
+
+    int i = int(std::upper_bound(m_logTD.constBegin(), m_logTD.constEnd(), x) - m_logTD.constBegin()) - 1;
+    b.i = qBound(0, i, n - 2);
+    b.u = qBound(0.0, (x - m_logTD[b.i]) / (m_logTD[b.i + 1] - m_logTD[b.i]), 1.0);
+    return true;
+}
+
+double TypeCurveLibrary::timeValue(const float* data, const TimeBracket& b)
+{
+    double a = data[b.i];
+    if (b.u <= 0.0) return a;
+    double c = data[b.i + 1];
+    if (a > 0 && c > 0) return std::exp((1.0 - b.u) * std::log(a) + b.u * std::log(c));
+    return (1.0 - b.u) * a + b.u * c;
+}
+
+bool TypeCurveLibrary::locateAxis(int axis, double value, int& lo, double& s) const
+{
+    const AtlasAxis& ax = m_atlas.axes()[axis];
+    const QVector<double>& v = ax.values;
+    if (v.size() == 1) {
+        lo = 0; s = 0.0;
+        return fixedParamEqual(value, v[0]);
+    }
+    if (ax.logScale && value <= 0) return false;
+
+    auto tr = [&ax](double x) { return ax.logScale ? std::log10(x) : x; };
+    double x = tr(value);
+    double first = tr(v.first()), last = tr(v.last());
+    double tol = 1e-9 * std::abs(last - first);
+    if (x < first - tol || x > last + tol) return false;
+
+    int i = int(std::upper_bound(v.constBegin(), v.constEnd(), value) - v.constBegin()) - 1;
+    lo = qBound(0, i, v.size() - 2);
+    s = qBound(0.0, (x - tr(v[lo])) / (tr(v[lo + 1]) - tr(v[lo])), 1.0);
+    return true;
+}
+
+double TypeCurveLibrary::axisErrorEstimate(int axis, const QVector<int>& coords, double s, int iBegin, int iEnd) const
+{
+    int count = m_atlas.axes()[axis].values.size();
+    if (count < 3 || s <= 0.0 || s >= 1.0) return 0.0;
+
+    QVector<int> c = coords;
+    const float* curves[3];
+    int j = qBound(1, coords[axis], count - 2);
+    for (int k = 0; k < 3; ++k) {
+        c[axis] = j - 1 + k;
+        qint64 idx = m_atlas.coordsToIndex(c);
+        if (!m_atlas.isCompleted(idx)) return 0.0; // 相邻曲线未生成时无法估计
+        curves[k] = m_atlas.curveData(idx);
+    }
+
+    int n = m_logTD.size();
+    double maxD2 = 0.0;
+    for (int i = qMax(0, iBegin); i <= qMin(n - 1, iEnd); ++i) {
+        for (int part = 0; part < 2; ++part) { // pD 与 pD'
+            double f0 = curves[0][part * n + i], f1 = curves[1][part * n + i], f2 = curves[2][part * n + i];
+            if (f0 <= 0 || f1 <= 0 || f2 <= 0) continue;
+            maxD2 = qMax(maxD2, std::abs(std::log(f0) - 2.0 * std::log(f1) + std::log(f2)));
+        }
+    }
+    return 0.5 * s * (1.0 - s) * maxD2;
+}
+
+bool TypeCurveLibrary::interpolate(const QMap<QString, double>& dimensionless, const QVector<double>& tD,
+                                   QVector<double>& outTD, QVector<double>& outPD, QVector<double>& outDPD, double* errorEstimate) const
+{
+    outTD.clear(); outPD.clear(); outDPD.clear();
+    if (!isLoaded()) return false;
+
+    const QVector<AtlasAxis>& axes = m_atlas.axes();
+    int d = axes.size();
+    QVector<int> lo(d), nearest(d);
+    QVector<double> s(d);
+    for (int a = 0; a < d; ++a) {
+        if (!dimensionless.contains(axes[a].name) || !locateAxis(a, dimensionless.value(axes[a].name), lo[a], s[a])) return false;
+        nearest[a] = lo[a] + (s[a] >= 0.5 ? 1 : 0);
+    }
+
+    // 角点曲线与权重 (权重为 0 的角点不要求已生成)
+    int nCorner = 1 << d;
+    QVector<const float*> cornerData;
+    QVector<double> cornerWeight;
+    for (int c = 0; c < nCorner; ++c) {
+        QVector<int> coords = lo;
+        double w = 1.0;
+        for (int a = 0; a < d; ++a) {
+            if ((c >> a) & 1) { w *= s[a]; coords[a] += 1; }
+            else w *= (1.0 - s[a]);
+        }
+        if (w <= 0.0) continue;
+        qint64 idx = m_atlas.coordsToIndex(coords);
+        if (!m_atlas.isCompleted(idx)) return false;
+        cornerData.append(m_atlas.curveData(idx));
+        cornerWeight.append(w);
+    }
+
+    int n = m_logTD.size();
+    int iMin = n, iMax = -1;
+    outTD.reserve(tD.size()); outPD.reserve(tD.size()); outDPD.reserve(tD.size());
+    for (double t : tD) {
+        TimeBracket b;
+        if (!locateTime(t, b)) continue;
+        iMin = qMin(iMin, b.i);
+        iMax = qMax(iMax, qMin(b.i + 1, n - 1));
+
+        double logP = 0, linP = 0, logD = 0, linD = 0;
+        bool posP = true, posD = true;
+        for (int c = 0; c < cornerData.size(); ++c) {
+            double w = cornerWeight[c];
+            double vp = timeValue(cornerData[c], b);
+            double vd = timeValue(cornerData[c] + n, b);
+            if (vp > 0) logP += w * std::log(vp); else posP = false;
+            if (vd > 0) logD += w * std::log(vd); else posD = false;
+            linP += w * vp;
+            linD += w * vd;
+        }
+        outTD.append(t);
+        outPD.append(posP ? std::exp(logP) : linP);
+        outDPD.append(posD ? std::exp(logD) : linD);
+    }
+    if (outTD.isEmpty()) return false;
+
+    if (errorEstimate) {
+        double err = 0.0;
+        for (int a = 0; a < d; ++a) err += axisErrorEstimate(a, nearest, s[a], iMin, iMax);
+
+        // 时间轴插值误差 (区间中点 s(1-s)/2 取最大值 1/8)
+        const float* data = m_atlas.curveData(m_atlas.coordsToIndex(nearest));
+        double maxD2 = 0.0;
+        for (int i = qMax(1, iMin); i <= qMin(n - 2, iMax); ++i) {
+            for (int part = 0; part < 2; ++part) {
+                double f0 = data[part * n + i - 1], f1 = data[part * n + i], f2 = data[part * n + i + 1];
+                if (f0 <= 0 || f1 <= 0 || f2 <= 0) continue;
+                maxD2 = qMax(maxD2, std::abs(std::log(f0) - 2.0 * std::log(f1) + std::log(f2)));
+            }
+        }
+        err += maxD2 / 8.0;
+        *errorEstimate = err;
+    }
+    return true;
+}
+
+bool TypeCurveLibrary::preview(ModelSolver01_06::ModelType type, const QMap<QString, double>& params, const QVector<double>& t,
+                               ModelCurveData& out, double* errorEstimate, QString* reason) const
+{
+    QMap<QString, double> dimensionless = TypeCurveAtlas::fromPageParams(params);
+    if (!covers(type, dimensionless, reason)) return false;
+
+    double tScale, pScale;
+    ModelSolver01_06::dimensionalScales(params, tScale, pScale);
+    QVector<double> tD;
+    tD.reserve(t.size());
+    for (double v : t) tD.append(tScale * v);
+
+    QVector<double> outTD, pD, dpD;
+    if (!interpolate(dimensionless, tD, outTD, pD, dpD, errorEstimate)) {
+        if (reason) *reason = "时间范围超出图版或所需网格曲线尚未生成";
+        return false;
+    }
+
+    QVector<double> tOut(outTD.size()), pOut(outTD.size()), dOut(outTD.size());
+    for (int i = 0; i < outTD.size(); ++i) {
+        tOut[i] = outTD[i] / tScale;
+        pOut[i] = pScale * pD[i];
+        dOut[i] = pScale * dpD[i];
+    }
+    out = std::make_tuple(tOut, pOut, dOut);
+    return true;
+}
+
+bool TypeCurveLibrary::bestGridMatch(ModelSolver01_06::ModelType type, const QMap<QString, double>& params,
+                                     const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, double weight,
+                                     QMap<QString, double>& bestAxisValues, double* bestMse, QStringList* mismatch,
+                                     QString* reason) const
+{
+    if (!isLoaded()) { if (reason) *reason = "未加载图版"; return false; }
+    if (type != m_atlas.modelType()) { if (reason) *reason = "图版模型与当前模型不同"; return false; }
+
+    // 记录与图版固定参数不一致的参数 (不影响搜索，只提示初值为近似值)
+    QMap<QString, double> dimensionless = TypeCurveAtlas::fromPageParams(params);
+    QStringList relevant = TypeCurveAtlas::dimensionlessParams(type);
+    const QMap<QString, double>& fixed = m_atlas.fixedParams();
+    if (mismatch) {
+        mismatch->clear();
+        for (auto it = fixed.constBegin(); it != fixed.constEnd(); ++it) {
+            if (relevant.contains(it.key()) && dimensionless.contains(it.key()) && !fixedParamEqual(dimensionless.value(it.key()), it.value()))
+                mismatch->append(it.key());
+        }
+    }
+
+    const QVector<AtlasAxis>& axes = m_atlas.axes();
+    int axisM12 = -1;
+    for (int a = 0; a < axes.size(); ++a) if (axes[a].name == "M12") axisM12 = a;
+    double km = params.value("km", 1e-4);
+
+    double wp = weight, wd = 1.0 - weight;
+    int n = m_logTD.size();
+    double best = std::numeric_limits<double>::max();
+    qint64 bestIndex = -1;
+
+    double tScale, pScale;
+    ModelSolver01_06::dimensionalScales(params, tScale, pScale);
+
+    for (qint64 idx = 0; idx < m_atlas.curveCount(); ++idx) {
+        if (!m_atlas.isCompleted(idx)) continue;
+
+        // M12 为扫描轴时 kf = M12 * km，时间与压力换算系数随之变化
+        if (axisM12 >= 0) {
+            QMap<QString, double> scaled = params;
+            scaled["kf"] = axes[axisM12].values[m_atlas.indexToCoords(idx)[axisM12]] * km;
+            ModelSolver01_06::dimensionalScales(scaled, tScale, pScale);
+        }
+
+        const float* data = m_atlas.curveData(idx);
+        double sse = 0.0;
+        int count = 0;
+        for (int i = 0; i < t.size() && i < p.size(); ++i) {
+            TimeBracket b;
+            if (!locateTime(tScale * t[i], b)) continue;
+            double vp = pScale * timeValue(data, b);
+            if (p[i] > 1e-10 && vp > 1e-10) {
+                double r = (std::log(p[i]) - std::log(vp)) * wp;
+                sse += r * r; ++count;
+            }
+            if (i < d.size()) {
+                double vd = pScale * timeValue(data + n, b);
+                if (d[i] > 1e-10 && vd > 1e-10) {
+                    double r = (std::log(d[i]) - std::log(vd)) * wd;
+                    sse += r * r; ++count;
+                }
+            }
+        }
+        if (count < 5) continue;
+        double mse = sse / count;
+        if (mse < best) { best = mse; bestIndex = idx; }
+    }
+
+    if (bestIndex < 0) {
+        if (reason) *reason = "观测数据与图版时间范围重叠不足 (或图版尚未生成)";
+        return false;
+    }
+
+    bestAxisValues.clear();
+    QVector<int> coords = m_atlas.indexToCoords(bestIndex);
+    for (int a = 0; a < axes.size(); ++a) bestAxisValues[axes[a].name] = axes[a].values[coords[a]];
+    if (bestMse) *bestMse = best;
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+ * typecurvelibrary.h
+ * 文件作用：基于类型曲线图版的快速插值曲线库
+ * 功能描述：
+ * 1. 以只读内存映射方式加载图版文件 (TypeCurveAtlas)，不做任何整体拷贝
+ * 2. 在 (对数) 参数空间内做多线性插值、在对数时间轴上做线性插值，微秒级给出无因次/有因次曲线
+ * 3. 由相邻网格曲线的二阶差分估计插值误差 (h^2/8 |f''|)，供界面提示是否超出容差
+ * 4. 在全部网格曲线中搜索与观测数据最吻合的一条，作为拟合初值
+ * 精确计算仍由 ModelSolver01_06 完成，本库只用于预览与初值。
+ */
+
+#ifndef TYPECURVELIBRARY_H
+#define TYPECURVELIBRARY_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include "typecurveatlas.h"
+
+class TypeCurveLibrary
+{
+public:
+    TypeCurveLibrary();
+
+    bool load(const QString& path, QString* error = nullptr);
+    void unload();
+    bool isLoaded() const { return m_atlas.isOpen(); }
+    QString filePath() const { return m_atlas.filePath(); }
+    const TypeCurveAtlas& atlas() const { return m_atlas; }
+
+    // 判断无因次参数是否在图版覆盖范围内:
+    // 模型一致、扫描轴参数在网格范围内、其余参数与图版固定参数一致
+    bool covers(ModelSolver01_06::ModelType type, const QMap<QString, double>& dimensionless, QString* reason = nullptr) const;
+
+    // 插值无因次曲线；超出图版时间范围的点不输出 (outTD 为实际输出的时间点)
+    // errorEstimate: 对数压力的插值误差估计 (约等于相对误差)
+    bool interpolate(const QMap<QString, double>& dimensionless, const QVector<double>& tD,
+                     QVector<double>& outTD, QVector<double>& outPD, QVector<double>& outDPD, double* errorEstimate = nullptr) const;
+
+    // 有因次预览: params 为模型页/拟合参数 (kf, km, L, Lf ...)，t 为有因次时间
+    bool preview(ModelSolver01_06::ModelType type, const QMap<QString, double>& params, const QVector<double>& t,
+                 ModelCurveData& out, double* errorEstimate = nullptr, QString* reason = nullptr) const;
+
+    // 在已完成的网格曲线中搜索与观测数据最吻合的一条 (残差定义与拟合一致: 对数压力/导数，按 weight 加权)
+    // 返回该曲线的扫描轴取值；mismatch 列出与图版固定参数不一致的参数名 (此时结果仅为近似初值)
+    bool bestGridMatch(ModelSolver01_06::ModelType type, const QMap<QString, double>& params,
+                       const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, double weight,
+                       QMap<QString, double>& bestAxisValues, double* bestMse = nullptr, QStringList* mismatch = nullptr,
+                       QString* reason = nullptr) const;
+
+private:
+    // 时间网格上的插值位置
+    struct TimeBracket {
+        int i;      // 左端点
+        double u;   // 区间内比例 [0,1]
+    };
+    bool locateTime(double tD, TimeBracket& b) const;
+    // 单条网格曲线在某时间位置的取值 (正值按对数插值)
+    static double timeValue(const float* data, const TimeBracket& b);
+    // 参数轴上的插值位置 (lo, s)；单点轴 s = 0
+    bool locateAxis(int axis, double value, int& lo, double& s) const;
+    // 沿某轴的二阶差分误差估计 (在 coords 所在网格点附近)
+    double axisErrorEstimate(int axis, const QVector<int>& coords, double s, int iBegin, int iEnd) const;
+
+    static bool fixedParamEqual(double a, double b);
+
+private:
+    TypeCurveAtlas m_atlas;
+    QVector<double> m_logTD;   // 图版时间网格的 log10
+};
+
+#endif // TYPECURVELIBRARY_H
@@ -7,6 +7,8 @@
  * 3. 实现 LM 非线性回归算法进行自动拟合
  * 4. 处理 JSON 数据的保存与加载
  * 5. 响应各类按钮点击事件（加载数据、导出报告、参数配置等）
+ * 6. 拟合前可对观测数据做对数分箱抽稀，图中原始数据以浅色显示在拟合数据之下
+ * 7. 模型判别: 以当前参数为初值并发拟合全部候选模型，按 SSE / AIC / BIC 列表并叠加排名靠前的模型曲线
  */
 
 #include "wt_fittingwidget.h"
@@ -18,6 +20,7 @@
 #include <QMessageBox>
 #include <QDebug>
 #include <cmath>
+#include <limits>
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
@@ -31,8 +34,9 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
 #include <QBuffer>
-#include <Eigen/Dense>
 
 // ===========================================================================
 // FittingWidget 实现
@@ -44,7 +48,9 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_modelManager(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
-    m_isFitting(false)
+    m_dataDeconvolved(false),
+    m_isFitting(false),
+    m_stopRequested(false)
 {
     ui->setupUi(this);
 
@@ -72,6 +78,18 @@ FittingWidget::FittingWidget(QWidget *parent) :
     connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_curveRunner, &ProgressiveCurveRunner::stageReady, this, &FittingWidget::onCurveStageReady);
+    connect(ui->tableStarts, &QTableWidget::cellDoubleClicked, this, &FittingWidget::onStartResultActivated);
+    ui->tableStarts->setVisible(false);
+    connect(ui->tableModels, &QTableWidget::cellDoubleClicked, this, &FittingWidget::onModelResultActivated);
+    ui->tableModels->setVisible(false);
+    connect(ui->comboOptimizer, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FittingWidget::onOptimizerChanged);
+    onOptimizerChanged(ui->comboOptimizer->currentIndex());
+    connect(ui->checkReduce, &QCheckBox::toggled, this, &FittingWidget::onReductionChanged);
+    connect(ui->spinPointsPerCycle, QOverload<int>::of(&QSpinBox::valueChanged), this, &FittingWidget::onReductionChanged);
+    connect(ui->comboAggregation, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FittingWidget::onReductionChanged);
+    ui->spinPointsPerCycle->setEnabled(false);
+    ui->comboAggregation->setEnabled(false);
 
     // [注意] 此处删除了 btnSelectParams 的手动 connect，避免弹窗出现两次
 
@@ -83,7 +101,14 @@ FittingWidget::FittingWidget(QWidget *parent) :
     onSliderWeightChanged(50);
 }
 
-FittingWidget::~FittingWidget() { delete ui; }
+FittingWidget::~FittingWidget() {
+    // 页签被关闭时拟合可能仍在进行: 取消并等待拟合线程退出 (取消后引擎立即返回)
+    m_stopRequested = true;
+    m_fitFuture.waitForFinished();
+    delete ui;
+}
+
+bool FittingWidget::isFitting() const { return m_isFitting; }
 
 void FittingWidget::setModelManager(ModelManager *m) {
     m_modelManager = m;
@@ -155,15 +180,32 @@ QJsonObject FittingWidget::getJsonState() const
     root["parameters"] = paramsArray;
 
     QJsonArray timeArr, pressArr, derivArr;
-    for(double v : m_obsTime) timeArr.append(v);
-    for(double v : m_obsPressure) pressArr.append(v);
-    for(double v : m_obsDerivative) derivArr.append(v);
+    for(double v : m_rawTime) timeArr.append(v);
+    for(double v : m_rawPressure) pressArr.append(v);
+    for(double v : m_rawDerivative) derivArr.append(v);
     QJsonObject obsData;
     obsData["time"] = timeArr;
     obsData["pressure"] = pressArr;
     obsData["derivative"] = derivArr;
+    obsData["deconvolved"] = m_dataDeconvolved;
     root["observedData"] = obsData;
 
+    QJsonObject reduction;
+    reduction["enabled"] = ui->checkReduce->isChecked();
+    reduction["pointsPerCycle"] = ui->spinPointsPerCycle->value();
+    reduction["aggregation"] = ui->comboAggregation->currentIndex();
+    root["dataReduction"] = reduction;
+
+    if(!m_rateSchedule.isEmpty()) {
+        QJsonArray startArr, rateArr;
+        for(double v : m_rateSchedule.startTimes) startArr.append(v);
+        for(double v : m_rateSchedule.rates) rateArr.append(v);
+        QJsonObject rateData;
+        rateData["startTime"] = startArr;
+        rateData["rate"] = rateArr;
+        root["rateHistory"] = rateData;
+    }
+
     return root;
 }
 
@@ -218,6 +260,16 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         ui->sliderWeight->setValue((int)(w * 100));
     }
 
+    if (root.contains("dataReduction")) {
+        // 先恢复抽稀设置 (不触发重算)，随后的 setObservedData 按此生成拟合数据
+        QJsonObject reduction = root["dataReduction"].toObject();
+        QSignalBlocker b1(ui->checkReduce), b2(ui->spinPointsPerCycle), b3(ui->comboAggregation);
+        ui->checkReduce->setChecked(reduction["enabled"].toBool());
+        ui->spinPointsPerCycle->setValue(reduction["pointsPerCycle"].toInt(20));
+        ui->comboAggregation->setCurrentIndex(reduction["aggregation"].toInt());
+        onReductionChanged();
+    }
+
     if (root.contains("observedData")) {
         QJsonObject obs = root["observedData"].toObject();
         QJsonArray tArr = obs["time"].toArray();
@@ -230,6 +282,15 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         for(auto v : dArr) d.append(v.toDouble());
 
         setObservedData(t, p, d);
+        m_dataDeconvolved = obs["deconvolved"].toBool();
+    }
+
+    m_rateSchedule = RateSchedule();
+    if (root.contains("rateHistory")) {
+        QJsonObject rateData = root["rateHistory"].toObject();
+        for(auto v : rateData["startTime"].toArray()) m_rateSchedule.startTimes.append(v.toDouble());
+        for(auto v : rateData["rate"].toArray()) m_rateSchedule.rates.append(v.toDouble());
+        if(!m_rateSchedule.isValid()) m_rateSchedule = RateSchedule();
     }
 
     updateModelCurve();
@@ -369,6 +430,7 @@ void FittingWidget::on_btn_modelSelect_clicked() {
         if (code.startsWith("modelwidget")) found = true;
 
         if (found) {
+            clearModelOverlays();
             m_paramChart->switchModel(newType);
             m_currentModelType = newType;
             ui->btn_modelSelect->setText("当前: " + name);
@@ -426,27 +488,93 @@ void FittingWidget::setupPlot() {
     m_plot->addGraph(); m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
     m_plot->graph(3)->setName("理论导数");
 
+    // 原始数据 (启用抽稀时显示)，放在主图层之下，不遮挡拟合数据与理论曲线
+    m_plot->addLayer("raw", m_plot->layer("main"), QCustomPlot::limBelow);
+    m_plot->addGraph(); m_plot->graph(4)->setPen(Qt::NoPen);
+    m_plot->graph(4)->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, QColor(150, 200, 150), 2));
+    m_plot->graph(4)->setName("原始压力");
+    m_plot->graph(4)->setLayer("raw");
+
+    m_plot->addGraph(); m_plot->graph(5)->setPen(Qt::NoPen);
+    m_plot->graph(5)->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, QColor(230, 170, 230), 2));
+    m_plot->graph(5)->setName("原始导数");
+    m_plot->graph(5)->setLayer("raw");
+    m_plot->graph(4)->removeFromLegend(); m_plot->graph(5)->removeFromLegend();
+
     m_plot->legend->setVisible(true); m_plot->legend->setFont(QFont("Arial", 9)); m_plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
 }
 
 void FittingWidget::setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d) {
-    m_obsTime = t; m_obsPressure = p; m_obsDerivative = d;
+    m_rawTime = t; m_rawPressure = p; m_rawDerivative = d;
+    m_dataDeconvolved = false;
+    clearModelOverlays();
+    applyDataReduction();
+}
 
-    QVector<double> vt, vp, vd;
-    for(int i=0; i<t.size(); ++i) {
-        if(t[i]>1e-6 && p[i]>1e-6) {
-            vt<<t[i]; vp<<p[i];
-            if(i<d.size() && d[i]>1e-6) vd<<d[i]; else vd<<1e-10;
+void FittingWidget::applyDataReduction() {
+    DataReduction::logBinned(m_rawTime, m_rawPressure, m_rawDerivative, m_reduction, m_obsTime, m_obsPressure, m_obsDerivative);
+    m_fitObservations = FittingCore::Observations::prepare(m_obsTime, m_obsPressure, m_obsDerivative);
+
+    auto validPoints = [](const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, QVector<double>& vt, QVector<double>& vp, QVector<double>& vd) {
+        for(int i=0; i<t.size(); ++i) {
+            if(t[i]>1e-6 && p[i]>1e-6) {
+                vt<<t[i]; vp<<p[i];
+                if(i<d.size() && d[i]>1e-6) vd<<d[i]; else vd<<1e-10;
+            }
         }
-    }
+    };
+    QVector<double> vt, vp, vd, rt, rp, rd;
+    validPoints(m_obsTime, m_obsPressure, m_obsDerivative, vt, vp, vd);
+    bool reduced = m_reduction.isEnabled();
+    if(reduced) validPoints(m_rawTime, m_rawPressure, m_rawDerivative, rt, rp, rd);
     m_plot->graph(0)->setData(vt, vp);
     m_plot->graph(1)->setData(vt, vd);
+    m_plot->graph(4)->setData(rt, rp);
+    m_plot->graph(5)->setData(rt, rd);
+    if(reduced) { m_plot->graph(4)->addToLegend(); m_plot->graph(5)->addToLegend(); }
+    else { m_plot->graph(4)->removeFromLegend(); m_plot->graph(5)->removeFromLegend(); }
+    ui->label_ReductionInfo->setText(reduced ? QString("拟合点数 %1 / %2").arg(m_obsTime.size()).arg(m_rawTime.size()) : QString());
+
     m_plot->rescaleAxes();
     if(m_plot->xAxis->range().lower<=0) m_plot->xAxis->setRangeLower(1e-3);
     if(m_plot->yAxis->range().lower<=0) m_plot->yAxis->setRangeLower(1e-3);
     m_plot->replot();
 }
 
+bool FittingWidget::setRateHistory(const RateSchedule& schedule) {
+    if(m_isFitting) { QMessageBox::warning(this, "产量历史", "当前分析正在拟合，请停止拟合后再更改产量历史。"); return false; }
+    QString error;
+    if(!schedule.isEmpty() && !schedule.isValid(&error)) { QMessageBox::warning(this, "产量历史", "产量历史无效: " + error); return false; }
+    m_rateSchedule = schedule;
+    if(m_modelManager) updateModelCurve();
+    return true;
+}
+
+void FittingWidget::setReferenceRate(double q) {
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+    for(auto& p : params) {
+        if(p.name != "q") continue;
+        p.value = q;
+        if(q > 0) { p.min = qMin(p.min, q); p.max = qMax(p.max, q); }
+    }
+    m_paramChart->setParameters(params);
+    if(m_modelManager) updateModelCurve();
+}
+
+bool FittingWidget::setDeconvolvedData(const QVector<double>& t, const QVector<double>& dp, const QVector<double>& d, double referenceRate) {
+    if(m_isFitting) { QMessageBox::warning(this, "反褶积", "当前分析正在拟合，反褶积结果未应用。请停止拟合后重新反褶积。"); return false; }
+    setObservedData(t, dp, d);
+    m_rateSchedule = RateSchedule();
+    setReferenceRate(referenceRate);
+    m_dataDeconvolved = true;
+    return true;
+}
+
+bool FittingWidget::hasDeconvolvedData() const { return m_dataDeconvolved; }
+
+void FittingWidget::clearDeconvolvedMark() { m_dataDeconvolved = false; }
+
 void FittingWidget::on_btnResetView_clicked() {
     if(m_plot->graph(0)->dataCount() > 0) {
         m_plot->rescaleAxes();
@@ -477,20 +605,163 @@ void FittingWidget::on_btnRunFit_clicked() {
     if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
 
     m_paramChart->updateParamsFromTable();
-    m_isFitting = true; m_stopRequested = false; ui->btnRunFit->setEnabled(false);
+    m_curveRunner.cancel();
+    clearModelOverlays();
+    m_stopRequested = false;
+
+    FitSettings settings;
+    settings.weight = ui->sliderWeight->value() / 100.0;
+    settings.startCount = ui->spinStartCount->value();
+    settings.globalSearch = ui->comboOptimizer->currentIndex() == 1;
+    settings.evaluationBudget = ui->spinEvalBudget->value();
+    settings.polish = ui->checkPolish->isChecked();
+
+    // 会话快照在界面线程中生成: 拟合线程不再读取模型管理器与本页的可变状态，其他页签可同时拟合
+    FitSession session = { m_paramChart->getParameters(), settings, m_modelManager->getSolver(m_currentModelType),
+                           m_rateSchedule, m_obsTime, m_obsPressure, m_obsDerivative, m_fitObservations };
+    setFittingState(true);
+    m_fitFuture = QtConcurrent::run([this, session](){ runOptimizationTask(session); });
+}
 
-    ModelManager::ModelType modelType = m_currentModelType;
-    QList<FitParameter> paramsCopy = m_paramChart->getParameters();
+void FittingWidget::on_btnFitAllModels_clicked() {
+    if(m_isFitting || !m_modelManager) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
 
-    double w = ui->sliderWeight->value() / 100.0;
-    (void)QtConcurrent::run([this, modelType, paramsCopy, w](){ runOptimizationTask(modelType, paramsCopy, w); });
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> current = m_paramChart->getParameters();
+    QStringList currentNames;
+    bool anyFit = false;
+    for(const FitParameter& p : current) { currentNames << p.name; anyFit = anyFit || p.isFit; }
+    if(!anyFit) { QMessageBox::warning(this,"错误","请先选择参与拟合的参数。"); return; }
+
+    // 候选模型的参数表经 switchModel 同样的规则由当前参数生成 (同时沿用拟合标记与范围)；
+    // 当前模型没有的参数 (如边界模型的 reD) 参与拟合，否则边界模型与无限大模型无从区分
+    const ModelManager::ModelType types[] = { ModelManager::Model_1, ModelManager::Model_2, ModelManager::Model_3,
+                                              ModelManager::Model_4, ModelManager::Model_5, ModelManager::Model_6 };
+    m_modelCandidates.clear();
+    m_modelRanking.clear();
+    QVector<FittingModelComparison::Candidate> candidates;
+    for(ModelManager::ModelType type : types) {
+        ModelCandidate mc = { type, m_paramChart->parametersForModel(type, current, true) };
+        FittingModelComparison::Candidate c = { m_modelManager->getSolver(type), QMap<QString, double>(), QVector<FittingCore::Bound>() };
+        for(FitParameter& p : mc.params) {
+            if(!currentNames.contains(p.name)) p.isFit = true;
+            c.start.insert(p.name, p.value);
+            if(p.isFit) c.bounds.append({ p.name, p.min, p.max });
+        }
+        c.solver.setCancelFlag(&m_stopRequested);
+        m_modelCandidates << mc;
+        candidates << c;
+    }
+
+    m_curveRunner.cancel();
+    clearModelOverlays();
+    m_stopRequested = false;
+    FitSettings settings = { ui->sliderWeight->value() / 100.0, 1, false, 0, false };
+    FitSession session = { current, settings, m_modelManager->getSolver(m_currentModelType),
+                           m_rateSchedule, m_obsTime, m_obsPressure, m_obsDerivative, m_fitObservations };
+    setFittingState(true);
+    m_fitFuture = QtConcurrent::run([this, session, candidates](){ runModelComparisonTask(session, candidates); });
+}
+
+void FittingWidget::setFittingState(bool running) {
+    m_isFitting = running;
+    ui->btnRunFit->setEnabled(!running);
+    ui->btnFitAllModels->setEnabled(!running);
+    // 拟合期间图中的拟合数据须与拟合所用数据一致，不允许重新抽稀
+    ui->checkReduce->setEnabled(!running);
+    ui->spinPointsPerCycle->setEnabled(!running && ui->checkReduce->isChecked());
+    ui->comboAggregation->setEnabled(!running && ui->checkReduce->isChecked());
+    emit sigFittingStateChanged(running);
+}
+
+FittingSchedule::ModelFactory FittingWidget::scheduleModelFactory(const RateSchedule& schedule) {
+    return [schedule](const ModelSolver01_06& s, const QVector<double>& t) -> FittingCore::ModelFunction {
+        return [s, schedule, t](const QMap<QString, double>& p) {
+            if(schedule.isEmpty()) return s.calculateTheoreticalCurve(p, t);
+            return RateSuperposition(schedule).calculate(s, p, t);
+        };
+    };
+}
+
+FittingSchedule::SensitivityFactory FittingWidget::scheduleSensitivityFactory(const RateSchedule& schedule) {
+    if(!schedule.isEmpty()) return FittingSchedule::SensitivityFactory();
+    return [](const ModelSolver01_06& s) -> FittingCore::SensitivityFunction {
+        return [s](const QMap<QString, double>& p, const QStringList& names, const QVector<double>& t,
+                   QVector<double>& pressure, QVector<QVector<double>>& dp) {
+            return s.calculatePressureSensitivities(p, names, t, pressure, dp);
+        };
+    };
+}
+
+void FittingWidget::onReductionChanged() {
+    bool enabled = ui->checkReduce->isChecked();
+    ui->spinPointsPerCycle->setEnabled(enabled);
+    ui->comboAggregation->setEnabled(enabled);
+    m_reduction.pointsPerCycle = enabled ? ui->spinPointsPerCycle->value() : 0;
+    m_reduction.aggregation = ui->comboAggregation->currentIndex() == 1 ? DataReduction::Mean : DataReduction::Median;
+    // 载入状态时 (信号被屏蔽) 只更新设置，数据由随后的 setObservedData 生成
+    if(ui->checkReduce->signalsBlocked()) return;
+    applyDataReduction();
+    if(m_modelManager) updateModelCurve();
 }
 
-void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+void FittingWidget::onOptimizerChanged(int index) {
+    bool global = index == 1;
+    ui->spinStartCount->setEnabled(!global);
+    ui->spinEvalBudget->setEnabled(global);
+    ui->checkPolish->setEnabled(global);
 }
 
 void FittingWidget::on_btnStop_clicked() { m_stopRequested=true; }
+
+void FittingWidget::on_btnAtlasGuess_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) { QMessageBox::warning(this,"错误","请先加载观测数据。"); return; }
+
+    QString defaultPath = m_typeCurveLibrary.isLoaded() ? m_typeCurveLibrary.filePath() : ModelParameter::instance()->getProjectPath();
+    QString path = QFileDialog::getOpenFileName(this, "选择类型曲线图版", defaultPath, "Type Curve Atlas (*.wtatlas)");
+    if(path.isEmpty()) return;
+
+    QString error;
+    if(!m_typeCurveLibrary.isLoaded() || m_typeCurveLibrary.filePath() != path) {
+        if(!m_typeCurveLibrary.load(path, &error)) { QMessageBox::critical(this, "错误", "加载图版失败: " + error); return; }
+    }
+
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+    QMap<QString,double> currentParams;
+    for(const auto& p : params) currentParams.insert(p.name, p.value);
+    if(currentParams.contains("L") && currentParams.contains("Lf") && currentParams["L"] > 1e-9)
+        currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
+
+    QMap<QString,double> best; double mse = 0; QStringList mismatch;
+    double w = ui->sliderWeight->value() / 100.0;
+    if(!m_typeCurveLibrary.bestGridMatch(m_currentModelType, currentParams, m_obsTime, m_obsPressure, m_obsDerivative, w, best, &mse, &mismatch, &error)) {
+        QMessageBox::warning(this, "图版初值", error);
+        return;
+    }
+
+    // 无因次轴取值写回拟合参数: M12 -> kf (保持 km)，LfD -> Lf (保持 L)
+    QStringList applied;
+    for(auto it = best.begin(); it != best.end(); ++it) {
+        QMap<QString,double> values;
+        if(it.key() == "M12") values["kf"] = it.value() * currentParams.value("km", 1e-4);
+        else if(it.key() == "LfD") { values["Lf"] = it.value() * currentParams.value("L", 1000.0); values["LfD"] = it.value(); }
+        else values[it.key()] = it.value();
+        for(auto& p : params) {
+            if(!values.contains(p.name)) continue;
+            p.value = qBound(p.min, values.value(p.name), p.max);
+            applied << QString("%1 = %2").arg(p.displayName).arg(p.value, 0, 'g', 4);
+        }
+    }
+    m_paramChart->setParameters(params);
+    updateModelCurve();
+
+    QString msg = QString("已采用图版中最吻合的网格曲线 (均方误差 %1):\n%2").arg(mse, 0, 'g', 4).arg(applied.join("\n"));
+    if(!mismatch.isEmpty()) msg += QString("\n\n注意: 参数 %1 与图版固定值不同，初值仅为近似。").arg(mismatch.join(", "));
+    QMessageBox::information(this, "图版初值", msg);
+}
 void FittingWidget::on_btnImportModel_clicked() { updateModelCurve(); }
 
 void FittingWidget::on_btnExportData_clicked() {
@@ -550,6 +821,8 @@ void FittingWidget::on_btnChartSettings_clicked() {
 
 void FittingWidget::updateModelCurve() {
     if(!m_modelManager) { QMessageBox::critical(this, "错误", "ModelManager 未初始化！"); return; }
+    // 拟合中曲线由拟合线程按迭代刷新，不在界面线程重算
+    if(m_isFitting) return;
     ui->tableParams->clearFocus();
 
     m_paramChart->updateParamsFromTable();
@@ -566,140 +839,170 @@ void FittingWidget::updateModelCurve() {
     QVector<double> targetT = m_obsTime;
     if(targetT.isEmpty()) { for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e)); }
 
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
-    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+    // 不阻塞界面: 先显示粗算曲线，精算完成后替换 (设置了变产量历史时各阶段按叠加计算)
+    m_curveRunnerParams = currentParams;
+    m_curveRunner.request(m_modelManager->getSolver(type), currentParams, targetT, m_rateSchedule);
 }
 
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
-
-    QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) if(params[i].isFit) fitIndices.append(i);
-    int nParams = fitIndices.size();
-    if(nParams == 0) { QMetaObject::invokeMethod(this, "onFitFinished"); return; }
-
-    double lambda = 0.01; int maxIter = 50; double currentSSE = 1e15;
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
-
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
-    currentSSE = calculateSumSquaredError(residuals);
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
-
-    for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
-
-        emit sigProgress(iter * 100 / maxIter);
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
-        int nRes = residuals.size();
+void FittingWidget::onCurveStageReady(int stage, bool isFinal, const ModelCurveData& curve, qint64 elapsedMs, double floatErrorBound) {
+    Q_UNUSED(stage); Q_UNUSED(isFinal); Q_UNUSED(elapsedMs); Q_UNUSED(floatErrorBound);
+    if(m_isFitting) return;
+    onIterationUpdate(0, m_curveRunnerParams, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+}
 
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                g[i] += J[k][i] * residuals[k];
-                for(int j=0; j<=i; ++j) H[i][j] += J[k][i] * J[k][j];
-            }
-        }
-        for(int i=0; i<nParams; ++i) for(int j=i+1; j<nParams; ++j) H[i][j] = H[j][i];
-
-        bool stepAccepted = false;
-        for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            QVector<double> negG(nParams); for(int i=0;i<nParams;++i) negG[i] = -g[i];
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-
-            QMap<QString, double> trialMap = currentParamMap;
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
-                if(isLog) {
-                    double logVal = log10(oldVal) + delta[i];
-                    newVal = pow(10.0, logVal);
-                } else {
-                    newVal = oldVal + delta[i];
-                }
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
-            }
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9) trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
-            double newSSE = calculateSumSquaredError(newRes);
-            if(newSSE < currentSSE) {
-                currentSSE = newSSE; currentParamMap = trialMap; residuals = newRes; lambda /= 10.0; stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
-                break;
-            } else { lambda *= 10.0; }
-        }
-        if(!stepAccepted && lambda > 1e10) break;
+void FittingWidget::runOptimizationTask(const FitSession& session) {
+    FitScheduler::Session registration;
+    m_fitSummary.clear();
+    m_multiStartRuns.clear();
+    const FitSettings& settings = session.settings;
+
+    QVector<FittingCore::Bound> bounds;
+    QMap<QString, double> startParams;
+    for(const auto& p : session.params) {
+        startParams.insert(p.name, p.value);
+        if(p.isFit) bounds.append({ p.name, p.min, p.max });
+    }
+    if(bounds.isEmpty()) { QMetaObject::invokeMethod(this, "onFitFinished"); return; }
+
+    // 模型函数在工作线程中并发调用: 引擎副本、时间序列与产量历史按值捕获
+    // 拟合用低精度，只设置本会话的引擎副本，不影响模型管理器与其他页签
+    // 引擎副本共享取消标志: 停止时正在进行的计算 (含雅可比与种群的并发任务) 立即返回，拟合返回此前最好的参数
+    const QVector<double>& obsTime = session.time;
+    const RateSchedule& schedule = session.schedule;
+    ModelSolver01_06 solver = session.solver;
+    solver.setHighPrecision(false);
+    solver.setCancelFlag(&m_stopRequested);
+    FittingCore::ModelFunction model = [solver, schedule, obsTime](const QMap<QString, double>& p) {
+        if(schedule.isEmpty()) return solver.calculateTheoreticalCurve(p, obsTime);
+        return RateSuperposition(schedule).calculate(solver, p, obsTime);
+    };
+
+    // 显示曲线直接取残差计算时的曲线 (观测时间上)，刷新限制在 30 帧/秒，最终结果另行发出
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+    qint64 lastFrameMs = -1;
+    const qint64 frameIntervalMs = 1000 / 30;
+    auto display = [this, &frameTimer, &lastFrameMs, frameIntervalMs](double mse, const QMap<QString, double>& p, const ModelCurveData& curve) {
+        qint64 now = frameTimer.elapsed();
+        if(lastFrameMs >= 0 && now - lastFrameMs < frameIntervalMs) return;
+        lastFrameMs = now;
+        emit sigIterationUpdated(mse, p, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    };
+
+    // 无变产量叠加时雅可比由前向自动微分解析计算 (与模型函数同一低精度设置)，不支持时拟合核心自动退回差分
+    FittingCore::SensitivityFunction sensitivity;
+    if(schedule.isEmpty()) {
+        sensitivity = [solver](const QMap<QString, double>& p, const QStringList& names, const QVector<double>& t,
+                               QVector<double>& pressure, QVector<QVector<double>>& dp) {
+            return solver.calculatePressureSensitivities(p, names, t, pressure, dp);
+        };
     }
 
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
-    QMetaObject::invokeMethod(this, "onFitFinished");
-}
-
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
-    if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
-    const QVector<double>& pCal = std::get<1>(res); const QVector<double>& dpCal = std::get<2>(res);
-    QVector<double> r; double wp = weight; double wd = 1.0 - weight;
-    int count = qMin(m_obsPressure.size(), pCal.size());
-    for(int i=0; i<count; ++i) {
-        if(m_obsPressure[i] > 1e-10 && pCal[i] > 1e-10) r.append( (log(m_obsPressure[i]) - log(pCal[i])) * wp ); else r.append(0.0);
-    }
-    int dCount = qMin(m_obsDerivative.size(), dpCal.size()); dCount = qMin(dCount, count);
-    for(int i=0; i<dCount; ++i) {
-        if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10) r.append( (log(m_obsDerivative[i]) - log(dpCal[i])) * wd ); else r.append(0.0);
-    }
-    return r;
-}
-
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
-    int nRes = baseResiduals.size(); int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
-    for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j]; QString pName = currentFitParams[idx].name;
-        double val = params.value(pName); bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
-        double h; QMap<QString, double> pPlus = params; QMap<QString, double> pMinus = params;
-        if(isLog) { h = 0.01; double valLog = log10(val); pPlus[pName] = pow(10.0, valLog + h); pMinus[pName] = pow(10.0, valLog - h); }
-        else { h = 1e-4; pPlus[pName] = val + h; pMinus[pName] = val - h; }
-        auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
-        if(rPlus.size() == nRes && rMinus.size() == nRes) {
-            for(int i=0; i<nRes; ++i) J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
-        }
+    // 接受步之间用 Broyden 修正代替完整差分，雅可比失准时自动重新差分
+    FittingCore::Options options;
+    options.broydenUpdates = true;
+    double weight = settings.weight;
+    int startCount = settings.startCount;
+    QMap<QString, double> fitted;
+    double fittedMse = 0.0;
+    ModelCurveData fittedCurve;
+    bool fittedCurveFinal = false;   // fittedCurve 是否已是引擎原有精度在观测时间上的结果
+    if(settings.globalSearch) {
+        // 差分进化: 预算的前一半用预览档 (单精度内核、宽容差) 的廉价模型
+        ProgressiveCurveRunner::Stage tier = ProgressiveCurveRunner::defaultPreviewStages().first();
+        ModelSolver01_06 cheap = solver;
+        cheap.setHighPrecision(tier.highPrecision);
+        cheap.setQuadrature(tier.quadTolerance, tier.quadMaxDepth);
+        cheap.setSinglePrecisionKernel(tier.singlePrecisionKernel);
+        FittingCore::ModelFunction coarseModel = [cheap, schedule, obsTime](const QMap<QString, double>& p) {
+            if(schedule.isEmpty()) return cheap.calculateTheoreticalCurve(p, obsTime);
+            return RateSuperposition(schedule).calculate(cheap, p, obsTime);
+        };
+
+        FittingEvolution::Options evoOptions;
+        evoOptions.maxEvaluations = settings.evaluationBudget;
+        evoOptions.polish = settings.polish;
+        evoOptions.targetMse = options.targetMse;
+        evoOptions.seed = QRandomGenerator::global()->generate();
+        FittingEvolution::Callbacks callbacks;
+        callbacks.stopRequested = [this]() { return m_stopRequested.load(); };
+        callbacks.progress = [this](qint64 evaluations, qint64 budget) { emit sigProgress(int(evaluations * 100 / budget)); };
+        callbacks.improved = display;
+        FittingEvolution evolution(session.observations, bounds, weight, evoOptions, options);
+        evolution.setSensitivityFunction(sensitivity);
+        FittingEvolution::Result result = evolution.run(model, coarseModel, startParams, callbacks);
+        fitted = result.params;
+        fittedMse = result.mse;
+        fittedCurve = result.curve;
+        m_fitSummary = result.summary();
+    } else if(startCount > 1) {
+        // 多起点: 拉丁超立方起点并发拟合，界面显示目前最好的一组
+        FittingMultiStart::Callbacks callbacks;
+        callbacks.stopRequested = [this]() { return m_stopRequested.load(); };
+        callbacks.progress = [this](int finished, int total) { emit sigProgress(finished * 100 / total); };
+        callbacks.improved = display;
+        FittingMultiStart multiStart(session.observations, bounds, weight, options);
+        multiStart.setSensitivityFunction(sensitivity);
+        QVector<QMap<QString, double>> starts = FittingMultiStart::startingPoints(startParams, bounds, startCount, QRandomGenerator::global()->generate());
+        m_multiStartRuns = multiStart.run(model, starts, callbacks);
+        const FittingCore::Result& result = m_multiStartRuns.first().result;
+        fitted = result.params;
+        fittedMse = result.mse;
+        fittedCurve = result.curve;
+        m_fitSummary = QString("%1 个起点，最优为起点 %2: ").arg(startCount).arg(m_multiStartRuns.first().index + 1) + result.summary();
+    } else {
+        // 多精度日程: 先在抽稀数据、N=4、宽松积分容差上迭代，停滞后逐级提高，最终阶段为完整数据 + 引擎原有精度
+        FittingCore::Callbacks callbacks;
+        callbacks.stopRequested = [this]() { return m_stopRequested.load(); };
+        callbacks.progress = [this](int iter, int maxIter) { emit sigProgress(iter * 100 / maxIter); };
+        callbacks.accepted = display;
+        ModelSolver01_06 finalSolver = session.solver;
+        finalSolver.setCancelFlag(&m_stopRequested);
+        FittingSchedule fitSchedule(obsTime, session.pressure, session.derivative, bounds, weight, options);
+        FittingSchedule::Result result = fitSchedule.run(finalSolver, scheduleModelFactory(schedule), scheduleSensitivityFactory(schedule),
+                                                         startParams, callbacks);
+        fitted = result.finalResult.params;
+        fittedMse = result.finalResult.mse;
+        fittedCurve = result.finalResult.curve;
+        fittedCurveFinal = !result.stages.isEmpty() && result.stages.last().isFinal;
+        m_fitSummary = result.summary();
     }
-    return J;
-}
 
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size(); if (n == 0) return QVector<double>();
-    Eigen::MatrixXd matA(n, n); Eigen::VectorXd vecB(n);
-    for (int i = 0; i < n; ++i) { vecB(i) = b[i]; for (int j = 0; j < n; ++j) matA(i, j) = A[i][j]; }
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
-    QVector<double> res(n); for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
+    // 多精度日程的最终阶段已在观测时间上以原有精度算出曲线，直接显示；多起点与差分进化的拟合过程为低精度，
+    // 结果曲线 (默认时间序列) 以高精度计算一次；停止时不再计算，直接显示停止前最好的曲线
+    if(m_stopRequested || fittedCurveFinal) {
+        if(m_stopRequested) m_fitSummary = "已停止。" + m_fitSummary;
+        if(!std::get<1>(fittedCurve).isEmpty())
+            emit sigIterationUpdated(fittedMse, fitted, std::get<0>(fittedCurve), std::get<1>(fittedCurve), std::get<2>(fittedCurve));
+    } else {
+        ModelSolver01_06 finalSolver = session.solver;
+        finalSolver.setHighPrecision(true);
+        ModelCurveData finalCurve = schedule.isEmpty() ? finalSolver.calculateTheoreticalCurve(fitted)
+                                                       : RateSuperposition(schedule).calculate(finalSolver, fitted, obsTime);
+        emit sigIterationUpdated(fittedMse, fitted, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
+    }
+    QMetaObject::invokeMethod(this, "onFitFinished");
 }
 
-double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
-    double sse = 0.0; for(double v : residuals) sse += v*v; return sse;
+void FittingWidget::runModelComparisonTask(const FitSession& session, const QVector<FittingModelComparison::Candidate>& candidates) {
+    FitScheduler::Session registration;
+    m_fitSummary.clear();
+
+    // 各候选与单起点拟合相同: 多精度日程 + Broyden 修正 + 解析雅可比 (定产量时)
+    FittingCore::Options options;
+    options.broydenUpdates = true;
+    FittingModelComparison::Callbacks callbacks;
+    callbacks.stopRequested = [this]() { return m_stopRequested.load(); };
+    callbacks.progress = [this](int finished, int total) { emit sigProgress(finished * 100 / total); };
+
+    QElapsedTimer timer;
+    timer.start();
+    FittingModelComparison comparison(session.time, session.pressure, session.derivative, session.settings.weight, options);
+    m_modelRanking = comparison.run(candidates, scheduleModelFactory(session.schedule), scheduleSensitivityFactory(session.schedule), callbacks);
+    m_fitSummary = QString("%1 个候选模型，有效残差 %2 个，耗时 %3 s")
+                       .arg(candidates.size()).arg(comparison.residualCount()).arg(timer.elapsed() / 1000.0, 0, 'f', 1);
+    if(m_stopRequested) m_fitSummary = "已停止。" + m_fitSummary;
+    QMetaObject::invokeMethod(this, "onModelComparisonFinished");
 }
 
 void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
@@ -719,7 +1022,141 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
     plotCurves(t, p_curve, d_curve, true);
 }
 
-void FittingWidget::onFitFinished() { m_isFitting = false; ui->btnRunFit->setEnabled(true); QMessageBox::information(this, "完成", "拟合完成。"); }
+void FittingWidget::onFitFinished() {
+    setFittingState(false);
+    showMultiStartResults();
+    QMessageBox::information(this, "完成", "拟合完成。\n" + m_fitSummary);
+}
+
+void FittingWidget::showMultiStartResults() {
+    QTableWidget* table = ui->tableStarts;
+    table->clear();
+    table->setVisible(!m_multiStartRuns.isEmpty());
+    if(m_multiStartRuns.isEmpty()) { table->setRowCount(0); return; }
+
+    // 列: 排名、起点序号、MSE、迭代次数、各拟合参数的结果
+    QStringList names;
+    for(const FitParameter& p : m_paramChart->getParameters()) if(p.isFit) names << p.name;
+    QStringList headers = { "排名", "起点", "MSE", "迭代" };
+    headers << names;
+    table->setColumnCount(headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->setRowCount(m_multiStartRuns.size());
+    for(int i = 0; i < m_multiStartRuns.size(); ++i) {
+        const FittingMultiStart::Run& run = m_multiStartRuns[i];
+        QStringList cells = { QString::number(i + 1), QString::number(run.index + 1),
+                              QString::number(run.result.mse, 'e', 3), QString::number(run.result.iterations) };
+        for(const QString& n : names) cells << QString::number(run.result.params.value(n), 'g', 5);
+        for(int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells[c]);
+            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+            table->setItem(i, c, item);
+        }
+    }
+    table->resizeColumnsToContents();
+}
+
+void FittingWidget::onStartResultActivated(int row, int column) {
+    Q_UNUSED(column);
+    if(m_isFitting || row < 0 || row >= m_multiStartRuns.size()) return;
+    // 采用该起点的拟合结果作为当前参数
+    const QMap<QString, double>& fitted = m_multiStartRuns[row].result.params;
+    QList<FitParameter> params = m_paramChart->getParameters();
+    for(FitParameter& p : params) if(fitted.contains(p.name)) p.value = fitted.value(p.name);
+    m_paramChart->setParameters(params);
+    updateModelCurve();
+}
+
+void FittingWidget::onModelComparisonFinished() {
+    setFittingState(false);
+    showModelRanking();
+    QString text = "模型判别完成。\n" + m_fitSummary;
+    if(!m_modelRanking.isEmpty() && std::isfinite(m_modelRanking.first().aic))
+        text += "\nAIC 最优: " + ModelManager::getModelTypeName(m_modelCandidates[m_modelRanking.first().candidate].type);
+    QMessageBox::information(this, "完成", text);
+}
+
+void FittingWidget::showModelRanking() {
+    QTableWidget* table = ui->tableModels;
+    table->clear();
+    table->setVisible(!m_modelRanking.isEmpty());
+    if(m_modelRanking.isEmpty()) { table->setRowCount(0); return; }
+
+    // 列: 排名、模型、拟合参数数、SSE、AIC、BIC (相对最优的差值便于判断差异是否显著)
+    double bestAic = m_modelRanking.first().aic;
+    double bestBic = std::numeric_limits<double>::infinity();
+    for(const auto& r : m_modelRanking) bestBic = qMin(bestBic, r.bic);
+    QStringList headers = { "排名", "模型", "参数数", "SSE", "AIC", "ΔAIC", "BIC", "ΔBIC" };
+    table->setColumnCount(headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->setRowCount(m_modelRanking.size());
+    auto number = [](double v, char format, int precision) { return std::isfinite(v) ? QString::number(v, format, precision) : QString("-"); };
+    for(int i = 0; i < m_modelRanking.size(); ++i) {
+        const FittingModelComparison::Ranked& r = m_modelRanking[i];
+        QStringList cells = { QString::number(i + 1), ModelManager::getModelTypeName(m_modelCandidates[r.candidate].type),
+                              QString::number(r.parameterCount), number(r.sse, 'e', 3),
+                              number(r.aic, 'f', 1), number(r.aic - bestAic, 'f', 1), number(r.bic, 'f', 1), number(r.bic - bestBic, 'f', 1) };
+        for(int c = 0; c < cells.size(); ++c) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells[c]);
+            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+            table->setItem(i, c, item);
+        }
+    }
+    table->resizeColumnsToContents();
+
+    // 叠加排名前三的模型曲线 (观测时间上的最终精度曲线，即计算 SSE 所用的曲线)
+    clearModelOverlays();
+    const QColor colors[] = { QColor(230, 120, 0), QColor(128, 0, 160), QColor(0, 140, 140) };
+    for(int i = 0; i < qMin(3, int(m_modelRanking.size())); ++i) {
+        const FittingModelComparison::Ranked& r = m_modelRanking[i];
+        if(!std::isfinite(r.aic)) break;
+        const ModelCurveData& curve = r.fit.finalResult.curve;
+        const QVector<double>& t = std::get<0>(curve);
+        const QVector<double>& p = std::get<1>(curve);
+        const QVector<double>& d = std::get<2>(curve);
+        QVector<double> vt, vp, dt, vd;
+        for(int k = 0; k < qMin(t.size(), p.size()); ++k) {
+            if(t[k] <= 1e-8) continue;
+            if(p[k] > 1e-8) { vt << t[k]; vp << p[k]; }
+            if(k < d.size() && d[k] > 1e-8) { dt << t[k]; vd << d[k]; }
+        }
+        QString name = QString("#%1 模型%2").arg(i + 1).arg(int(m_modelCandidates[r.candidate].type) + 1);
+        QCPGraph* gp = m_plot->addGraph();
+        gp->setPen(QPen(colors[i], 1.5, Qt::DashLine));
+        gp->setName(name + " 压力");
+        gp->setData(vt, vp);
+        QCPGraph* gd = m_plot->addGraph();
+        gd->setPen(QPen(colors[i], 1.5, Qt::DotLine));
+        gd->setName(name + " 导数");
+        gd->setData(dt, vd);
+        m_modelOverlays << gp << gd;
+    }
+    m_plot->replot();
+}
+
+void FittingWidget::clearModelOverlays() {
+    if(m_modelOverlays.isEmpty()) return;
+    for(QCPGraph* g : m_modelOverlays) m_plot->removeGraph(g);
+    m_modelOverlays.clear();
+    m_plot->replot();
+}
+
+void FittingWidget::onModelResultActivated(int row, int column) {
+    Q_UNUSED(column);
+    if(m_isFitting || row < 0 || row >= m_modelRanking.size()) return;
+    const FittingModelComparison::Ranked& r = m_modelRanking[row];
+    if(!std::isfinite(r.aic)) return;
+    // 切换到该模型并采用其拟合结果 (参数表含候选模型自己的拟合标记)
+    const ModelCandidate& mc = m_modelCandidates[r.candidate];
+    QList<FitParameter> params = mc.params;
+    const QMap<QString, double>& fitted = r.fit.finalResult.params;
+    for(FitParameter& p : params) if(fitted.contains(p.name)) p.value = fitted.value(p.name);
+    clearModelOverlays();
+    m_paramChart->setParameters(params);
+    m_currentModelType = mc.type;
+    ui->btn_modelSelect->setText("当前: " + ModelManager::getModelTypeName(mc.type));
+    updateModelCurve();
+}
 
 void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
     QVector<double> vt, vp, vd;
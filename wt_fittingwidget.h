@@ -16,6 +16,7 @@
 #include <QVector>
 #include <QFutureWatcher>
 #include <QJsonObject>
+#include <atomic>
 #include "modelmanager.h"
 #include "mousezoom.h"
 #include "chartsetting1.h"
@@ -24,6 +25,16 @@
 #include "fittingparameterchart.h"
 #include "fittingobserveddata.h"
 #include "paramselectdialog.h"
+#include "typecurvelibrary.h"
+#include "progressivecurverunner.h"
+#include "superposition.h"
+#include "fittingcore.h"
+#include "fittingmultistart.h"
+#include "fittingevolution.h"
+#include "fittingschedule.h"
+#include "fittingmodelcomparison.h"
+#include "datareduction.h"
+#include "fitscheduler.h"
 
 namespace Ui { class FittingWidget; }
 
@@ -41,6 +52,21 @@ public:
     // 设置观测数据（时间、压力、导数）
     void setObservedData(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
 
+    // 设置变产量历史: 非空时理论曲线按产量阶跃叠加计算 (观测时间与产量段起始时间同一时间轴)，为空时按定产量 q 计算
+    // 拟合进行中或产量历史无效时不修改，返回 false
+    bool setRateHistory(const RateSchedule& schedule);
+
+    // 设置测试产量 q (参数表中的 "q")，用于反褶积响应等按给定产量折算的观测数据
+    void setReferenceRate(double q);
+
+    // 设置反褶积响应为观测数据: 清除变产量历史，q 设为响应对应的恒定产量，并标记本页数据为反褶积结果
+    // 拟合进行中时不修改，返回 false
+    bool setDeconvolvedData(const QVector<double>& t, const QVector<double>& dp, const QVector<double>& d, double referenceRate);
+    // 观测数据是否为反褶积响应 (setObservedData 清除该标记)
+    bool hasDeconvolvedData() const;
+    // 原始数据变更后清除标记，下次切换到拟合界面时重新传入原始数据
+    void clearDeconvolvedMark();
+
     // 基础参数更新接口（供外部调用）
     void updateBasicParameters();
 
@@ -50,13 +76,18 @@ public:
     // 获取当前拟合状态的 JSON 对象（用于保存到项目文件）
     QJsonObject getJsonState() const;
 
+    // 是否正在自动拟合
+    bool isFitting() const;
+
 signals:
     // 拟合完成信号
     void fittingCompleted(ModelManager::ModelType modelType, const QMap<QString, double>& parameters);
     // 迭代更新信号（用于刷新曲线和误差显示）
     void sigIterationUpdated(double error, QMap<QString, double> currentParams, QVector<double> t, QVector<double> p, QVector<double> d);
-    // 进度信号
+    // 进度信号 (拟合线程发出)
     void sigProgress(int progress);
+    // 自动拟合开始 (true) / 结束 (false)，供拟合页显示各页签的状态
+    void sigFittingStateChanged(bool running);
     // 请求保存信号
     void sigRequestSave();
 
@@ -73,6 +104,8 @@ private slots:
     void on_btnChartSettings_clicked(); // 图表设置
     void on_btn_modelSelect_clicked();  // 选择模型
     void on_btnSelectParams_clicked();  // 打开参数选择对话框
+    void on_btnAtlasGuess_clicked();    // 从类型曲线图版获取初值
+    void on_btnFitAllModels_clicked();  // 并发拟合全部候选模型并排序
 
     void on_btnSaveFit_clicked();       // 保存结果
     void on_btnExportReport_clicked();  // 导出报告
@@ -80,7 +113,13 @@ private slots:
     // 内部逻辑槽函数
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
     void onFitFinished();
+    void onModelComparisonFinished();
     void onSliderWeightChanged(int value); // 权重滑块改变
+    void onCurveStageReady(int stage, bool isFinal, const ModelCurveData& curve, qint64 elapsedMs, double floatErrorBound); // 渐进式刷新曲线
+    void onStartResultActivated(int row, int column); // 双击多起点结果，采用该组参数
+    void onModelResultActivated(int row, int column); // 双击候选模型结果，切换到该模型并采用其参数
+    void onOptimizerChanged(int index);               // 切换拟合算法 (0: LM，1: 差分进化)
+    void onReductionChanged();                        // 对数抽稀设置改变，重新生成拟合数据
 
 private:
     Ui::FittingWidget *ui;
@@ -93,15 +132,46 @@ private:
     FittingParameterChart* m_paramChart; // 负责参数数据与表格的管理
     FittingObservedData* m_dataLoader;   // 负责数据文件的加载与解析
 
-    // 本地缓存的观测数据
+    // 原始观测数据 (保存到项目文件)
+    QVector<double> m_rawTime;
+    QVector<double> m_rawPressure;
+    QVector<double> m_rawDerivative;
+    // 拟合用的观测数据 (原始数据经对数抽稀，未启用抽稀时与原始数据相同)
     QVector<double> m_obsTime;
     QVector<double> m_obsPressure;
     QVector<double> m_obsDerivative;
+    DataReduction::Settings m_reduction;
+    // 拟合用的预处理观测数据 (ln p、ln dp 与有效掩码)，随观测数据更新
+    FittingCore::Observations m_fitObservations;
+
+    // 变产量历史 (为空表示定产量)
+    RateSchedule m_rateSchedule;
+    // 观测数据为反褶积响应
+    bool m_dataDeconvolved;
 
     // 拟合控制标志
     bool m_isFitting;
-    bool m_stopRequested;
+    std::atomic<bool> m_stopRequested;   // 同时作为拟合所用引擎副本的取消标志
     QFutureWatcher<void> m_watcher;
+    QFuture<void> m_fitFuture;
+    QString m_fitSummary;   // 最近一次拟合的迭代统计 (拟合线程写入，完成后在界面线程读取)
+    QVector<FittingMultiStart::Run> m_multiStartRuns;   // 最近一次多起点拟合的结果 (按 MSE 升序)，同上
+
+    // 模型判别: 候选模型的参数表 (界面线程生成) 与最近一次的排序结果 (按 AIC 升序，拟合线程写入)
+    struct ModelCandidate {
+        ModelManager::ModelType type;
+        QList<FitParameter> params;
+    };
+    QVector<ModelCandidate> m_modelCandidates;
+    QVector<FittingModelComparison::Ranked> m_modelRanking;
+    QList<QCPGraph*> m_modelOverlays;   // 排名靠前的候选模型曲线 (虚线)
+
+    // 类型曲线图版 (用于快速获取拟合初值)
+    TypeCurveLibrary m_typeCurveLibrary;
+
+    // 刷新理论曲线 (先粗算后精算)
+    ProgressiveCurveRunner m_curveRunner;
+    QMap<QString, double> m_curveRunnerParams;
 
     // 初始化绘图控件配置
     void setupPlot();
@@ -109,19 +179,45 @@ private:
     void initializeDefaultModel();
     // 根据当前参数更新理论曲线
     void updateModelCurve();
-
-    // 优化算法相关函数 (Levenberg-Marquardt)
-    void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
-    void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
-
-    // 计算残差
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
-    // 计算雅可比矩阵
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
-    // 求解线性方程组 (Eigen)
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
-    // 计算平方误差和
-    double calculateSumSquaredError(const QVector<double>& residuals);
+    // 由原始数据按抽稀设置生成拟合数据，并刷新实测曲线
+    void applyDataReduction();
+
+    // 自动拟合的设置 (界面线程读取后交给拟合线程)
+    struct FitSettings {
+        double weight;          // 压力权重
+        int startCount;         // LM 起点数，> 1 时为多起点拟合
+        bool globalSearch;      // 差分进化全局搜索 (忽略 startCount)
+        int evaluationBudget;   // 差分进化的模型计算预算
+        bool polish;            // 差分进化结束后是否 LM 精修
+    };
+
+    // 一次自动拟合的会话快照: 拟合线程只读取此快照，与界面、模型管理器及其他页签互不影响
+    struct FitSession {
+        QList<FitParameter> params;
+        FitSettings settings;
+        ModelSolver01_06 solver;                 // 引擎副本 (精度设置由会话自行调整)
+        RateSchedule schedule;
+        QVector<double> time;                    // 拟合数据 (抽稀后)
+        QVector<double> pressure;
+        QVector<double> derivative;
+        FittingCore::Observations observations;
+    };
+
+    // 拟合开始/结束时锁定或恢复拟合相关控件，并通知拟合页
+    void setFittingState(bool running);
+    // 多精度日程各阶段的模型函数与灵敏度函数 (设置了变产量历史时做叠加，此时不使用解析雅可比)
+    static FittingSchedule::ModelFactory scheduleModelFactory(const RateSchedule& schedule);
+    static FittingSchedule::SensitivityFactory scheduleSensitivityFactory(const RateSchedule& schedule);
+
+    // 优化算法 (Levenberg-Marquardt / 多起点 LM / 差分进化)，在拟合线程中执行
+    void runOptimizationTask(const FitSession& session);
+    // 并发拟合全部候选模型并按 AIC 排序，在拟合线程中执行
+    void runModelComparisonTask(const FitSession& session, const QVector<FittingModelComparison::Candidate>& candidates);
+    // 在结果表中列出多起点拟合的各个结果
+    void showMultiStartResults();
+    // 在结果表中列出候选模型的排序，并在图中叠加排名前三的模型曲线
+    void showModelRanking();
+    void clearModelOverlays();
 
     // 获取图表 Base64 字符串用于报告
     QString getPlotImageBase64();
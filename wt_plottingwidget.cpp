@@ -206,6 +206,7 @@ void WT_PlottingWidget::on_btn_PressureRate_clicked()
         PlottingStackWidget* w = new PlottingStackWidget();
         w->setProjectPath(m_projectPath);
         w->setWindowTitle("压力产量分析 - " + dlg.getPressureName());
+        connect(w, &PlottingStackWidget::rateHistoryForFitting, this, &WT_PlottingWidget::rateHistoryForFitting);
 
         // 传递数据和样式配置给新窗口
         w->setData(pressX, pressY, prodX, prodY,
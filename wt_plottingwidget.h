@@ -16,6 +16,7 @@
 #include <QListWidgetItem>
 #include "mousezoom.h"
 #include "pressurederivativecalculator.h"
+#include "superposition.h"
 
 namespace Ui {
 class WT_PlottingWidget;
@@ -53,6 +54,10 @@ public:
     void setDataModel(QStandardItemModel* model);
     void setProjectPath(const QString& path);
 
+signals:
+    // 压力产量分析窗口请求将产量历史用于拟合
+    void rateHistoryForFitting(const RateSchedule& schedule);
+
 private slots:
     // 左侧功能按钮
     void on_btn_NewCurve_clicked();